@@ -25,15 +25,35 @@
 
 #include "environment_build.hpp"
 
+#include "mega/values/native_types.hpp"
+
+#include <chrono>
+
 namespace mega::io
 {
 class StashEnvironment : public BuildEnvironment
 {
-    mega::pipeline::Stash& m_stash;
+public:
+    // stage file reads made through this environment and so by the one task using it
+    struct StageReadStatistics
+    {
+        U64                                 uiHits = 0U, uiMisses = 0U;
+        std::chrono::steady_clock::duration readTime{};
+    };
+
+private:
+    mega::pipeline::Stash&      m_stash;
+    mutable StageReadStatistics m_stageReadStatistics;
 
 public:
     StashEnvironment( mega::pipeline::Stash& stash, const Directories& directories );
 
+    // stage files are served from the process wide StageFileCache
+    using BuildEnvironment::read;
+    virtual std::unique_ptr< std::istream > read( const BuildFilePath& filePath ) const;
+
+    const StageReadStatistics& getStageReadStatistics() const { return m_stageReadStatistics; }
+
     template < typename TFilePathType >
     task::FileHash getBuildHashCode( const TFilePathType& filePath ) const
     {
@@ -0,0 +1,99 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_stage_file_cache
+#define GUARD_2026_October_18_stage_file_cache
+
+#include "mega/values/native_types.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#include <istream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace mega::io
+{
+
+// Read only cache of stage file contents shared by every task an executor process runs.
+// Entries are keyed by file path and a version string, normally the build hash code, so a rewritten
+// stage file is never served stale and the least recently used entries are evicted once the cached
+// bytes exceed the capacity.
+class StageFileCache
+{
+public:
+    using Buffer = std::shared_ptr< const std::string >;
+
+    static constexpr U64 DEFAULT_CAPACITY_BYTES = 512ULL * 1024ULL * 1024ULL;
+
+    struct Statistics
+    {
+        U64 uiHits = 0U, uiMisses = 0U, uiEvictions = 0U, uiBytes = 0U, uiEntries = 0U;
+    };
+
+    explicit StageFileCache( U64 uiCapacityBytes );
+
+    StageFileCache( const StageFileCache& )            = delete;
+    StageFileCache& operator=( const StageFileCache& ) = delete;
+
+    // cache for the process with the default capacity
+    static StageFileCache& get();
+
+    // returns null on a miss
+    Buffer find( const boost::filesystem::path& filePath, const std::string& strVersion );
+
+    // caches the contents unless they alone exceed the capacity and returns the cached buffer
+    // which may be one inserted concurrently by another task for the same key
+    Buffer insert( const boost::filesystem::path& filePath, const std::string& strVersion, Buffer pBuffer );
+
+    static Buffer                          load( const boost::filesystem::path& filePath );
+    static std::unique_ptr< std::istream > makeStream( Buffer pBuffer );
+
+    U64        getCapacity() const { return m_uiCapacityBytes; }
+    Statistics getStatistics() const;
+    void       clear();
+
+private:
+    using Key = std::pair< std::string, std::string >;
+    using LRU = std::list< Key >;
+    struct Entry
+    {
+        Buffer        pBuffer;
+        LRU::iterator iterLRU;
+    };
+    using EntryMap = std::map< Key, Entry >;
+
+    void evict();
+
+    const U64          m_uiCapacityBytes;
+    mutable std::mutex m_mutex;
+    EntryMap           m_entries;
+    // most recently used at the front
+    LRU        m_lru;
+    Statistics m_statistics;
+};
+
+} // namespace mega::io
+
+#endif // GUARD_2026_October_18_stage_file_cache
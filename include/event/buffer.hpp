@@ -27,7 +27,11 @@
 
 #include "mega/values/runtime/timestamp.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <vector>
 #include <cstring>
 
@@ -46,10 +50,13 @@ public:
 
     Buffer( BufferFactory& bufferFactory, TrackID trackID, BufferIndex fileIndex )
         : BufferImplType( bufferFactory, trackID, fileIndex )
+        , m_bufferIndex( fileIndex )
         , m_writePosition( 0 )
     {
     }
 
+    inline BufferIndex getBufferIndex() const noexcept { return m_bufferIndex; }
+
     inline const void* read( InterBufferOffset offset ) const noexcept
     {
         return reinterpret_cast< char* >( getAddress() ) + offset.get();
@@ -58,14 +65,41 @@ public:
     inline const void* getStart() const noexcept { return read( 0 ); }
     inline const void* getEnd() const noexcept { return read( LogFileSize ); }
 
-    inline bool fit( U64 size ) const noexcept { return m_writePosition.get() + size <= LogFileSize; }
+    inline bool fit( U64 size ) const noexcept
+    {
+        return m_writePosition.load( std::memory_order_relaxed ) + size <= LogFileSize;
+    }
 
+    // single writer
     inline InterBufferOffset write( const void* pData, U64 size ) noexcept
     {
-        std::memcpy( reinterpret_cast< char* >( getAddress() ) + m_writePosition.get(),
-                     reinterpret_cast< const char* >( pData ), size );
-        m_writePosition = InterBufferOffset{ m_writePosition.get() + size };
-        return m_writePosition;
+        const U64 position = m_writePosition.load( std::memory_order_relaxed );
+        writeAt( position, pData, size );
+        m_writePosition.store( position + size, std::memory_order_relaxed );
+        return InterBufferOffset{ position + size };
+    }
+
+    // concurrent writers - returns the start of the reserved range which may
+    // extend past LogFileSize in which case the buffer is full and the caller must
+    // spill to the next buffer.  The write position is left past the end so
+    // fit fails for every later reservation.
+    inline InterBufferOffset reserve( U64 size ) noexcept
+    {
+        return InterBufferOffset{ m_writePosition.fetch_add( size, std::memory_order_relaxed ) };
+    }
+
+    inline InterBufferOffset writeAt( InterBufferOffset offset, const void* pData, U64 size ) noexcept
+    {
+        ASSERT( offset.get() + size <= LogFileSize );
+        std::memcpy(
+            reinterpret_cast< char* >( getAddress() ) + offset.get(), reinterpret_cast< const char* >( pData ), size );
+        return InterBufferOffset{ offset.get() + size };
+    }
+
+    // the end of all reserved data clamped to the buffer size
+    inline InterBufferOffset getWritePosition() const noexcept
+    {
+        return InterBufferOffset{ std::min( m_writePosition.load( std::memory_order_relaxed ), LogFileSize ) };
     }
 
     template < typename RecordType >
@@ -81,22 +115,62 @@ public:
         }
     }
 
+    // terminate a buffer a concurrent reservation at offset has overflowed
     template < typename RecordType >
-    inline bool isTerminated() const noexcept
+    inline void terminateAt( InterBufferOffset offset ) noexcept
     {
-        static_assert( !RecordType::Variable, "incorrect isTerminated function used" );
-        return !fit( RecordType::size() );
+        if constexpr( RecordType::Variable )
+        {
+            if( offset.get() + sizeof( SizeType ) <= LogFileSize )
+            {
+                static const SizeType nullsize = 0U;
+                writeAt( offset, &nullsize, sizeof( SizeType ) );
+            }
+        }
     }
 
+    // NOTE: termination is determined from the read position since concurrent
+    // writers can leave the write position past the end of the buffer
     template < typename RecordType >
     inline bool isTerminated( InterBufferOffset readPosition ) const noexcept
     {
-        static_assert( RecordType::Variable, "incorrect isTerminated function used" );
-        return !fit( sizeof( SizeType ) ) || ( RecordType::getVariableSize( read( readPosition ) ) == 0U );
+        if constexpr( RecordType::Variable )
+        {
+            return ( readPosition.get() + sizeof( SizeType ) > LogFileSize )
+                   || ( RecordType::getVariableSize( read( readPosition ) ) == 0U );
+        }
+        else
+        {
+            return readPosition.get() + RecordType::size() > LogFileSize;
+        }
     }
 
 private:
-    InterBufferOffset m_writePosition;
+    const BufferIndex     m_bufferIndex;
+    std::atomic< U64 >    m_writePosition;
+};
+
+// Writer interface used by the generated records to write into a range
+// previously reserved within a buffer by a concurrent writer.
+template < class BufferFactory >
+class BufferReservation
+{
+public:
+    inline BufferReservation( Buffer< BufferFactory >& buffer, InterBufferOffset offset )
+        : m_buffer( buffer )
+        , m_position( offset )
+    {
+    }
+
+    inline InterBufferOffset write( const void* pData, U64 size ) noexcept
+    {
+        m_position = m_buffer.writeAt( m_position, pData, size );
+        return m_position;
+    }
+
+private:
+    Buffer< BufferFactory >& m_buffer;
+    InterBufferOffset        m_position;
 };
 
 template < class BufferFactory >
@@ -181,12 +255,85 @@ public:
 template < class BufferFactory >
 class Track : public BufferSequence< BufferFactory >
 {
+    using BufferType = Buffer< BufferFactory >;
+
 public:
     using Ptr = std::unique_ptr< Track >;
     inline Track( BufferFactory& bufferFactory, TrackID trackID )
         : BufferSequence< BufferFactory >( bufferFactory, trackID )
     {
     }
+
+    // Concurrent recording.
+    // Writers reserve space in the active buffer with an atomic fetch-add.  The
+    // writer whose reservation overflows the buffer terminates it and every
+    // overflowing writer attempts the spill to the next BufferIndex.  Only the
+    // spill takes the per-track mutex since it may create the next buffer.
+    template < typename RecordType >
+    inline BufferType* reserve( U64 size, BufferIndex startIndex, InterBufferOffset& offset )
+    {
+        ASSERT( size <= LogFileSize );
+        BufferType* pBuffer = m_pActive.load( std::memory_order_acquire );
+        if( !pBuffer )
+        {
+            pBuffer = spill( nullptr, startIndex );
+        }
+        while( true )
+        {
+            offset = pBuffer->reserve( size );
+            if( offset.get() + size <= LogFileSize )
+            {
+                return pBuffer;
+            }
+            if( offset.get() <= LogFileSize )
+            {
+                pBuffer->template terminateAt< RecordType >( offset );
+            }
+            pBuffer = spill( pBuffer, startIndex );
+        }
+    }
+
+    // end of concurrently recorded data - only valid when there are no writers
+    inline std::optional< Offset > getConcurrentEnd() const
+    {
+        if( const BufferType* pBuffer = m_pActive.load( std::memory_order_acquire ) )
+        {
+            return Offset{ pBuffer->getBufferIndex(), pBuffer->getWritePosition() };
+        }
+        return {};
+    }
+
+    // move the active buffer to the published end - only valid when there are no writers
+    inline void setConcurrentEnd( BufferIndex bufferIndex )
+    {
+        const BufferType* pBuffer = m_pActive.load( std::memory_order_relaxed );
+        if( pBuffer && ( pBuffer->getBufferIndex() < bufferIndex ) )
+        {
+            m_pActive.store( BufferSequence< BufferFactory >::getBuffer( bufferIndex ), std::memory_order_release );
+        }
+    }
+
+    // writer count used by the Storage to determine when a cycle is committed
+    inline std::atomic< U32 >& getWriters() { return m_uiWriters; }
+
+private:
+    inline BufferType* spill( BufferType* pFull, BufferIndex startIndex )
+    {
+        std::lock_guard< std::mutex > lock( m_spillMutex );
+        BufferType*                   pActive = m_pActive.load( std::memory_order_acquire );
+        if( pActive == pFull )
+        {
+            const BufferIndex nextIndex
+                = pFull ? BufferIndex{ pFull->getBufferIndex().get() + 1 } : startIndex;
+            pActive = BufferSequence< BufferFactory >::getBuffer( nextIndex );
+            m_pActive.store( pActive, std::memory_order_release );
+        }
+        return pActive;
+    }
+
+    alignas( 64 ) std::atomic< U32 > m_uiWriters = 0U;
+    std::atomic< BufferType* >       m_pActive   = nullptr;
+    std::mutex                       m_spillMutex;
 };
 
 } // namespace mega::event
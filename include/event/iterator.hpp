@@ -43,17 +43,7 @@ class Iterator
         ASSERT( m_pBuffer );
         const void* pData = m_pBuffer->read( m_position );
 
-        bool bIsTerminated = false;
-        if constexpr( RecordType::Variable )
-        {
-            bIsTerminated = m_pBuffer->template isTerminated< RecordType >( m_position );
-        }
-        else
-        {
-            bIsTerminated = m_pBuffer->template isTerminated< RecordType >();
-        }
-
-        if( bIsTerminated )
+        if( m_pBuffer->template isTerminated< RecordType >( m_position ) )
         {
             // then skip to next file
             BufferIndex fileIndex = m_position;
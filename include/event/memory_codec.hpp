@@ -0,0 +1,294 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_memory_codec
+#define GUARD_2026_October_18_memory_codec
+
+#include "event/records.hxx"
+
+#include "mega/values/native_types.hpp"
+#include "mega/values/runtime/pointer.hpp"
+#include "mega/values/runtime/timestamp.hpp"
+
+#include "common/assert_verify.hpp"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <cstring>
+
+namespace mega::event
+{
+
+// Memory track encoding
+//
+// A Memory record is either written eFull holding the complete value or eDelta
+// holding the XOR of the value against the previous record for the same Ref.
+// The XOR delta of an object that only changes a few fields is mostly zeros so
+// it is stored as a sequence of ( zero run, literal run, literal bytes ) tokens
+// using LEB128 lengths.  eFull records are stored verbatim so readers that only
+// ever see eFull records need no decoder.
+//
+// Every KEY_FRAME_CYCLES cycles the writer starts a key frame in which the first
+// record for each Ref is eFull.  A reader can start decoding at any key frame and
+// can drop everything it holds for earlier values when it reaches one.
+namespace memory_codec
+{
+using Key = runtime::PointerHeap;
+
+static constexpr U32 KEY_FRAME_CYCLES = 64U;
+
+inline bool isKeyFrame( runtime::TimeStamp timestamp )
+{
+    return ( timestamp.getValue() % KEY_FRAME_CYCLES ) == 0U;
+}
+
+// the first key frame at or after the timestamp
+inline runtime::TimeStamp nextKeyFrame( runtime::TimeStamp timestamp )
+{
+    const U32 uiRemainder = timestamp.getValue() % KEY_FRAME_CYCLES;
+    return uiRemainder == 0U ? timestamp
+                             : runtime::TimeStamp{ timestamp.getValue() + ( KEY_FRAME_CYCLES - uiRemainder ) };
+}
+
+struct KeyHash
+{
+    inline U64 operator()( const Key& key ) const noexcept { return Key::Hash{}( key ); }
+};
+
+struct KeyEqual
+{
+    inline bool operator()( const Key& left, const Key& right ) const noexcept
+    {
+        return std::memcmp( &left, &right, sizeof( Key ) ) == 0;
+    }
+};
+
+inline void writeLength( std::string& output, U64 length )
+{
+    while( length >= 0x80U )
+    {
+        output.push_back( static_cast< char >( ( length & 0x7FU ) | 0x80U ) );
+        length >>= 7;
+    }
+    output.push_back( static_cast< char >( length ) );
+}
+
+inline U64 readLength( const char*& pIter, const char* pEnd )
+{
+    U64 length = 0U;
+    for( U32 uiShift = 0U;; uiShift += 7U )
+    {
+        VERIFY_RTE_MSG( pIter != pEnd, "Truncated memory delta" );
+        const U8 byte = static_cast< U8 >( *pIter++ );
+        length |= static_cast< U64 >( byte & 0x7FU ) << uiShift;
+        if( ( byte & 0x80U ) == 0U )
+        {
+            return length;
+        }
+    }
+}
+
+// encode the XOR delta between previous and value - both the same size
+inline void encodeDelta( std::string& output, std::string_view previous, std::string_view value )
+{
+    ASSERT( previous.size() == value.size() );
+    const U64 szSize = value.size();
+    U64       szPos  = 0U;
+    while( szPos != szSize )
+    {
+        const U64 szZeroStart = szPos;
+        while( ( szPos != szSize ) && ( previous[ szPos ] == value[ szPos ] ) )
+        {
+            ++szPos;
+        }
+        // a literal run ends at two consecutive unchanged bytes since a single
+        // unchanged byte costs less as a literal than as a new token
+        const U64 szLiteralStart = szPos;
+        while( ( szPos != szSize )
+               && ( ( previous[ szPos ] != value[ szPos ] )
+                    || ( ( szPos + 1U != szSize ) && ( previous[ szPos + 1U ] != value[ szPos + 1U ] ) ) ) )
+        {
+            ++szPos;
+        }
+        writeLength( output, szLiteralStart - szZeroStart );
+        writeLength( output, szPos - szLiteralStart );
+        for( U64 sz = szLiteralStart; sz != szPos; ++sz )
+        {
+            output.push_back( static_cast< char >( previous[ sz ] ^ value[ sz ] ) );
+        }
+    }
+}
+
+// apply an encoded XOR delta to value in place
+inline void applyDelta( std::string& value, std::string_view delta )
+{
+    const char* pIter = delta.data();
+    const char* pEnd  = pIter + delta.size();
+    U64         szPos = 0U;
+    while( pIter != pEnd )
+    {
+        szPos += readLength( pIter, pEnd );
+        const U64 szLiterals = readLength( pIter, pEnd );
+        VERIFY_RTE_MSG( ( szPos + szLiterals <= value.size() ) && ( szLiterals <= static_cast< U64 >( pEnd - pIter ) ),
+                        "Invalid memory delta" );
+        for( const char* pLiteralEnd = pIter + szLiterals; pIter != pLiteralEnd; ++pIter, ++szPos )
+        {
+            value[ szPos ] ^= *pIter;
+        }
+    }
+}
+} // namespace memory_codec
+
+// Produces Memory records delta encoded against the previous value recorded for
+// the same Ref.  The returned Memory::Write refers to the encoder's buffer so
+// must be recorded before the next call to encode.
+class MemoryEncoder
+{
+public:
+    inline Memory::Write encode( const runtime::PointerHeap& ref, std::string_view value )
+    {
+        m_szRawBytes += value.size();
+
+        auto iFind = m_previous.find( ref );
+        if( iFind == m_previous.end() )
+        {
+            m_previous.insert( { ref, std::string{ value } } );
+            m_szEncodedBytes += value.size();
+            return Memory::Write( ref, Memory::eFull, value );
+        }
+
+        std::string& previous = iFind->second;
+        if( previous.size() == value.size() )
+        {
+            m_buffer.clear();
+            memory_codec::encodeDelta( m_buffer, previous, value );
+            if( m_buffer.size() < value.size() )
+            {
+                previous.assign( value );
+                m_szEncodedBytes += m_buffer.size();
+                return Memory::Write( ref, Memory::eDelta, m_buffer );
+            }
+        }
+        previous.assign( value );
+        m_szEncodedBytes += value.size();
+        return Memory::Write( ref, Memory::eFull, value );
+    }
+
+    // forget all previous values so the next record for every Ref is eFull
+    inline void keyFrame() { m_previous.clear(); }
+
+    inline U64 getRawBytes() const { return m_szRawBytes; }
+    inline U64 getEncodedBytes() const { return m_szEncodedBytes; }
+
+private:
+    using ValueMap = std::unordered_map< memory_codec::Key, std::string, memory_codec::KeyHash, memory_codec::KeyEqual >;
+
+    ValueMap    m_previous;
+    std::string m_buffer;
+    U64         m_szRawBytes     = 0U;
+    U64         m_szEncodedBytes = 0U;
+};
+
+// Reconstructs full values from a Memory track read in record order.
+// push records the delta without decoding it and get applies any pending
+// deltas for the Ref on demand.  The records must remain mapped until the
+// value has been reconstructed.  Call clear on reaching each key frame to
+// bound the state held.  A delta whose Ref has no value, because reading
+// began part way through a key frame, is counted as unresolved and skipped
+// until the Ref is written in full again.
+class MemoryDecoder
+{
+    struct State
+    {
+        std::string                     value;
+        std::vector< std::string_view > pending;
+    };
+
+public:
+    // returns false if the record is an unresolved delta
+    inline bool push( const Memory::Read& record )
+    {
+        switch( record.getEncoding() )
+        {
+            case Memory::eFull:
+            {
+                State& state = m_states[ record.getRef() ];
+                state.value.assign( record.getData() );
+                state.pending.clear();
+                return true;
+            }
+            case Memory::eDelta:
+            {
+                auto iFind = m_states.find( record.getRef() );
+                if( iFind == m_states.end() )
+                {
+                    ++m_uiUnresolved;
+                    return false;
+                }
+                iFind->second.pending.push_back( record.getData() );
+                return true;
+            }
+            default:
+            {
+                THROW_RTE( "Unknown memory record encoding" );
+            }
+        }
+    }
+
+    inline std::string_view get( const runtime::PointerHeap& ref )
+    {
+        auto iFind = m_states.find( ref );
+        VERIFY_RTE_MSG( iFind != m_states.end(), "No memory record for reference" );
+        State& state = iFind->second;
+        for( std::string_view delta : state.pending )
+        {
+            memory_codec::applyDelta( state.value, delta );
+        }
+        state.pending.clear();
+        return state.value;
+    }
+
+    // push the record and return its full value unless it is an unresolved delta
+    inline std::optional< std::string_view > decode( const Memory::Read& record )
+    {
+        if( push( record ) )
+        {
+            return get( record.getRef() );
+        }
+        return std::nullopt;
+    }
+
+    inline void clear() { m_states.clear(); }
+
+    inline U64 size() const { return m_states.size(); }
+    inline U64 getUnresolved() const { return m_uiUnresolved; }
+
+private:
+    using StateMap = std::unordered_map< memory_codec::Key, State, memory_codec::KeyHash, memory_codec::KeyEqual >;
+    StateMap m_states;
+    U64      m_uiUnresolved = 0U;
+};
+
+} // namespace mega::event
+
+#endif // GUARD_2026_October_18_memory_codec
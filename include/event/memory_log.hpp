@@ -61,14 +61,24 @@ public:
     MemoryBufferFactory()
         : m_index( *this )
     {
+        // create first cycle at timestamp 0
+        BufferType* pBuffer = m_index.getBuffer( IndexType::toBufferIndex( m_timestamp ) );
+#ifdef DEBUG
+        const InterBufferOffset offset =
+#endif
+            pBuffer->write( &m_iterator, IndexType::RecordSize );
+        ASSERT( offset.get() == IndexType::RecordSize );
     }
 
     void cycle()
     {
         m_timestamp = runtime::TimeStamp{ m_timestamp.getValue() + 1 };
 
-        BufferType*             pBuffer = m_index.getBuffer( IndexType::toBufferIndex( m_timestamp ) );
-        const InterBufferOffset offset  = pBuffer->write( &m_iterator, IndexType::RecordSize );
+        BufferType* pBuffer = m_index.getBuffer( IndexType::toBufferIndex( m_timestamp ) );
+#ifdef DEBUG
+        const InterBufferOffset offset =
+#endif
+            pBuffer->write( &m_iterator, IndexType::RecordSize );
         ASSERT( offset.get() % IndexType::RecordSize == 0U );
         // this looks wierd but is correct - the timestamp record has identity that matches
         // the record start position within file / Index::RecordSize.
@@ -23,8 +23,11 @@
 
 #include "event/range.hpp"
 #include "event/iterator.hpp"
+#include "event/memory_codec.hpp"
 
 #include <array>
+#include <atomic>
+#include <thread>
 
 namespace mega::event
 {
@@ -72,6 +75,32 @@ private:
         offset = Offset{ bufferIndex, record.template write< BufferType >( *pBuffer ) };
     }
 
+    template < typename RecordType >
+    inline void writeConcurrent( const RecordType& record, TrackID trackID )
+    {
+        TrackType&          track     = getTrack( trackID );
+        std::atomic< U32 >& uiWriters = track.getWriters();
+
+        // register as a writer for the current cycle unless the cycle is being published
+        while( true )
+        {
+            uiWriters.fetch_add( 1U, std::memory_order_seq_cst );
+            if( !m_bPublishing.load( std::memory_order_seq_cst ) )
+                break;
+            uiWriters.fetch_sub( 1U, std::memory_order_release );
+            m_bPublishing.wait( true, std::memory_order_acquire );
+        }
+
+        InterBufferOffset offset;
+        BufferType*       pBuffer = track.template reserve< RecordType >(
+            record.size(), BufferFactory::m_iterator.get( trackID ), offset );
+        BufferReservation< BufferFactory > reservation( *pBuffer, offset );
+        record.template write< BufferReservation< BufferFactory > >( reservation );
+
+        // commit
+        uiWriters.fetch_sub( 1U, std::memory_order_release );
+    }
+
 public:
     template < typename... Args >
     Storage( Args... args )
@@ -91,6 +120,66 @@ public:
         write( record, RecordType::TRACKID );
     }
 
+    // Memory track writer - records the value delta encoded against the previous
+    // value recorded for the same Ref.  Not thread safe.
+    inline void recordMemory( const runtime::PointerHeap& ref, std::string_view value )
+    {
+        record( m_memoryEncoder.encode( ref, value ) );
+    }
+
+    inline const MemoryEncoder& getMemoryEncoder() const { return m_memoryEncoder; }
+
+    // Thread safe recording for use from multiple threads within a cycle.
+    // Records of the same track are written in reservation order and become
+    // visible to readers when the cycle is published.  Do not mix with record()
+    // on the same track within a cycle.
+    template < typename RecordType >
+    inline void recordConcurrent( const RecordType& record )
+    {
+        writeConcurrent( record, RecordType::TRACKID );
+    }
+
+    // Publish the IndexRecord for the current cycle once all concurrent
+    // reservations are committed and then advance the timestamp.
+    void cycle()
+    {
+        // store buffering against writeConcurrent so the store and the loads must all be seq_cst
+        // or a writer that has already seen m_bPublishing false could be missed
+        m_bPublishing.store( true, std::memory_order_seq_cst );
+        for( TrackType& track : m_tracks )
+        {
+            while( track.getWriters().load( std::memory_order_seq_cst ) != 0U )
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        for( auto i = 0; i != toInt( TrackID::TOTAL ); ++i )
+        {
+            const TrackID trackID = TrackID( i );
+            TrackType&    track   = getTrack( trackID );
+            Offset&       offset  = BufferFactory::m_iterator.get( trackID );
+            if( const auto concurrentEnd = track.getConcurrentEnd(); concurrentEnd.has_value() )
+            {
+                if( offset < concurrentEnd.value() )
+                {
+                    offset = concurrentEnd.value();
+                }
+                track.setConcurrentEnd( offset );
+            }
+        }
+
+        BufferFactory::cycle();
+
+        if( memory_codec::isKeyFrame( BufferFactory::m_timestamp ) )
+        {
+            m_memoryEncoder.keyFrame();
+        }
+
+        m_bPublishing.store( false, std::memory_order_release );
+        m_bPublishing.notify_all();
+    }
+
 public:
     // READ interface
     Range getRange( runtime::TimeStamp timestamp ) const
@@ -195,7 +284,9 @@ private:
     }
 
 private:
-    TrackArray m_tracks;
+    TrackArray          m_tracks;
+    std::atomic< bool > m_bPublishing = false;
+    MemoryEncoder       m_memoryEncoder;
 };
 
 } // namespace mega::event
@@ -0,0 +1,424 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_arena_archive
+#define GUARD_2026_October_18_arena_archive
+
+#include "mega/values/runtime/pointer.hpp"
+#include "mega/values/runtime/timestamp.hpp"
+#include "mega/values/native_types.hpp"
+#include "mega/pointer_index.hpp"
+
+#include "common/assert_verify.hpp"
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace mega
+{
+
+// Snapshot archive pair writing into a single contiguous arena.
+//
+// Unlike the boost based SnapshotOArchive there is no streambuf and no per
+// value virtual dispatch.  Bitwise values - arithmetic types, enums and types
+// opted in through arena_archive::Bitwise - are copied with memcpy, vectors,
+// arrays and strings of bitwise values are written with a single memcpy and
+// all other types go through their serialize member.  Pointers, including
+// those inside arrays and vectors, are written as an index into a flat table
+// of Pointers in order of first use so loading is a single array lookup.
+// A trivially copyable struct is NOT copied bitwise unless opted in since it
+// may hold Pointers that would then escape the table.
+//
+// The arena layout is
+//
+//     ArenaArchiveHeader | data | object indices | pointer table
+//
+// and contains no absolute addresses so an ArenaLoadArchive can read it
+// directly from an mmapped file without copying.
+struct ArenaArchiveHeader
+{
+    static constexpr U32 MAGIC   = 0x4D414741; // AGAM
+    static constexpr U32 VERSION = 1U;
+
+    U32 uiMagic;
+    U32 uiVersion;
+    U32 uiTimeStamp;
+    U32 uiReserved;
+    U64 szDataSize;
+    U64 szObjectsOffset;
+    U64 szObjectCount;
+    U64 szTableOffset;
+    U64 szTableSize;
+};
+static_assert( sizeof( ArenaArchiveHeader ) == 56U );
+static_assert( std::is_trivially_copyable_v< runtime::Pointer > );
+
+namespace arena_archive
+{
+template < typename T >
+struct IsVector : std::false_type
+{
+};
+template < typename T, typename A >
+struct IsVector< std::vector< T, A > > : std::true_type
+{
+};
+template < typename T >
+struct IsArray : std::false_type
+{
+};
+template < typename T, std::size_t N >
+struct IsArray< std::array< T, N > > : std::true_type
+{
+};
+template < typename T >
+inline constexpr bool IsPointer = std::is_same_v< std::remove_cv_t< T >, runtime::Pointer >;
+
+// specialise to true for trivially copyable types that hold no Pointers
+template < typename T >
+struct Bitwise : std::false_type
+{
+};
+
+template < typename T >
+inline constexpr bool IsBitwise = std::is_arithmetic_v< T > || std::is_enum_v< T > || Bitwise< T >::value;
+
+template < typename T >
+inline constexpr bool IsBitwiseArray = false;
+template < typename T, std::size_t N >
+inline constexpr bool IsBitwiseArray< std::array< T, N > > = IsBitwise< T >;
+} // namespace arena_archive
+
+class ArenaSaveArchive
+{
+public:
+    using Index = U64;
+
+    static constexpr U64 DEFAULT_ARENA_SIZE = 1U << 20;
+
+    // szReserve pre-sizes the arena so that typical snapshots never reallocate
+    ArenaSaveArchive( U64 szReserve = DEFAULT_ARENA_SIZE )
+        : m_szCapacity( std::max< U64 >( szReserve, sizeof( ArenaArchiveHeader ) ) )
+        , m_pArena( new char[ m_szCapacity ] )
+        , m_szSize( sizeof( ArenaArchiveHeader ) )
+    {
+    }
+
+    template < typename T >
+    inline ArenaSaveArchive& operator&( const T& value )
+    {
+        save( value );
+        return *this;
+    }
+
+    template < typename T >
+    inline ArenaSaveArchive& operator<<( const T& value )
+    {
+        save( value );
+        return *this;
+    }
+
+    template < typename T >
+    inline void save( const T& value )
+    {
+        if constexpr( arena_archive::IsPointer< T > )
+        {
+            const Index index = refToIndex( value );
+            write( &index, sizeof( Index ) );
+        }
+        else if constexpr( arena_archive::IsBitwise< T > || arena_archive::IsBitwiseArray< T > )
+        {
+            static_assert( std::is_trivially_copyable_v< T > );
+            write( &value, sizeof( T ) );
+        }
+        else if constexpr( arena_archive::IsArray< T >::value )
+        {
+            for( const auto& element : value )
+            {
+                save( element );
+            }
+        }
+        else if constexpr( std::is_same_v< T, std::string > )
+        {
+            const U64 szSize = value.size();
+            write( &szSize, sizeof( U64 ) );
+            write( value.data(), szSize );
+        }
+        else if constexpr( arena_archive::IsVector< T >::value )
+        {
+            using ValueType   = typename T::value_type;
+            const U64 szSize = value.size();
+            write( &szSize, sizeof( U64 ) );
+            if constexpr( arena_archive::IsBitwise< ValueType > )
+            {
+                write( value.data(), szSize * sizeof( ValueType ) );
+            }
+            else
+            {
+                for( const ValueType& element : value )
+                {
+                    save( element );
+                }
+            }
+        }
+        else
+        {
+            static_assert( requires( T& object, ArenaSaveArchive& archive ) { object.serialize( archive, 0U ); },
+                           "Arena archive type needs a serialize member or an arena_archive::Bitwise opt in" );
+            const_cast< T& >( value ).serialize( *this, 0U );
+        }
+    }
+
+    inline void beginObject( const runtime::Pointer& ref ) { m_objects.push_back( refToIndex( ref ) ); }
+
+    inline Index refToIndex( const runtime::Pointer& ref )
+    {
+        if( const Index* pIndex = m_index.find( ref ) )
+        {
+            return *pIndex;
+        }
+        const Index index = m_table.size();
+        m_index.insert( ref, index );
+        m_table.push_back( ref );
+        return index;
+    }
+
+    // append the object indices and pointer table and complete the header.
+    // The returned arena remains owned by the archive.
+    inline std::span< const char > makeArena( runtime::TimeStamp timestamp )
+    {
+        const U64 szDataSize = m_szSize - sizeof( ArenaArchiveHeader );
+        align();
+        const U64 szObjectsOffset = m_szSize;
+        if( !m_objects.empty() )
+        {
+            write( m_objects.data(), m_objects.size() * sizeof( Index ) );
+        }
+        const U64 szTableOffset = m_szSize;
+        if( !m_table.empty() )
+        {
+            write( m_table.data(), m_table.size() * sizeof( runtime::Pointer ) );
+        }
+
+        const ArenaArchiveHeader header{ ArenaArchiveHeader::MAGIC,
+                                         ArenaArchiveHeader::VERSION,
+                                         timestamp.getValue(),
+                                         0U,
+                                         szDataSize,
+                                         szObjectsOffset,
+                                         m_objects.size(),
+                                         szTableOffset,
+                                         m_table.size() };
+        std::memcpy( m_pArena.get(), &header, sizeof( ArenaArchiveHeader ) );
+        return { m_pArena.get(), m_szSize };
+    }
+
+private:
+    inline void write( const void* pData, U64 szSize )
+    {
+        if( m_szSize + szSize > m_szCapacity )
+        {
+            grow( m_szSize + szSize );
+        }
+        std::memcpy( m_pArena.get() + m_szSize, pData, szSize );
+        m_szSize += szSize;
+    }
+
+    inline void align()
+    {
+        static const std::array< char, alignof( U64 ) > padding{};
+        const U64 szRemainder = m_szSize % alignof( U64 );
+        if( szRemainder != 0U )
+        {
+            write( padding.data(), alignof( U64 ) - szRemainder );
+        }
+    }
+
+    inline void grow( U64 szRequired )
+    {
+        U64 szCapacity = m_szCapacity * 2U;
+        while( szCapacity < szRequired )
+        {
+            szCapacity *= 2U;
+        }
+        std::unique_ptr< char[] > pArena( new char[ szCapacity ] );
+        std::memcpy( pArena.get(), m_pArena.get(), m_szSize );
+        m_pArena     = std::move( pArena );
+        m_szCapacity = szCapacity;
+    }
+
+private:
+    U64                             m_szCapacity;
+    std::unique_ptr< char[] >       m_pArena;
+    U64                             m_szSize;
+    PointerIndex< Index >           m_index;
+    std::vector< runtime::Pointer > m_table;
+    std::vector< Index >            m_objects;
+};
+
+class ArenaLoadArchive
+{
+public:
+    using Index = ArenaSaveArchive::Index;
+
+    // pData must remain valid for the lifetime of the archive - typically an mmapped file
+    ArenaLoadArchive( const void* pData, U64 szSize )
+        : m_pArena( reinterpret_cast< const char* >( pData ) )
+        , m_szSize( szSize )
+    {
+        VERIFY_RTE_MSG( m_szSize >= sizeof( ArenaArchiveHeader ), "Arena archive too small" );
+        std::memcpy( &m_header, m_pArena, sizeof( ArenaArchiveHeader ) );
+        VERIFY_RTE_MSG( m_header.uiMagic == ArenaArchiveHeader::MAGIC, "Invalid arena archive" );
+        VERIFY_RTE_MSG( m_header.uiVersion == ArenaArchiveHeader::VERSION,
+                        "Unsupported arena archive version: " << m_header.uiVersion );
+        // every section must lie within the arena - written without overflow since the header is untrusted
+        auto fits = [ szSize = m_szSize ]( U64 szOffset, U64 szCount, U64 szElementSize )
+        { return ( szOffset <= szSize ) && ( szCount <= ( szSize - szOffset ) / szElementSize ); };
+        VERIFY_RTE_MSG( fits( sizeof( ArenaArchiveHeader ), m_header.szDataSize, 1U )
+                            && fits( m_header.szObjectsOffset, m_header.szObjectCount, sizeof( Index ) )
+                            && fits( m_header.szTableOffset, m_header.szTableSize, sizeof( runtime::Pointer ) ),
+                        "Corrupt arena archive" );
+
+        m_pIter   = m_pArena + sizeof( ArenaArchiveHeader );
+        m_pEnd    = m_pIter + m_header.szDataSize;
+        m_objects = { reinterpret_cast< const Index* >( m_pArena + m_header.szObjectsOffset ),
+                      m_header.szObjectCount };
+        m_table   = { reinterpret_cast< const runtime::Pointer* >( m_pArena + m_header.szTableOffset ),
+                      m_header.szTableSize };
+    }
+
+    ArenaLoadArchive( std::span< const char > arena )
+        : ArenaLoadArchive( arena.data(), arena.size() )
+    {
+    }
+
+    inline runtime::TimeStamp                getTimeStamp() const { return runtime::TimeStamp{ m_header.uiTimeStamp }; }
+    inline std::span< const Index >          getObjects() const { return m_objects; }
+    inline std::span< const runtime::Pointer > getTable() const { return m_table; }
+
+    // replace the pointer table i.e. when the objects have been allocated at new addresses
+    inline void remap( std::span< const runtime::Pointer > table )
+    {
+        VERIFY_RTE_MSG( table.size() == m_table.size(), "Arena archive remap table has incorrect size" );
+        m_table = table;
+    }
+
+    // the index comes from the arena which may be an mmapped file so is always checked
+    inline const runtime::Pointer& indexToRef( Index index ) const
+    {
+        VERIFY_RTE_MSG( index < m_table.size(), "Corrupt arena archive pointer index: " << index );
+        return m_table[ index ];
+    }
+
+    template < typename T >
+    inline ArenaLoadArchive& operator&( T& value )
+    {
+        load( value );
+        return *this;
+    }
+
+    template < typename T >
+    inline ArenaLoadArchive& operator>>( T& value )
+    {
+        load( value );
+        return *this;
+    }
+
+    template < typename T >
+    inline void load( T& value )
+    {
+        if constexpr( arena_archive::IsPointer< T > )
+        {
+            Index index;
+            read( &index, sizeof( Index ) );
+            value = indexToRef( index );
+        }
+        else if constexpr( arena_archive::IsBitwise< T > || arena_archive::IsBitwiseArray< T > )
+        {
+            read( &value, sizeof( T ) );
+        }
+        else if constexpr( arena_archive::IsArray< T >::value )
+        {
+            for( auto& element : value )
+            {
+                load( element );
+            }
+        }
+        else if constexpr( std::is_same_v< T, std::string > )
+        {
+            U64 szSize;
+            read( &szSize, sizeof( U64 ) );
+            VERIFY_RTE_MSG( szSize <= static_cast< U64 >( m_pEnd - m_pIter ), "Corrupt arena archive" );
+            value.assign( m_pIter, szSize );
+            m_pIter += szSize;
+        }
+        else if constexpr( arena_archive::IsVector< T >::value )
+        {
+            using ValueType = typename T::value_type;
+            U64 szSize;
+            read( &szSize, sizeof( U64 ) );
+            if constexpr( arena_archive::IsBitwise< ValueType > )
+            {
+                VERIFY_RTE_MSG( szSize <= static_cast< U64 >( m_pEnd - m_pIter ) / sizeof( ValueType ),
+                                "Corrupt arena archive" );
+                value.resize( szSize );
+                read( value.data(), szSize * sizeof( ValueType ) );
+            }
+            else
+            {
+                value.resize( szSize );
+                for( ValueType& element : value )
+                {
+                    load( element );
+                }
+            }
+        }
+        else
+        {
+            value.serialize( *this, 0U );
+        }
+    }
+
+private:
+    inline void read( void* pData, U64 szSize )
+    {
+        VERIFY_RTE_MSG( szSize <= static_cast< U64 >( m_pEnd - m_pIter ), "Corrupt arena archive" );
+        std::memcpy( pData, m_pIter, szSize );
+        m_pIter += szSize;
+    }
+
+private:
+    const char*                         m_pArena;
+    U64                                 m_szSize;
+    ArenaArchiveHeader                  m_header;
+    const char*                         m_pIter;
+    const char*                         m_pEnd;
+    std::span< const Index >            m_objects;
+    std::span< const runtime::Pointer > m_table;
+};
+
+} // namespace mega
+
+#endif // GUARD_2026_October_18_arena_archive
@@ -0,0 +1,150 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_bitmap_allocator
+#define GUARD_2026_October_18_bitmap_allocator
+
+#include "mega/values/native_types.hpp"
+
+#include <array>
+#include <bit>
+#include <vector>
+
+namespace mega
+{
+
+// Hierarchical bitmap allocator over the ids [0,Size) - allocates the lowest free id.
+// A set bit marks an allocated id so a zero initialised allocator is empty and needs no setup.
+// Each summary bit marks a full leaf word and each top bit a full summary word so
+// allocate and free are a fixed number of word operations for Size up to 64^3.
+template < typename TInstanceType, mega::U64 _Size >
+class BitmapAllocator
+{
+    using Word = mega::U64;
+
+    static constexpr mega::U64 WORD_BITS     = 64U;
+    static constexpr mega::U64 LEAF_WORDS    = ( _Size + WORD_BITS - 1U ) / WORD_BITS;
+    static constexpr mega::U64 SUMMARY_WORDS = ( LEAF_WORDS + WORD_BITS - 1U ) / WORD_BITS;
+
+    static_assert( _Size > 0U, "BitmapAllocator requires at least one id" );
+    static_assert( SUMMARY_WORDS <= WORD_BITS, "BitmapAllocator Size exceeds three levels" );
+
+    // mask of the valid bits in word index of a level holding total bits
+    static constexpr Word validMask( mega::U64 total, mega::U64 index )
+    {
+        const mega::U64 remaining = total - ( index * WORD_BITS );
+        return remaining >= WORD_BITS ? ~Word{ 0U } : ( ( Word{ 1U } << remaining ) - 1U );
+    }
+    static constexpr Word leafMask( mega::U64 index ) { return validMask( _Size, index ); }
+    static constexpr Word summaryMask( mega::U64 index ) { return validMask( LEAF_WORDS, index ); }
+    static constexpr Word TOP_MASK = validMask( SUMMARY_WORDS, 0U );
+
+public:
+    using InstanceType          = TInstanceType;
+    static const mega::U64 Size = _Size;
+
+    inline void reset()
+    {
+        m_leaves.fill( 0U );
+        m_summary.fill( 0U );
+        m_top         = 0U;
+        m_szAllocated = 0U;
+    }
+
+    inline bool      empty() const { return m_szAllocated == 0U; }
+    inline bool      full() const { return m_top == TOP_MASK; }
+    inline mega::U64 size() const { return m_szAllocated; }
+
+    inline bool isAllocated( InstanceType instance ) const
+    {
+        const mega::U64 id = instance.getValue();
+        return ( m_leaves[ id / WORD_BITS ] & ( Word{ 1U } << ( id % WORD_BITS ) ) ) != 0U;
+    }
+
+    // caller must check full() first
+    inline InstanceType allocate()
+    {
+        const mega::U64 summaryIndex = std::countr_zero( ~m_top & TOP_MASK );
+        const mega::U64 leafIndex
+            = summaryIndex * WORD_BITS
+              + std::countr_zero( ~m_summary[ summaryIndex ] & summaryMask( summaryIndex ) );
+        const mega::U64 bit = std::countr_zero( ~m_leaves[ leafIndex ] & leafMask( leafIndex ) );
+
+        m_leaves[ leafIndex ] |= Word{ 1U } << bit;
+        ++m_szAllocated;
+        if( m_leaves[ leafIndex ] == leafMask( leafIndex ) )
+        {
+            m_summary[ summaryIndex ] |= Word{ 1U } << ( leafIndex % WORD_BITS );
+            if( m_summary[ summaryIndex ] == summaryMask( summaryIndex ) )
+            {
+                m_top |= Word{ 1U } << summaryIndex;
+            }
+        }
+        return InstanceType{ static_cast< typename InstanceType::ValueType >( leafIndex * WORD_BITS + bit ) };
+    }
+
+    inline void free( InstanceType instance )
+    {
+        const mega::U64 id        = instance.getValue();
+        const mega::U64 leafIndex = id / WORD_BITS;
+        const Word      bit       = Word{ 1U } << ( id % WORD_BITS );
+        if( ( m_leaves[ leafIndex ] & bit ) != 0U )
+        {
+            m_leaves[ leafIndex ] &= ~bit;
+            m_summary[ leafIndex / WORD_BITS ] &= ~( Word{ 1U } << ( leafIndex % WORD_BITS ) );
+            m_top &= ~( Word{ 1U } << ( leafIndex / WORD_BITS ) );
+            --m_szAllocated;
+        }
+    }
+
+    template < class Archive >
+    inline void serialize( Archive&, const unsigned int )
+    {
+    }
+
+    // ascending order
+    inline std::vector< InstanceType > getAllocated() const
+    {
+        std::vector< InstanceType > allocated;
+        allocated.reserve( m_szAllocated );
+        for( mega::U64 leafIndex = 0U; leafIndex != LEAF_WORDS; ++leafIndex )
+        {
+            Word word = m_leaves[ leafIndex ];
+            for( auto sz = std::popcount( word ); sz != 0; --sz )
+            {
+                const mega::U64 bit = std::countr_zero( word );
+                allocated.push_back(
+                    InstanceType{ static_cast< typename InstanceType::ValueType >( leafIndex * WORD_BITS + bit ) } );
+                word &= word - 1U;
+            }
+        }
+        return allocated;
+    }
+
+private:
+    std::array< Word, LEAF_WORDS >    m_leaves{};
+    std::array< Word, SUMMARY_WORDS > m_summary{};
+    Word                              m_top         = 0U;
+    mega::U64                         m_szAllocated = 0U;
+};
+
+} // namespace mega
+
+#endif // GUARD_2026_October_18_bitmap_allocator
@@ -0,0 +1,188 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_event_index
+#define GUARD_2026_October_18_event_index
+
+#include "mega/values/native_types.hpp"
+#include "mega/values/runtime/pointer.hpp"
+#include "mega/pointer_index.hpp"
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+namespace mega
+{
+
+// Flat index of event registrations sorted by the raw Pointer of the event.
+// New registrations are appended to an unsorted fresh run and merged into a
+// small sorted tail run on the next match.  The tail is folded into the main
+// run once it exceeds an eighth of it so the cost of keeping the index sorted
+// is amortised O(1) per registration.  A match merge joins a sorted batch of
+// events against both runs using a galloping search.  Consumed registrations
+// are cleared in place and removed by compact() once they make up half of the
+// index.  TValue must be a nullable pointer type.
+template < typename TValue >
+class SortedEventIndex
+{
+public:
+    struct Entry
+    {
+        runtime::Pointer event;
+        TValue           value;
+    };
+    using EntryVector = std::vector< Entry >;
+
+    inline U64  size() const { return m_main.size() + m_tail.size() + m_fresh.size(); }
+    inline bool empty() const { return size() == 0U; }
+
+    inline void insert( const runtime::Pointer& event, TValue value ) { m_fresh.push_back( Entry{ event, value } ); }
+
+    // record registrations that became stale without being visited i.e. siblings of a woken wait
+    inline void addDead( U64 count ) { m_dead += count; }
+
+    inline bool needsCompact() const { return m_dead * 2U > size(); }
+
+    // events MUST be sorted by PointerRaw::Less and unique.
+    // onMatch( const runtime::Pointer& event, TValue value ) is invoked for every non null
+    // registration of every event and the registration is consumed.  onMatch may insert.
+    template < typename Functor >
+    void match( std::span< const runtime::Pointer > events, Functor&& onMatch )
+    {
+        prepare();
+        join( m_main, events, onMatch );
+        join( m_tail, events, onMatch );
+    }
+
+    // isStale( TValue ) returns true when a non null registration can be dropped
+    template < typename Functor >
+    void compact( Functor&& isStale )
+    {
+        auto isDead = [ &isStale ]( Entry& entry ) { return !entry.value || isStale( entry.value ); };
+        m_main.erase( std::remove_if( m_main.begin(), m_main.end(), isDead ), m_main.end() );
+        m_tail.erase( std::remove_if( m_tail.begin(), m_tail.end(), isDead ), m_tail.end() );
+        m_fresh.erase( std::remove_if( m_fresh.begin(), m_fresh.end(), isDead ), m_fresh.end() );
+        m_dead = 0U;
+    }
+
+    template < typename Functor >
+    void for_each( Functor&& functor ) const
+    {
+        for( const EntryVector* pRun : { &m_main, &m_tail, &m_fresh } )
+        {
+            for( const Entry& entry : *pRun )
+            {
+                if( entry.value )
+                {
+                    functor( entry.event, entry.value );
+                }
+            }
+        }
+    }
+
+    void clear()
+    {
+        m_main.clear();
+        m_tail.clear();
+        m_fresh.clear();
+        m_dead = 0U;
+    }
+
+private:
+    static inline bool lessEntry( const Entry& left, const Entry& right )
+    {
+        return PointerRaw::Less()( left.event, right.event );
+    }
+
+    void prepare()
+    {
+        if( !m_fresh.empty() )
+        {
+            std::sort( m_fresh.begin(), m_fresh.end(), &lessEntry );
+            merge_into( m_tail, m_fresh );
+            m_fresh.clear();
+        }
+        if( m_tail.size() * 8U > m_main.size() )
+        {
+            merge_into( m_main, m_tail );
+            m_tail.clear();
+        }
+    }
+
+    static void merge_into( EntryVector& target, const EntryVector& source )
+    {
+        const auto szMiddle = target.size();
+        target.insert( target.end(), source.begin(), source.end() );
+        std::inplace_merge( target.begin(), target.begin() + szMiddle, target.end(), &lessEntry );
+    }
+
+    // exponential then binary search for the first entry not less than event
+    static inline U64 gallop( const EntryVector& run, U64 szFrom, const runtime::Pointer& event )
+    {
+        const PointerRaw::Less less;
+        U64                    szStep = 1U;
+        U64                    szLow  = szFrom;
+        U64                    szHigh = szFrom;
+        while( ( szHigh < run.size() ) && less( run[ szHigh ].event, event ) )
+        {
+            szLow  = szHigh + 1U;
+            szHigh = szHigh + szStep;
+            szStep *= 2U;
+        }
+        szHigh = std::min< U64 >( szHigh, run.size() );
+        return static_cast< U64 >( std::lower_bound( run.begin() + szLow, run.begin() + szHigh, event,
+                                                     []( const Entry& entry, const runtime::Pointer& key )
+                                                     { return PointerRaw::Less()( entry.event, key ); } )
+                                   - run.begin() );
+    }
+
+    template < typename Functor >
+    void join( EntryVector& run, std::span< const runtime::Pointer > events, Functor& onMatch )
+    {
+        const PointerRaw::Equal equal;
+        U64                     szPos = 0U;
+        for( const runtime::Pointer& event : events )
+        {
+            if( szPos == run.size() )
+            {
+                break;
+            }
+            szPos = gallop( run, szPos, event );
+            for( ; ( szPos != run.size() ) && equal( run[ szPos ].event, event ); ++szPos )
+            {
+                // index by position since onMatch may append to the fresh run only
+                if( TValue value = run[ szPos ].value )
+                {
+                    run[ szPos ].value = TValue{};
+                    ++m_dead;
+                    onMatch( event, value );
+                }
+            }
+        }
+    }
+
+    EntryVector m_main, m_tail, m_fresh;
+    U64         m_dead = 0U;
+};
+
+} // namespace mega
+
+#endif // GUARD_2026_October_18_event_index
@@ -0,0 +1,131 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_intrusive_list
+#define GUARD_2026_October_18_intrusive_list
+
+#include "common/assert_verify.hpp"
+
+#include <cstddef>
+
+namespace mega
+{
+
+// Hook embedded in any type that wants to live in an IntrusiveList.
+// A node can be in at most one list per hook at a time and records
+// which list that is so it can be unlinked without knowing the owner.
+template < typename TOwner >
+struct IntrusiveListHook
+{
+    IntrusiveListHook* m_pPrev  = nullptr;
+    IntrusiveListHook* m_pNext  = nullptr;
+    TOwner*            m_pOwner = nullptr;
+
+    inline bool isLinked() const { return m_pOwner != nullptr; }
+};
+
+// Circular doubly linked list with a sentinel head that never allocates.
+// T must derive from IntrusiveList< T, Tag >::Hook.  Use a distinct Tag
+// when T needs to be linked into more than one kind of list at once.
+template < typename T, typename Tag = void >
+class IntrusiveList
+{
+public:
+    using Hook = IntrusiveListHook< IntrusiveList< T, Tag > >;
+
+    IntrusiveList() { m_head.m_pPrev = m_head.m_pNext = &m_head; }
+
+    IntrusiveList( const IntrusiveList& )            = delete;
+    IntrusiveList& operator=( const IntrusiveList& ) = delete;
+
+    ~IntrusiveList() { clear(); }
+
+    inline bool        empty() const { return m_head.m_pNext == &m_head; }
+    inline std::size_t size() const { return m_size; }
+
+    inline bool owns( const T* pNode ) const { return static_cast< const Hook* >( pNode )->m_pOwner == this; }
+
+    inline T* front() const
+    {
+        ASSERT( !empty() );
+        return static_cast< T* >( m_head.m_pNext );
+    }
+
+    inline void push_back( T* pNode )
+    {
+        Hook* pHook = pNode;
+        ASSERT( !pHook->isLinked() );
+        pHook->m_pPrev          = m_head.m_pPrev;
+        pHook->m_pNext          = &m_head;
+        m_head.m_pPrev->m_pNext = pHook;
+        m_head.m_pPrev          = pHook;
+        pHook->m_pOwner         = this;
+        ++m_size;
+    }
+
+    inline void erase( T* pNode )
+    {
+        Hook* pHook = pNode;
+        ASSERT( pHook->m_pOwner == this );
+        pHook->m_pPrev->m_pNext = pHook->m_pNext;
+        pHook->m_pNext->m_pPrev = pHook->m_pPrev;
+        pHook->m_pPrev = pHook->m_pNext = nullptr;
+        pHook->m_pOwner                 = nullptr;
+        --m_size;
+    }
+
+    // unlink from whichever list currently owns the node - if any
+    static inline void unlink( T* pNode )
+    {
+        Hook* pHook = pNode;
+        if( pHook->isLinked() )
+        {
+            pHook->m_pOwner->erase( pNode );
+        }
+    }
+
+    inline void clear()
+    {
+        while( !empty() )
+        {
+            erase( front() );
+        }
+    }
+
+    template < typename Functor >
+    inline void for_each( Functor&& functor ) const
+    {
+        for( Hook* pHook = m_head.m_pNext; pHook != &m_head; )
+        {
+            // allow the functor to unlink the current node
+            Hook* pNext = pHook->m_pNext;
+            functor( static_cast< T* >( pHook ) );
+            pHook = pNext;
+        }
+    }
+
+private:
+    Hook        m_head;
+    std::size_t m_size = 0U;
+};
+
+} // namespace mega
+
+#endif // GUARD_2026_October_18_intrusive_list
@@ -0,0 +1,100 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_object_pool
+#define GUARD_2026_October_18_object_pool
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace mega
+{
+
+// Slab allocator for fixed size objects.  Storage is allocated in blocks of
+// BlockSize objects that are never returned until the pool is destroyed so
+// steady state allocate / free is a free list push / pop.
+// NOTE: the pool does NOT track live objects - the owner must free every
+// object it allocated before destroying the pool.
+template < typename T, std::size_t BlockSize = 1024U >
+class ObjectPool
+{
+    union Slot
+    {
+        Slot* pNextFree;
+        alignas( T ) unsigned char storage[ sizeof( T ) ];
+    };
+    using Block     = std::unique_ptr< Slot[] >;
+    using BlockList = std::vector< Block >;
+
+public:
+    ObjectPool()                               = default;
+    ObjectPool( const ObjectPool& )            = delete;
+    ObjectPool& operator=( const ObjectPool& ) = delete;
+
+    template < typename... Args >
+    inline T* allocate( Args&&... args )
+    {
+        if( m_pFree == nullptr )
+        {
+            grow();
+        }
+        Slot* pSlot = m_pFree;
+        m_pFree     = pSlot->pNextFree;
+        ++m_size;
+        return new( pSlot->storage ) T( std::forward< Args >( args )... );
+    }
+
+    inline void free( T* pObject )
+    {
+        pObject->~T();
+        Slot* pSlot      = reinterpret_cast< Slot* >( pObject );
+        pSlot->pNextFree = m_pFree;
+        m_pFree          = pSlot;
+        --m_size;
+    }
+
+    inline std::size_t size() const { return m_size; }
+    inline std::size_t capacity() const { return m_blocks.size() * BlockSize; }
+
+private:
+    void grow()
+    {
+        Block block( new Slot[ BlockSize ] );
+        Slot* pBlock = block.get();
+        for( std::size_t i = 0U; i != BlockSize - 1U; ++i )
+        {
+            pBlock[ i ].pNextFree = &pBlock[ i + 1U ];
+        }
+        pBlock[ BlockSize - 1U ].pNextFree = m_pFree;
+        m_pFree                            = pBlock;
+        m_blocks.emplace_back( std::move( block ) );
+    }
+
+    BlockList   m_blocks;
+    Slot*       m_pFree = nullptr;
+    std::size_t m_size  = 0U;
+};
+
+} // namespace mega
+
+#endif // GUARD_2026_October_18_object_pool
@@ -0,0 +1,229 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_pointer_index
+#define GUARD_2026_October_18_pointer_index
+
+#include "mega/values/native_types.hpp"
+#include "mega/values/runtime/pointer.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace mega
+{
+
+// Bitwise key operations on the raw 16 byte c_pointer so that containers keyed
+// on Pointer do not depend on the heap / network interpretation of the value.
+struct PointerRaw
+{
+    static inline void words( const runtime::Pointer& ptr, U64& a, U64& b )
+    {
+        static_assert( sizeof( runtime::Pointer ) == 2U * sizeof( U64 ) );
+        std::memcpy( &a, &ptr, sizeof( U64 ) );
+        std::memcpy( &b, reinterpret_cast< const char* >( &ptr ) + sizeof( U64 ), sizeof( U64 ) );
+    }
+
+    struct Hash
+    {
+        inline U64 operator()( const runtime::Pointer& ptr ) const noexcept
+        {
+            U64 a, b;
+            words( ptr, a, b );
+            // fibonacci mix so that aligned heap addresses spread across the low bits
+            return ( a ^ ( b * 0x9E3779B97F4A7C15ULL ) ) * 0x9E3779B97F4A7C15ULL;
+        }
+    };
+
+    struct Equal
+    {
+        inline bool operator()( const runtime::Pointer& left, const runtime::Pointer& right ) const noexcept
+        {
+            return std::memcmp( &left, &right, sizeof( runtime::Pointer ) ) == 0;
+        }
+    };
+
+    struct Less
+    {
+        inline bool operator()( const runtime::Pointer& left, const runtime::Pointer& right ) const noexcept
+        {
+            U64 la, lb, ra, rb;
+            words( left, la, lb );
+            words( right, ra, rb );
+            return ( la != ra ) ? ( la < ra ) : ( lb < rb );
+        }
+    };
+};
+
+// Open addressing hash map from Pointer to a small trivially copyable value.
+// Linear probing with backward shift deletion so there are no tombstones and
+// lookups touch a single contiguous run of slots.
+template < typename TValue >
+class PointerIndex
+{
+    struct Slot
+    {
+        runtime::Pointer key;
+        TValue           value;
+        bool             bOccupied = false;
+    };
+    using SlotVector = std::vector< Slot >;
+
+    static constexpr U64 MIN_CAPACITY = 64U;
+
+public:
+    PointerIndex()
+        : m_slots( MIN_CAPACITY )
+        , m_mask( MIN_CAPACITY - 1U )
+    {
+    }
+
+    inline U64  size() const { return m_size; }
+    inline bool empty() const { return m_size == 0U; }
+
+    inline TValue* find( const runtime::Pointer& key )
+    {
+        for( U64 i = index( key );; i = ( i + 1U ) & m_mask )
+        {
+            Slot& slot = m_slots[ i ];
+            if( !slot.bOccupied )
+            {
+                return nullptr;
+            }
+            if( PointerRaw::Equal()( slot.key, key ) )
+            {
+                return &slot.value;
+            }
+        }
+    }
+
+    // returns false if the key already exists
+    inline bool insert( const runtime::Pointer& key, const TValue& value )
+    {
+        if( ( m_size + 1U ) * 2U > m_slots.size() )
+        {
+            grow();
+        }
+        for( U64 i = index( key );; i = ( i + 1U ) & m_mask )
+        {
+            Slot& slot = m_slots[ i ];
+            if( !slot.bOccupied )
+            {
+                slot.key       = key;
+                slot.value     = value;
+                slot.bOccupied = true;
+                ++m_size;
+                return true;
+            }
+            if( PointerRaw::Equal()( slot.key, key ) )
+            {
+                return false;
+            }
+        }
+    }
+
+    inline bool erase( const runtime::Pointer& key )
+    {
+        U64 i = index( key );
+        for( ;; i = ( i + 1U ) & m_mask )
+        {
+            const Slot& slot = m_slots[ i ];
+            if( !slot.bOccupied )
+            {
+                return false;
+            }
+            if( PointerRaw::Equal()( slot.key, key ) )
+            {
+                break;
+            }
+        }
+
+        // backward shift the remainder of the probe run into the hole
+        U64 hole = i;
+        for( U64 j = ( hole + 1U ) & m_mask;; j = ( j + 1U ) & m_mask )
+        {
+            Slot& slot = m_slots[ j ];
+            if( !slot.bOccupied )
+            {
+                break;
+            }
+            const U64 ideal = index( slot.key );
+            // can slot j move to the hole without passing its ideal position
+            if( ( ( j - ideal ) & m_mask ) >= ( ( j - hole ) & m_mask ) )
+            {
+                m_slots[ hole ] = slot;
+                hole            = j;
+            }
+        }
+        m_slots[ hole ].bOccupied = false;
+        --m_size;
+        return true;
+    }
+
+    inline void clear()
+    {
+        for( Slot& slot : m_slots )
+        {
+            slot.bOccupied = false;
+        }
+        m_size = 0U;
+    }
+
+    template < typename Functor >
+    inline void for_each( Functor&& functor ) const
+    {
+        for( const Slot& slot : m_slots )
+        {
+            if( slot.bOccupied )
+            {
+                functor( slot.key, slot.value );
+            }
+        }
+    }
+
+private:
+    inline U64 index( const runtime::Pointer& key ) const { return PointerRaw::Hash()( key ) >> m_shift; }
+
+    // capacity always doubles so the hash shift drops by one bit
+    void grow()
+    {
+        SlotVector old( m_slots.size() * 2U );
+        old.swap( m_slots );
+        m_mask  = m_slots.size() - 1U;
+        m_shift = m_shift - 1U;
+        m_size  = 0U;
+        for( const Slot& slot : old )
+        {
+            if( slot.bOccupied )
+            {
+                insert( slot.key, slot.value );
+            }
+        }
+    }
+
+    SlotVector m_slots;
+    U64        m_mask;
+    U64        m_shift = 64U - 6U; // log2( MIN_CAPACITY )
+    U64        m_size  = 0U;
+};
+
+} // namespace mega
+
+#endif // GUARD_2026_October_18_pointer_index
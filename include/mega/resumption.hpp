@@ -103,6 +103,12 @@ inline ReturnReason sleep_until( std::chrono::duration< Rep, Period > const& tim
     return ReturnReason( std::chrono::steady_clock::now() + timeout_duration );
 }
 
+// simulation cycle timeouts are deterministic under replay
+inline ReturnReason sleep_until( const runtime::TimeStamp& cycle )
+{
+    return ReturnReason( cycle );
+}
+
 inline ReturnReason sleep_until( F32 fDuration )
 {
     auto floatDuration   = std::chrono::duration< F32, std::ratio< 1 > >( fDuration );
@@ -22,6 +22,7 @@
 #define GUARD_2023_August_07_return_reason
 
 #include "mega/values/runtime/pointer.hpp"
+#include "mega/values/runtime/timestamp.hpp"
 
 #include <chrono>
 #include <optional>
@@ -47,6 +48,7 @@ struct ReturnReason
     Reason                                                 reason;
     std::vector< runtime::Pointer >                        events;
     std::optional< std::chrono::steady_clock::time_point > timeout;
+    std::optional< runtime::TimeStamp >                    cycleTimeout;
 
     ReturnReason()
         : reason( eReason_Complete )
@@ -75,6 +77,12 @@ struct ReturnReason
         , timeout( _timeout )
     {
     }
+
+    ReturnReason( const runtime::TimeStamp& _cycleTimeout )
+        : reason( eReason_Timeout )
+        , cycleTimeout( _cycleTimeout )
+    {
+    }
 };
 
 } // namespace mega
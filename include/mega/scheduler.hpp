@@ -22,15 +22,21 @@
 #define GUARD_2023_August_01_BasicScheduler
 
 #include "mega/values/runtime/pointer.hpp"
+#include "mega/values/runtime/timestamp.hpp"
 #include "mega/return_reason.hpp"
+#include "mega/event_index.hpp"
+#include "mega/intrusive_list.hpp"
+#include "mega/object_pool.hpp"
+#include "mega/pointer_index.hpp"
+#include "mega/timer_wheel.hpp"
 
 #include "common/unreachable.hpp"
 
-#include <list>
-#include <map>
-#include <unordered_map>
+#include <algorithm>
 #include <optional>
 #include <chrono>
+#include <span>
+#include <vector>
 
 #ifndef ERR
 #define ERR( msg )
@@ -39,20 +45,32 @@
 namespace mega
 {
 
+// BasicScheduler keeps all per action state in a pooled ActiveAction that is
+// linked into intrusive lists and indexed by a flat open addressing table so
+// that moving an action between the active, wait and sleep lists never allocates.
+// Timeouts live in two timer wheels - one ticking in wall clock milliseconds and
+// one ticking in simulation cycles for deterministic replay.
+// Event waits are registered in flat sorted indices and signals are dispatched
+// in sorted batches that merge join against them.
 template < typename ExecutionState >
 class BasicScheduler
 {
 private:
-    struct ActiveAction;
+    using Pointer = runtime::Pointer;
+    using Event   = runtime::Pointer;
 
-    using ActiveActionMap      = std::unordered_map< Pointer, ActiveAction*, Pointer::HashHeap >;
-    using ActiveActionMapIter  = typename ActiveActionMap::iterator;
-    using ActiveActionList     = std::list< typename ActiveActionMap::iterator >;
-    using ActiveActionIter     = typename ActiveActionList::iterator;
+    class ActiveAction;
+    struct TimeoutTag;
+    struct WaitSet;
+
+    using ActiveActionList     = IntrusiveList< ActiveAction >;
+    using ActiveActionPool     = ObjectPool< ActiveAction >;
+    using ActiveActionIndex    = PointerIndex< ActiveAction* >;
     using Timeout              = std::chrono::steady_clock::time_point;
-    using TimeoutQueue         = std::multimap< Timeout, ActiveActionMapIter >;
-    using EventRefMap          = std::multimap< Pointer, ActiveActionMapIter >;
-    using EventRefMapIterArray = std::vector< typename EventRefMap::iterator >;
+    using TimeoutWheel         = TimerWheel< ActiveAction, TimeoutTag >;
+    using WaitSetPool          = ObjectPool< WaitSet >;
+    using EventIndex           = SortedEventIndex< WaitSet* >;
+    using EventVector          = std::vector< Pointer >;
 
     enum SleepSwapState
     {
@@ -64,32 +82,33 @@ private:
         eState_S_W_A
     };
 
-    class ActiveAction
+    // The registrations of one wait_all / wait_any.  Each registration in the event
+    // index holds a reference as does the action until it wakes or stops.  Detaching
+    // the action makes every remaining registration stale in O(1) and they are
+    // dropped when next visited by a match or a compaction.
+    struct WaitSet
+    {
+        ActiveAction* pAction;
+        U32           uiRefCount;
+        U32           uiRemaining;
+        bool          bWaitAny;
+    };
+
+    // an action is linked into at most ONE of the active, wait, sleep or paused lists at a time
+    // and at most ONE of the timeout wheels
+    class ActiveAction : public ActiveActionList::Hook, public TimeoutWheel::Hook
     {
-        ExecutionState                  m_executionState;
-        ActiveActionIter                iter_one, iter_two, iter_three;
-        ActiveActionIter                iter_pause;
-        bool                            bWaitAny;
-        typename TimeoutQueue::iterator iter_timeout;
-        EventRefMapIterArray            iter_event_ref;
+        ExecutionState m_executionState;
+        WaitSet*       m_pWaitSet   = nullptr;
+        EventIndex*    m_pWaitIndex = nullptr;
 
     public:
         ActiveAction()                           = delete;
         ActiveAction( const ActiveAction& )      = delete;
         ActiveAction& operator=( ActiveAction& ) = delete;
 
-        ActiveAction( ExecutionState&& _executionState,
-                      ActiveActionIter _iter_one,
-                      ActiveActionIter _iter_two,
-                      ActiveActionIter _iter_three,
-                      ActiveActionIter _iter_pause )
+        ActiveAction( ExecutionState&& _executionState )
             : m_executionState( std::move( _executionState ) )
-            , iter_one( _iter_one )
-            , iter_two( _iter_two )
-            , iter_three( _iter_three )
-            , iter_pause( _iter_pause )
-            , bWaitAny( true )
-
         {
         }
 
@@ -100,86 +119,25 @@ private:
         void                onEvent( const Pointer& event ) { m_executionState.onEvent( event ); }
 
         inline const Pointer& getRef() const { return m_executionState.getRef(); }
-        bool                    isWaitAny() const { return bWaitAny; }
-        void                    setWaitAny( bool _bWaitAny ) { bWaitAny = _bWaitAny; }
 
-        inline ActiveActionIter& getActiveIter( SleepSwapState state )
-        {
-            switch( state )
-            {
-                case eState_A_W_S:
-                    return iter_one;
-                case eState_A_S_W:
-                    return iter_one;
-                case eState_W_A_S:
-                    return iter_two;
-                case eState_W_S_A:
-                    return iter_three;
-                case eState_S_A_W:
-                    return iter_two;
-                case eState_S_W_A:
-                    return iter_three;
-                default:
-                    UNREACHABLE;
-                    break;
-            }
-        }
-        inline ActiveActionIter& getWaitIter( SleepSwapState state )
-        {
-            switch( state )
-            {
-                case eState_A_W_S:
-                    return iter_two;
-                case eState_A_S_W:
-                    return iter_three;
-                case eState_W_A_S:
-                    return iter_one;
-                case eState_W_S_A:
-                    return iter_one;
-                case eState_S_A_W:
-                    return iter_three;
-                case eState_S_W_A:
-                    return iter_two;
-                default:
-                    UNREACHABLE;
-                    break;
-            }
-        }
-        inline ActiveActionIter& getSleepIter( SleepSwapState state )
-        {
-            switch( state )
-            {
-                case eState_A_W_S:
-                    return iter_three;
-                case eState_A_S_W:
-                    return iter_two;
-                case eState_W_A_S:
-                    return iter_three;
-                case eState_W_S_A:
-                    return iter_two;
-                case eState_S_A_W:
-                    return iter_one;
-                case eState_S_W_A:
-                    return iter_one;
-                default:
-                    UNREACHABLE;
-                    break;
-            }
-        }
-
-        inline ActiveActionIter&                getPauseIter() { return iter_pause; }
-        inline typename TimeoutQueue::iterator& getTimeoutIter() { return iter_timeout; }
-        inline EventRefMapIterArray&            getEventIterArray() { return iter_event_ref; }
+        inline WaitSet*&    getWaitSet() { return m_pWaitSet; }
+        inline EventIndex*& getWaitIndex() { return m_pWaitIndex; }
     };
 
-    ActiveActionMap  m_actions;
-    ActiveActionList m_listOne, m_listTwo, m_listThree;
-    TimeoutQueue     m_timeouts;
-    ActiveActionList m_paused;
-    EventRefMap      m_events_by_ref_sleep;
-    EventRefMap      m_events_by_ref_wait;
-    ActiveAction*    m_pCurrentAction = nullptr;
-    SleepSwapState   m_sleepState     = eState_A_W_S;
+    ActiveActionPool   m_pool;
+    ActiveActionIndex  m_actions;
+    ActiveActionList   m_listOne, m_listTwo, m_listThree;
+    ActiveActionList   m_paused;
+    const Timeout      m_timeoutEpoch = std::chrono::steady_clock::now();
+    TimeoutWheel       m_wallTimeouts;
+    TimeoutWheel       m_cycleTimeouts;
+    runtime::TimeStamp m_cycle;
+    WaitSetPool        m_waitSets;
+    EventIndex         m_events_by_ref_sleep;
+    EventIndex         m_events_by_ref_wait;
+    EventVector        m_signalBatch;
+    ActiveAction*      m_pCurrentAction = nullptr;
+    SleepSwapState     m_sleepState     = eState_A_W_S;
 
     void swapActiveSleep()
     {
@@ -303,177 +261,204 @@ private:
         }
     }
 
-    void active_insert( ActiveActionMapIter iterAction )
-    {
-        ActiveActionList& list                            = getActive();
-        iterAction->second->getActiveIter( m_sleepState ) = list.insert( list.end(), iterAction );
-    }
+    // the role of each list rotates with m_sleepState but every action records
+    // its owning list so removal never needs to know which role it is in
+    void list_remove( ActiveAction* pAction ) { ActiveActionList::unlink( pAction ); }
 
-    void active_remove( ActiveActionMapIter iterAction )
+    void active_insert( ActiveAction* pAction )
     {
-        ActiveActionList& list = getActive();
-        ActiveActionIter& i    = iterAction->second->getActiveIter( m_sleepState );
-        if( i != list.end() )
-        {
-            list.erase( i );
-            i = list.end();
-        }
+        list_remove( pAction );
+        getActive().push_back( pAction );
     }
-
-    void wait_insert( ActiveActionMapIter iterAction )
+    void wait_insert( ActiveAction* pAction )
     {
-        ActiveActionList& list                          = getWaiting();
-        iterAction->second->getWaitIter( m_sleepState ) = list.insert( list.end(), iterAction );
+        list_remove( pAction );
+        getWaiting().push_back( pAction );
     }
-    void wait_remove( ActiveActionMapIter iterAction )
+    void sleep_insert( ActiveAction* pAction )
     {
-        ActiveActionList& list = getWaiting();
-        ActiveActionIter& i    = iterAction->second->getWaitIter( m_sleepState );
-        if( i != list.end() )
-        {
-            list.erase( i );
-            i = list.end();
-        }
+        list_remove( pAction );
+        getSleeping().push_back( pAction );
     }
-
-    void sleep_insert( ActiveActionMapIter iterAction )
+    void pause_insert( ActiveAction* pAction )
     {
-        ActiveActionList& list                           = getSleeping();
-        iterAction->second->getSleepIter( m_sleepState ) = list.insert( list.end(), iterAction );
+        list_remove( pAction );
+        m_paused.push_back( pAction );
     }
-    void sleep_remove( ActiveActionMapIter iterAction )
+
+    // wall clock timeouts round up to the wheel resolution so they never fire early
+    static constexpr std::chrono::steady_clock::duration TIMEOUT_RESOLUTION = std::chrono::milliseconds( 1 );
+
+    U64 toWallTick( const Timeout& timeout ) const
     {
-        ActiveActionList& list = getSleeping();
-        ActiveActionIter& i    = iterAction->second->getSleepIter( m_sleepState );
-        if( i != list.end() )
+        if( timeout <= m_timeoutEpoch )
         {
-            list.erase( i );
-            i = list.end();
+            return 0U;
         }
+        return static_cast< U64 >( ( timeout - m_timeoutEpoch + TIMEOUT_RESOLUTION - std::chrono::nanoseconds( 1 ) )
+                                   / TIMEOUT_RESOLUTION );
     }
 
-    void pause_insert( ActiveActionMapIter iterAction )
+    void timeout_insert( ActiveAction* pAction, const ReturnReason& reason )
     {
-        iterAction->second->getPauseIter() = m_paused.insert( m_paused.end(), iterAction );
+        if( reason.cycleTimeout.has_value() )
+        {
+            m_cycleTimeouts.insert( pAction, reason.cycleTimeout.value().getValue() );
+        }
+        else
+        {
+            m_wallTimeouts.insert( pAction, toWallTick( reason.timeout.value() ) );
+        }
     }
-    void pause_remove( ActiveActionMapIter iterAction )
+    void timeout_remove( ActiveAction* pAction )
     {
-        if( iterAction->second->getPauseIter() != m_paused.end() )
+        if( !m_wallTimeouts.cancel( pAction ) )
         {
-            m_paused.erase( iterAction->second->getPauseIter() );
-            iterAction->second->getPauseIter() = m_paused.end();
+            m_cycleTimeouts.cancel( pAction );
         }
     }
 
-    void timeout_insert( ActiveActionMapIter iterAction, const Timeout& timeout )
+    // expire both wheels in batch with at most one clock read
+    void timeout_expire()
     {
-        typename TimeoutQueue::iterator insertResult = m_timeouts.insert( std::make_pair( timeout, iterAction ) );
-        iterAction->second->getTimeoutIter()         = insertResult;
+        auto activate = [ this ]( ActiveAction* pAction ) { active_insert( pAction ); };
+
+        m_cycleTimeouts.advance( m_cycle.getValue(), activate );
+
+        if( !m_wallTimeouts.empty() )
+        {
+            const Timeout now = std::chrono::steady_clock::now();
+            m_wallTimeouts.advance(
+                static_cast< U64 >( ( now - m_timeoutEpoch ) / TIMEOUT_RESOLUTION ), activate );
+        }
     }
-    void timeout_remove( ActiveActionMapIter iterAction )
+
+    void waitset_release( WaitSet* pWaitSet )
     {
-        if( iterAction->second->getTimeoutIter() != m_timeouts.end() )
+        if( --pWaitSet->uiRefCount == 0U )
         {
-            m_timeouts.erase( iterAction->second->getTimeoutIter() );
-            iterAction->second->getTimeoutIter() = m_timeouts.end();
+            m_waitSets.free( pWaitSet );
         }
     }
 
-    void event_insert( EventRefMap& eventMap, ActiveActionMapIter iterAction, const Event& ev )
+    void event_insert( EventIndex& eventIndex, ActiveAction* pAction, const EventVector& events, bool bWaitAny )
     {
-        typename EventRefMap::iterator i = eventMap.insert( std::make_pair( ev, iterAction ) );
-        iterAction->second->getEventIterArray().push_back( i );
+        if( events.empty() )
+        {
+            return;
+        }
+        WaitSet* pWaitSet = m_waitSets.allocate(
+            WaitSet{ pAction, static_cast< U32 >( events.size() ) + 1U, static_cast< U32 >( events.size() ), bWaitAny } );
+        for( const Event& ev : events )
+        {
+            eventIndex.insert( ev, pWaitSet );
+        }
+        pAction->getWaitSet()   = pWaitSet;
+        pAction->getWaitIndex() = &eventIndex;
     }
 
-    void event_remove( EventRefMap& eventMap, ActiveActionMapIter iterAction )
+    // O(1) - the remaining registrations are left in the index as stale
+    void event_remove( ActiveAction* pAction )
     {
-        for( typename EventRefMap::iterator i : iterAction->second->getEventIterArray() )
+        if( WaitSet* pWaitSet = pAction->getWaitSet() )
         {
-            eventMap.erase( i );
+            pAction->getWaitIndex()->addDead( pWaitSet->uiRemaining );
+            pWaitSet->pAction       = nullptr;
+            pAction->getWaitSet()   = nullptr;
+            pAction->getWaitIndex() = nullptr;
+            waitset_release( pWaitSet );
         }
-        iterAction->second->getEventIterArray().clear();
     }
 
-    void on_event( EventRefMap& eventMap, const Pointer& ref )
+    void event_compact( EventIndex& eventIndex )
     {
-        typename EventRefMap::iterator iLower = eventMap.lower_bound( ref );
-        typename EventRefMap::iterator iUpper = eventMap.upper_bound( ref );
-
-        for( typename EventRefMap::iterator iterEvent = iLower; iterEvent != iUpper; ++iterEvent )
+        if( eventIndex.needsCompact() )
         {
-            ActiveActionMapIter iter    = iterEvent->second;
-            ActiveAction*       pAction = iter->second;
-
-            for( typename EventRefMapIterArray::iterator i    = pAction->getEventIterArray().begin(),
-                                                         iEnd = pAction->getEventIterArray().end();
-                 i != iEnd; )
-            {
-                if( *i == iterEvent )
+            eventIndex.compact(
+                [ this ]( WaitSet* pWaitSet )
                 {
-                    i = pAction->getEventIterArray().erase( i );
-                    pAction->onEvent( ref );
-
-                    if( pAction->getEventIterArray().empty() || pAction->isWaitAny() )
+                    if( pWaitSet->pAction == nullptr )
                     {
-                        // activate the action
-                        event_remove( eventMap, iter );
-                        active_insert( iter );
+                        waitset_release( pWaitSet );
+                        return true;
                     }
-                    break;
-                }
-                else
-                {
-                    ++i;
-                }
-            }
+                    return false;
+                } );
         }
-        eventMap.erase( iLower, iUpper );
+    }
+
+    // events MUST be sorted and unique
+    void on_events( EventIndex& eventIndex, std::span< const Pointer > events )
+    {
+        eventIndex.match( events,
+                          [ this ]( const Pointer& ref, WaitSet* pWaitSet )
+                          {
+                              if( ActiveAction* pAction = pWaitSet->pAction )
+                              {
+                                  --pWaitSet->uiRemaining;
+                                  pAction->onEvent( ref );
+                                  if( ( pWaitSet->uiRemaining == 0U ) || pWaitSet->bWaitAny )
+                                  {
+                                      // activate the action
+                                      event_remove( pAction );
+                                      active_insert( pAction );
+                                  }
+                              }
+                              waitset_release( pWaitSet );
+                          } );
+        event_compact( eventIndex );
+    }
+
+    void on_event( const Pointer& ref )
+    {
+        const std::span< const Pointer > events( &ref, 1U );
+        on_events( m_events_by_ref_wait, events );
+        on_events( m_events_by_ref_sleep, events );
+    }
+
+    void destroy( ActiveAction* pAction )
+    {
+        list_remove( pAction );
+        timeout_remove( pAction );
+        event_remove( pAction );
+        m_pool.free( pAction );
     }
 
 public:
     ~BasicScheduler()
     {
-        for( auto& [ _, pAction ] : m_actions )
-        {
-            delete pAction;
-        }
+        m_actions.for_each( [ this ]( const Pointer&, ActiveAction* pAction ) { destroy( pAction ); } );
     }
 
     void call( ExecutionState&& executionState )
     {
-        const mega::runtime::Pointer ref = executionState.getRef();
+        const Pointer ref = executionState.getRef();
 
-        ActiveAction* pAction = new ActiveAction(
-            std::move( executionState ), m_listOne.end(), m_listTwo.end(), m_listThree.end(), m_paused.end() );
+        ActiveAction* pAction = m_pool.allocate( std::move( executionState ) );
 
-        auto insertResult = m_actions.insert( std::make_pair( ref, pAction ) );
-        if( insertResult.second )
+        if( m_actions.insert( ref, pAction ) )
         {
-            active_insert( insertResult.first );
+            active_insert( pAction );
         }
         else
         {
             ERR( "Scheduler::call failed type: " << ref );
-            delete pAction;
+            m_pool.free( pAction );
         }
     }
 
     void stop( const Pointer& ref )
     {
-        ActiveActionMapIter iFind = m_actions.find( ref );
-        if( iFind != m_actions.end() )
+        if( ActiveAction** ppFind = m_actions.find( ref ) )
         {
-            ActiveAction* pAction = iFind->second;
+            ActiveAction* pAction = *ppFind;
 
-            on_event( m_events_by_ref_wait, pAction->getRef() );
-            on_event( m_events_by_ref_sleep, pAction->getRef() );
+            on_event( pAction->getRef() );
 
-            active_remove( iFind );
-            wait_remove( iFind );
-            sleep_remove( iFind );
-            event_remove( m_events_by_ref_wait, iFind );
-            event_remove( m_events_by_ref_sleep, iFind );
-            m_actions.erase( iFind );
+            list_remove( pAction );
+            timeout_remove( pAction );
+            event_remove( pAction );
+            m_actions.erase( ref );
 
             // invoke the stopper - after removing
             pAction->stop();
@@ -481,7 +466,7 @@ public:
             if( m_pCurrentAction == pAction )
                 m_pCurrentAction = nullptr;
 
-            delete pAction;
+            m_pool.free( pAction );
         }
         else
         {
@@ -489,33 +474,64 @@ public:
         }
     }
 
-    void signal( const Pointer& ref )
+    void signal( const Pointer& ref ) { on_event( ref ); }
+
+    // sort the batch once and merge join it against both wait indices
+    void signal( std::span< const Pointer > events )
     {
-        on_event( m_events_by_ref_wait, ref );
-        on_event( m_events_by_ref_sleep, ref );
+        m_signalBatch.assign( events.begin(), events.end() );
+        std::sort( m_signalBatch.begin(), m_signalBatch.end(), PointerRaw::Less() );
+        m_signalBatch.erase( std::unique( m_signalBatch.begin(), m_signalBatch.end(), PointerRaw::Equal() ),
+                             m_signalBatch.end() );
+        on_events( m_events_by_ref_wait, m_signalBatch );
+        on_events( m_events_by_ref_sleep, m_signalBatch );
     }
 
-    bool active() const { return !m_actions.empty(); }
-    U64  size() const { return m_actions.size(); }
+    void pause( const Pointer& ref )
+    {
+        if( ActiveAction** ppFind = m_actions.find( ref ) )
+        {
+            ActiveAction* pAction = *ppFind;
+            timeout_remove( pAction );
+            event_remove( pAction );
+            pause_insert( pAction );
+        }
+        else
+        {
+            ERR( "Paused inactive Pointer" );
+        }
+    }
 
-    // run a cycle
-    void cycle()
+    void unpause( const Pointer& ref )
     {
-        // timeouts
-        while( !m_timeouts.empty() )
+        if( ActiveAction** ppFind = m_actions.find( ref ) )
         {
-            typename TimeoutQueue::iterator iterTimeout = m_timeouts.begin();
-            if( iterTimeout->first <= std::chrono::steady_clock::now() )
+            ActiveAction* pAction = *ppFind;
+            if( m_paused.owns( pAction ) )
             {
-                ActiveActionMapIter iter = iterTimeout->second;
-                timeout_remove( iter );
-                active_insert( iter );
-            }
-            else
-            {
-                break;
+                active_insert( pAction );
             }
         }
+        else
+        {
+            ERR( "Unpaused inactive Pointer" );
+        }
+    }
+
+    bool                      active() const { return !m_actions.empty(); }
+    U64                       size() const { return m_actions.size(); }
+    const runtime::TimeStamp& getCycle() const { return m_cycle; }
+
+    // run the next cycle
+    void cycle() { cycle( runtime::TimeStamp{ m_cycle.getValue() + 1U } ); }
+
+    // run a cycle at an explicit simulation timestamp i.e. when replaying
+    void cycle( const runtime::TimeStamp& timestamp )
+    {
+        m_cycle = timestamp;
+
+        // timeouts
+        timeout_expire();
 
         if( getActive().empty() && getWaiting().empty() )
         {
@@ -530,11 +546,11 @@ public:
                 swapActiveWait();
             }
 
-            ActiveActionMapIter iter = getActive().front();
-            active_remove( iter );
+            ActiveAction* pAction = getActive().front();
+            list_remove( pAction );
 
             // invoke the action
-            m_pCurrentAction = iter->second;
+            m_pCurrentAction = pAction;
 
             m_pCurrentAction->run();
 
@@ -545,40 +561,31 @@ public:
                 switch( reason.reason )
                 {
                     case eReason_Wait:
-                        wait_insert( iter );
+                        wait_insert( pAction );
                         break;
                     case eReason_Wait_All:
-                        for( Event ev : reason.events )
-                            event_insert( m_events_by_ref_wait, iter, ev );
-                        iter->second->setWaitAny( false );
+                        event_insert( m_events_by_ref_wait, pAction, reason.events, false );
                         break;
                     case eReason_Wait_Any:
-                        for( Event ev : reason.events )
-                            event_insert( m_events_by_ref_wait, iter, ev );
-                        iter->second->setWaitAny( true );
+                        event_insert( m_events_by_ref_wait, pAction, reason.events, true );
                         break;
                     case eReason_Sleep:
-                        sleep_insert( iter );
+                        sleep_insert( pAction );
                         break;
                     case eReason_Sleep_All:
-                        for( Event ev : reason.events )
-                            event_insert( m_events_by_ref_sleep, iter, ev );
-                        iter->second->setWaitAny( false );
+                        event_insert( m_events_by_ref_sleep, pAction, reason.events, false );
                         break;
                     case eReason_Sleep_Any:
-                        for( Event ev : reason.events )
-                            event_insert( m_events_by_ref_sleep, iter, ev );
-                        iter->second->setWaitAny( true );
+                        event_insert( m_events_by_ref_sleep, pAction, reason.events, true );
                         break;
                     case eReason_Timeout:
-                        timeout_insert( iter, reason.timeout.value() );
+                        timeout_insert( pAction, reason );
                         break;
                     case eReason_Complete:
-                        m_actions.erase( iter );
-                        on_event( m_events_by_ref_wait, m_pCurrentAction->getRef() );
-                        on_event( m_events_by_ref_sleep, m_pCurrentAction->getRef() );
-                        m_pCurrentAction->stop();
-                        delete m_pCurrentAction;
+                        m_actions.erase( pAction->getRef() );
+                        on_event( pAction->getRef() );
+                        pAction->stop();
+                        destroy( pAction );
                         break;
                     default:
                         ERR( "Unknown return reason" );
@@ -588,92 +595,37 @@ public:
             }
         }
 
-        while( !m_events_by_ref_wait.empty() )
-        {
-            typename EventRefMap::iterator i       = m_events_by_ref_wait.begin();
-            Pointer                      ref     = i->first;
-            ActiveAction*                  pAction = i->second->second;
-            // error
-            ERR( "Never got event: " << ref << " for action: " << pAction->getRef() );
-            stop( pAction->getRef() );
-        }
-    }
-
-    /*void allocated( const Pointer& ref )
-    {
-        ActiveAction* pAction
-            = new ActiveAction( ref, m_listOne.end(), m_listTwo.end(), m_listThree.end(), m_paused.end() );
-        auto insertResult = m_actions.insert( std::make_pair( ref, pAction ) );
-        if( !insertResult.second )
-        {
-            ERR( "Could not allocation action" );
-            delete pAction;
-        }
-    }*/
-    /*void stopperStopped( const Pointer& ref )
-    {
-        ActiveActionMapIter iFind = m_actions.find( ref );
-        if( iFind != m_actions.end() )
+        if( !m_events_by_ref_wait.empty() )
         {
-            ActiveAction* pAction = iFind->second;
-
-            on_event( m_events_by_ref_wait, pAction->getRef() );
-            on_event( m_events_by_ref_sleep, pAction->getRef() );
-
-            active_remove( iFind );
-            wait_remove( iFind );
-            sleep_remove( iFind );
-            event_remove( m_events_by_ref_wait, iFind );
-            event_remove( m_events_by_ref_sleep, iFind );
-            m_actions.erase( iFind );
-
-            // DO NOT invoke the stopper
+            EventVector stopped;
+            m_events_by_ref_wait.for_each(
+                [ &stopped ]( const Pointer& ref, WaitSet* pWaitSet )
+                {
+                    if( ActiveAction* pAction = pWaitSet->pAction )
+                    {
+                        // error
+                        ERR( "Never got event: " << ref << " for action: " << pAction->getRef() );
+                        stopped.push_back( pAction->getRef() );
+                    }
+                } );
+            std::sort( stopped.begin(), stopped.end(), PointerRaw::Less() );
+            stopped.erase( std::unique( stopped.begin(), stopped.end(), PointerRaw::Equal() ), stopped.end() );
 
-            if( m_pCurrentAction == pAction )
-                m_pCurrentAction = nullptr;
+            for( const Pointer& ref : stopped )
+            {
+                stop( ref );
+            }
 
-            delete pAction;
-        }
-        else
-        {
-            // TODO - need to analyse how stopperStopped is called...
-            // ERR( "Scheduler::stopperStopped with no active action for type: " << ref.type << " instance: " <<
-            // ref.instance << " timestamp: " << ref.timestamp );
-        }
-    }*/
-    /*void pause( const Pointer& ref )
-    {
-        ActiveActionMapIter iFind = m_actions.find( ref );
-        if( iFind != m_actions.end() )
-        {
-            active_remove( iFind );
-            wait_remove( iFind );
-            sleep_remove( iFind );
-            event_remove( m_events_by_ref_wait, iFind );
-            event_remove( m_events_by_ref_sleep, iFind );
-            pause_insert( iFind );
-        }
-        else
-        {
-            ERR( "Stopped inactive Pointer" );
+            // everything left is stale
+            m_events_by_ref_wait.compact( [ this ]( WaitSet* pWaitSet )
+                                          {
+                                              waitset_release( pWaitSet );
+                                              return true;
+                                          } );
         }
     }
-
-    void unpause( const Pointer& ref )
-    {
-        ActiveActionMapIter iFind = m_actions.find( ref );
-        if( iFind != m_actions.end() )
-        {
-            pause_remove( iFind );
-            active_insert( iFind );
-        }
-        else
-        {
-            ERR( "Stopped inactive Pointer" );
-        }
-    }*/
 };
 
 } // namespace mega
 
-#endif // GUARD_2023_August_01_BasicScheduler-1
+#endif // GUARD_2023_August_01_BasicScheduler
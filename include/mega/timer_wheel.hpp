@@ -0,0 +1,215 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_timer_wheel
+#define GUARD_2026_October_18_timer_wheel
+
+#include "mega/values/native_types.hpp"
+#include "mega/intrusive_list.hpp"
+
+#include <array>
+
+namespace mega
+{
+
+// Hierarchical timing wheel over an abstract U64 tick.
+// Timers are placed at the level of the highest radix digit in which their
+// expiry differs from the current tick and are cascaded down a level each
+// time the lower digits wrap.  Insert and cancel are O(1) and never allocate.
+// advance() expires every timer up to a tick in one batch, skipping over runs
+// of empty levels so large jumps in time do not cost one step per tick.
+template < typename T, typename Tag >
+class TimerWheel
+{
+public:
+    using List = IntrusiveList< T, Tag >;
+
+    struct Hook : public List::Hook
+    {
+        U64 m_timerExpiry = 0U;
+    };
+
+    static constexpr U64 BITS   = 8U;
+    static constexpr U64 SLOTS  = 1U << BITS;
+    static constexpr U64 MASK   = SLOTS - 1U;
+    static constexpr U64 LEVELS = 4U;
+
+    explicit TimerWheel( U64 now = 0U )
+        : m_now( now )
+    {
+        m_levelCount.fill( 0U );
+    }
+
+    TimerWheel( const TimerWheel& )            = delete;
+    TimerWheel& operator=( const TimerWheel& ) = delete;
+
+    inline U64  now() const { return m_now; }
+    inline U64  size() const { return m_size; }
+    inline bool empty() const { return m_size == 0U; }
+
+    // timers that are already due expire on the next advance
+    inline void insert( T* pNode, U64 expiry )
+    {
+        static_cast< Hook* >( pNode )->m_timerExpiry = expiry;
+        place( pNode );
+        ++m_size;
+    }
+
+    // returns false if the node is not linked into this wheel
+    inline bool cancel( T* pNode )
+    {
+        List* pOwner = static_cast< Hook* >( pNode )->m_pOwner;
+        if( pOwner == nullptr )
+        {
+            return false;
+        }
+        const List* pSlots = &m_slots[ 0U ][ 0U ];
+        if( ( pOwner >= pSlots ) && ( pOwner < pSlots + LEVELS * SLOTS ) )
+        {
+            --m_levelCount[ static_cast< U64 >( pOwner - pSlots ) / SLOTS ];
+        }
+        else if( ( pOwner != &m_due ) && ( pOwner != &m_overflow ) )
+        {
+            return false;
+        }
+        pOwner->erase( pNode );
+        --m_size;
+        return true;
+    }
+
+    // expire all timers with expiry <= target invoking onExpired( T* ) for each
+    // after it has been unlinked.  The functor may insert or cancel timers.
+    template < typename Functor >
+    void advance( U64 target, Functor&& onExpired )
+    {
+        drain( onExpired );
+        while( m_now < target )
+        {
+            if( m_size == 0U )
+            {
+                m_now = target;
+                break;
+            }
+
+            // jump to the next boundary of the lowest non-empty level
+            U64 next = m_now + 1U;
+            for( U64 level = 0U; ( level != LEVELS ) && ( m_levelCount[ level ] == 0U ); ++level )
+            {
+                const U64 shift = BITS * ( level + 1U );
+                next            = ( ( m_now >> shift ) + 1U ) << shift;
+            }
+            if( next > target )
+            {
+                m_now = target;
+                break;
+            }
+
+            m_now = next;
+            tick();
+            drain( onExpired );
+        }
+    }
+
+private:
+    inline void place( T* pNode )
+    {
+        const U64 expiry = static_cast< Hook* >( pNode )->m_timerExpiry;
+        if( expiry <= m_now )
+        {
+            m_due.push_back( pNode );
+            return;
+        }
+
+        // level is the highest radix digit in which expiry and now differ
+        const U64 diff  = expiry ^ m_now;
+        U64       level = 0U;
+        while( ( level != LEVELS ) && ( ( diff >> ( BITS * ( level + 1U ) ) ) != 0U ) )
+        {
+            ++level;
+        }
+
+        if( level == LEVELS )
+        {
+            m_overflow.push_back( pNode );
+        }
+        else
+        {
+            m_slots[ level ][ ( expiry >> ( BITS * level ) ) & MASK ].push_back( pNode );
+            ++m_levelCount[ level ];
+        }
+    }
+
+    inline void cascade( List& list, U64 level )
+    {
+        // overflow timers can be placed straight back into the overflow list
+        for( std::size_t count = list.size(); count != 0U; --count )
+        {
+            T* pNode = list.front();
+            list.erase( pNode );
+            if( level != LEVELS )
+            {
+                --m_levelCount[ level ];
+            }
+            place( pNode );
+        }
+    }
+
+    inline void tick()
+    {
+        // cascade from the top down so timers can fall through several levels on one tick
+        if( ( m_now & ( ( U64{ 1U } << ( BITS * LEVELS ) ) - 1U ) ) == 0U )
+        {
+            cascade( m_overflow, LEVELS );
+        }
+        for( U64 level = LEVELS - 1U; level != 0U; --level )
+        {
+            if( ( m_now & ( ( U64{ 1U } << ( BITS * level ) ) - 1U ) ) == 0U )
+            {
+                cascade( m_slots[ level ][ ( m_now >> ( BITS * level ) ) & MASK ], level );
+            }
+        }
+        cascade( m_slots[ 0U ][ m_now & MASK ], 0U );
+    }
+
+    template < typename Functor >
+    inline void drain( Functor& onExpired )
+    {
+        while( !m_due.empty() )
+        {
+            T* pNode = m_due.front();
+            m_due.erase( pNode );
+            --m_size;
+            onExpired( pNode );
+        }
+    }
+
+    using LevelSlots = std::array< List, SLOTS >;
+
+    std::array< LevelSlots, LEVELS > m_slots;
+    std::array< U64, LEVELS >        m_levelCount;
+    List                             m_due;
+    List                             m_overflow;
+    U64                              m_now;
+    U64                              m_size = 0U;
+};
+
+} // namespace mega
+
+#endif // GUARD_2026_October_18_timer_wheel
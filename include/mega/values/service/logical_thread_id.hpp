@@ -28,6 +28,7 @@
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/serialization/array_wrapper.hpp>
 
+#include <cstring>
 #include <string>
 #include <ostream>
 #include <istream>
@@ -83,6 +84,14 @@ public:
         }
     };
 
+    // uuids are random so the leading bytes are already a well distributed hash
+    inline mega::U64 getRandomBits() const
+    {
+        mega::U64 bits;
+        std::memcpy( &bits, m_uuid.data, sizeof( bits ) );
+        return bits;
+    }
+
     inline std::string toStr() const { return boost::uuids::to_string( m_uuid ); }
 
     inline bool operator==( const LogicalThreadID& right ) const { return m_uuid == right.m_uuid; }
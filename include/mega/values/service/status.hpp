@@ -29,6 +29,7 @@
 #include "event/index_record.hpp"
 
 #include <utility>
+#include <string>
 #include <vector>
 #include <ostream>
 #include <optional>
@@ -105,6 +106,8 @@ struct JITStatus
         archive& m_invocations;
         archive& m_operators;
         archive& m_decisions;
+        archive& m_objectCacheHits;
+        archive& m_objectCacheMisses;
     }
 
     U64 m_functionPointers = 0;
@@ -114,9 +117,44 @@ struct JITStatus
     U64 m_operators        = 0;
     U64 m_decisions        = 0;
 
+    U64 m_objectCacheHits   = 0;
+    U64 m_objectCacheMisses = 0;
+
     ComponentMgrStatus m_componentManagerStatus;
 };
 
+struct DispatchStatus
+{
+    template < class Archive >
+    inline void serialize( Archive& archive, const unsigned int )
+    {
+        archive& m_messages;
+    }
+
+    // latency histogram bucket i counts requests taking [ 2^i, 2^(i+1) ) microseconds
+    static constexpr U64 HistogramBuckets = 16;
+
+    struct MessageStatus
+    {
+        template < class Archive >
+        inline void serialize( Archive& archive, const unsigned int )
+        {
+            archive& name;
+            archive& count;
+            archive& totalMicroseconds;
+            archive& maxMicroseconds;
+            archive& histogram;
+        }
+        std::string        name;
+        U64                count             = 0;
+        U64                totalMicroseconds = 0;
+        U64                maxMicroseconds   = 0;
+        std::vector< U64 > histogram;
+    };
+    using MessageStatusArray = std::vector< MessageStatus >;
+    MessageStatusArray m_messages;
+};
+
 class Status
 {
     // convert to MPO for comparison only
@@ -160,15 +198,17 @@ public:
                    []( const Status& left, const Status& right ) -> bool { return left.toMPO() < right.toMPO(); } );
     }
 
-    const std::optional< runtime::MachineID >&     getMachineID() const { return m_machineID; }
-    const std::optional< runtime::MP >&            getMP() const { return m_mp; }
-    const std::optional< runtime::MPO >&           getMPO() const { return m_mpo; }
-    const std::vector< network::LogicalThreadID >& getLogicalThreads() const { return m_logicalthreadIDs; }
-    const std::optional< event::IndexRecord >&     getLogIterator() const { return m_logIterator; }
-    const std::optional< std::string >&            getLogFolder() const { return m_strLogFolder; }
-    const std::optional< std::string >&            getLogFile() const { return m_strLogFile; }
-    const std::optional< service::Program >&       getProgram() const { return m_program; }
-    const std::optional< network::MemoryStatus >&  getMemory() const { return m_memory; }
+    const std::optional< runtime::MachineID >&      getMachineID() const { return m_machineID; }
+    const std::optional< runtime::MP >&             getMP() const { return m_mp; }
+    const std::optional< runtime::MPO >&            getMPO() const { return m_mpo; }
+    const std::vector< network::LogicalThreadID >&  getLogicalThreads() const { return m_logicalthreadIDs; }
+    const std::optional< event::IndexRecord >&      getLogIterator() const { return m_logIterator; }
+    const std::optional< std::string >&             getLogFolder() const { return m_strLogFolder; }
+    const std::optional< std::string >&             getLogFile() const { return m_strLogFile; }
+    const std::optional< service::Program >&        getProgram() const { return m_program; }
+    const std::optional< network::MemoryStatus >&   getMemory() const { return m_memory; }
+    const std::optional< network::JITStatus >&      getJIT() const { return m_jit; }
+    const std::optional< network::DispatchStatus >& getDispatch() const { return m_dispatch; }
 
     const std::optional< std::vector< std::pair< runtime::MPO, runtime::TimeStamp > > >& getReads() const
     {
@@ -196,6 +236,8 @@ public:
     void setLogFolder( const std::string& strLogFolder ) { m_strLogFolder = strLogFolder; }
     void setLogFile( const std::string& strLogFile ) { m_strLogFile = strLogFile; }
     void setMemory( network::MemoryStatus memoryStatus ) { m_memory = memoryStatus; }
+    void setJIT( network::JITStatus jitStatus ) { m_jit = jitStatus; }
+    void setDispatch( network::DispatchStatus dispatchStatus ) { m_dispatch = std::move( dispatchStatus ); }
 
     void setReads( const std::optional< std::vector< std::pair< runtime::MPO, runtime::TimeStamp > > >& value )
     {
@@ -222,6 +264,8 @@ public:
         archive& m_strLogFile;
         archive& m_program;
         archive& m_memory;
+        archive& m_jit;
+        archive& m_dispatch;
 
         archive& m_reads;
         archive& m_writes;
@@ -233,15 +277,17 @@ public:
     }
 
 private:
-    std::optional< runtime::MachineID >     m_machineID;
-    std::optional< runtime::MP >            m_mp;
-    std::optional< runtime::MPO >           m_mpo;
-    std::vector< network::LogicalThreadID > m_logicalthreadIDs;
-    std::optional< event::IndexRecord >     m_logIterator;
-    std::optional< std::string >            m_strLogFolder;
-    std::optional< std::string >            m_strLogFile;
-    std::optional< service::Program >       m_program;
-    std::optional< network::MemoryStatus >  m_memory;
+    std::optional< runtime::MachineID >      m_machineID;
+    std::optional< runtime::MP >             m_mp;
+    std::optional< runtime::MPO >            m_mpo;
+    std::vector< network::LogicalThreadID >  m_logicalthreadIDs;
+    std::optional< event::IndexRecord >      m_logIterator;
+    std::optional< std::string >             m_strLogFolder;
+    std::optional< std::string >             m_strLogFile;
+    std::optional< service::Program >        m_program;
+    std::optional< network::MemoryStatus >   m_memory;
+    std::optional< network::JITStatus >      m_jit;
+    std::optional< network::DispatchStatus > m_dispatch;
 
     std::optional< std::vector< std::pair< runtime::MPO, runtime::TimeStamp > > > m_reads;
     std::optional< std::vector< std::pair< runtime::MPO, runtime::TimeStamp > > > m_writes;
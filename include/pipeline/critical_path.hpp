@@ -0,0 +1,124 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_critical_path
+#define GUARD_2026_October_18_critical_path
+
+#include "pipeline.hpp"
+
+#include "mega/values/native_types.hpp"
+
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <chrono>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mega::pipeline
+{
+
+// Measured task durations from previous builds keyed by task name and source file
+// since the task buffer can change between builds while the task remains the same.
+class TaskDurations
+{
+public:
+    using Duration = std::chrono::microseconds;
+
+    void clear() { m_durations.clear(); }
+    bool empty() const { return m_durations.empty(); }
+
+    void                      record( const TaskDescriptor& task, Duration duration );
+    std::optional< Duration > get( const TaskDescriptor& task ) const;
+
+    // the recorded duration or else the mean of the same named task or else the mean of all tasks
+    Duration estimate( const TaskDescriptor& task ) const;
+
+    template < typename Archive >
+    void save( Archive& archive, const unsigned int ) const
+    {
+        std::vector< Entry > entries;
+        for( const auto& [ key, uiMicroseconds ] : m_durations )
+        {
+            entries.push_back( Entry{ key.first, key.second, uiMicroseconds } );
+        }
+        archive& boost::serialization::make_nvp( "TaskDurations", entries );
+    }
+
+    template < typename Archive >
+    void load( Archive& archive, const unsigned int )
+    {
+        std::vector< Entry > entries;
+        archive&             boost::serialization::make_nvp( "TaskDurations", entries );
+        m_durations.clear();
+        for( const Entry& entry : entries )
+        {
+            m_durations.insert( { { entry.strName, entry.strSourceFile }, entry.uiMicroseconds } );
+        }
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+private:
+    struct Entry
+    {
+        std::string strName, strSourceFile;
+        U64         uiMicroseconds = 0U;
+
+        template < typename Archive >
+        void serialize( Archive& archive, const unsigned int )
+        {
+            archive& boost::serialization::make_nvp( "Name", strName );
+            archive& boost::serialization::make_nvp( "Source", strSourceFile );
+            archive& boost::serialization::make_nvp( "Microseconds", uiMicroseconds );
+        }
+    };
+
+    using Key = std::pair< std::string, std::string >;
+    std::map< Key, U64 > m_durations;
+};
+
+// Longest path from each task through its dependents to the end of the build.
+// Ranking ready tasks by their remaining path starts the critical chain first.
+class CriticalPath
+{
+public:
+    using Duration = TaskDurations::Duration;
+
+    CriticalPath( const Dependencies& dependencies, const TaskDurations& durations );
+
+    // duration of the task plus the longest chain of dependents after it
+    Duration getRemaining( const TaskDescriptor& task ) const;
+    // longest chain through the whole graph
+    Duration getLength() const { return m_length; }
+
+private:
+    std::map< TaskDescriptor, Duration > m_remaining;
+    Duration                             m_length{ 0 };
+};
+
+} // namespace mega::pipeline
+
+#endif // GUARD_2026_October_18_critical_path
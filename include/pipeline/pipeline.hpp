@@ -31,6 +31,7 @@
 #include <boost/config.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <functional>
 #include <optional>
 #include <string>
 #include <memory>
@@ -61,24 +62,43 @@ private:
     Graph   m_graph;
 };
 
+// Tracks readiness with a count of incomplete dependencies per task so completing a task
+// only visits its dependents rather than rescanning the whole graph.
+// Early cutoff candidates only read outputs of the tasks upstream of them so when none of
+// those tasks changed their outputs the candidate is completed as skipped without running.
 class Schedule
 {
 public:
     Schedule( const Dependencies& dependencies );
 
+    // tasks whose dependencies are complete including those already taken
     TaskDescriptor::Vector          getReady() const;
+    // tasks that became ready since the last call
+    TaskDescriptor::Vector          takeReady();
     std::vector< TaskDescriptor >   getTasks( const std::string& strTaskName ) const;
     std::optional< TaskDescriptor > getTask( const std::string& strTaskName ) const;
     std::optional< TaskDescriptor > getTask( const std::string& strTaskName, const std::string& strSourceFile ) const;
     Schedule                        getUpTo( const std::string& strTaskName, bool bInclusive ) const;
     Schedule getUpTo( const std::string& strTaskName, const std::string& strSourceFile, bool bInclusive ) const;
-    bool     isComplete() const { return m_dependencies.getTasks() == m_complete; }
+    bool     isComplete() const { return m_dependencies.getTasks().size() == m_complete.size(); }
+    const Dependencies& getDependencies() const { return m_dependencies; }
 
-    void complete( const TaskDescriptor& task ) { m_complete.insert( task ); }
+    void                         setEarlyCutoff( const Dependencies::TaskSet& candidates );
+    const Dependencies::TaskSet& getSkipped() const { return m_skipped; }
+
+    void complete( const TaskDescriptor& task, bool bOutputsChanged = true );
 
 private:
+    bool canSkip( const TaskDescriptor& task ) const;
+
+    using InDegreeMap = std::map< TaskDescriptor, std::size_t >;
+
     Dependencies          m_dependencies;
-    Dependencies::TaskSet m_complete;
+    Dependencies::Graph   m_dependents;
+    InDegreeMap           m_inDegree;
+    Dependencies::TaskSet m_ready, m_taken, m_complete;
+    // m_tainted holds completed tasks that changed their outputs or have such a task upstream
+    Dependencies::TaskSet m_cutoffCandidates, m_tainted, m_skipped;
 };
 
 class Progress
@@ -138,13 +158,22 @@ public:
                                       std::ostream& osLog );
 };
 
+// Executes every task in the schedule using uiWorkers threads including the calling thread.
+// Workers take tasks from a ready queue fed as tasks complete. Returns false once any task
+// fails, after the tasks already running have finished, or if the schedule cannot progress.
+// outputsChanged is called on the same worker after a task succeeds and enables early cutoff
+// when it reports the task produced the same outputs as the previous build.
+bool executeSchedule( Schedule& schedule, U32 uiWorkers,
+                      const std::function< bool( const TaskDescriptor& ) >& executeTask,
+                      const std::function< bool( const TaskDescriptor& ) >& outputsChanged = {} );
+
 PipelineResult runPipelineLocally( const boost::filesystem::path&           stashDir,
                                    std::optional< boost::filesystem::path > symbolFile,
                                    const mega::utilities::ToolChain&        toolChain,
                                    const mega::pipeline::Configuration& pipelineConfig, const std::string& strTaskName,
                                    const std::string&             strSourceFile,
                                    const boost::filesystem::path& inputPipelineResultPath, bool bForceNoStash,
-                                   bool bExecuteUpTo, bool bInclusive, std::ostream& osLog );
+                                   bool bExecuteUpTo, bool bInclusive, std::ostream& osLog, U32 uiWorkers = 1U );
 
 } // namespace mega::pipeline
 
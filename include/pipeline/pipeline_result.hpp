@@ -26,6 +26,7 @@
 
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/split_member.hpp>
+#include <boost/serialization/version.hpp>
 
 #include <string>
 #include <map>
@@ -40,16 +41,20 @@ public:
 
     PipelineResult() = default;
 
-    PipelineResult( bool bSuccess, const std::string& strMsg, const BuildHashCodeMap& buildHashCodes )
+    PipelineResult( bool bSuccess, const std::string& strMsg, const BuildHashCodeMap& buildHashCodes,
+                    const std::string& strToolChainHash = std::string{} )
         : m_bSuccess( bSuccess )
         , m_strMsg( strMsg )
         , m_buildHashCodes( buildHashCodes )
+        , m_strToolChainHash( strToolChainHash )
     {
     }
 
     bool                    getSuccess() const { return m_bSuccess; }
     std::string             getMessage() const { return m_strMsg; }
     const BuildHashCodeMap& getBuildHashCodes() const { return m_buildHashCodes; }
+    // the tool chain that produced the build hash codes or empty when unknown
+    const std::string& getToolChainHash() const { return m_strToolChainHash; }
 
     template < typename Archive >
     void save( Archive& archive, const unsigned int ) const
@@ -63,10 +68,11 @@ public:
             buildHashCodes.push_back( BuildHashCode{ filePath, fileHash } );
         }
         archive& boost::serialization::make_nvp( "BuildHashCodes", buildHashCodes );
+        archive& boost::serialization::make_nvp( "ToolChainHash", m_strToolChainHash );
     }
 
     template < typename Archive >
-    void load( Archive& archive, const unsigned int )
+    void load( Archive& archive, const unsigned int version )
     {
         archive& boost::serialization::make_nvp( "Success", m_bSuccess );
         archive& boost::serialization::make_nvp( "Message", m_strMsg );
@@ -77,6 +83,11 @@ public:
         {
             m_buildHashCodes.insert( { buildHashCode.m_filePath, buildHashCode.m_fileHashCode } );
         }
+        // results from before the tool chain hash was recorded leave it empty
+        if( version > 0 )
+        {
+            archive& boost::serialization::make_nvp( "ToolChainHash", m_strToolChainHash );
+        }
     }
 
     BOOST_SERIALIZATION_SPLIT_MEMBER()
@@ -84,7 +95,10 @@ public:
     bool             m_bSuccess;
     std::string      m_strMsg;
     BuildHashCodeMap m_buildHashCodes;
+    std::string      m_strToolChainHash;
 };
 } // namespace mega::pipeline
 
+BOOST_CLASS_VERSION( mega::pipeline::PipelineResult, 1 )
+
 #endif // GUARD_2023_January_21_pipeline_result
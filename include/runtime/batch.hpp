@@ -0,0 +1,53 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_batch
+#define GUARD_2026_October_18_batch
+
+#include "mega/values/native_types.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace mega::runtime
+{
+// functions are only split across concurrent clang invocations beyond this many per batch
+static constexpr U64 MIN_BATCH_SIZE = 16;
+
+// contiguous [begin,end) ranges so the partition is stable across runs for the object cache
+inline std::vector< std::pair< U64, U64 > > partitionBatches( U64 uiFunctions, U64 uiThreads )
+{
+    std::vector< std::pair< U64, U64 > > batches;
+    if( uiFunctions != 0U )
+    {
+        const U64 uiBatches   = std::clamp< U64 >( uiFunctions / MIN_BATCH_SIZE, 1U, std::max< U64 >( 1U, uiThreads ) );
+        const U64 uiBatchSize = ( uiFunctions + uiBatches - 1U ) / uiBatches;
+        for( U64 uiBegin = 0U; uiBegin < uiFunctions; uiBegin += uiBatchSize )
+        {
+            batches.emplace_back( uiBegin, std::min< U64 >( uiBegin + uiBatchSize, uiFunctions ) );
+        }
+    }
+    return batches;
+}
+
+} // namespace mega::runtime
+
+#endif // GUARD_2026_October_18_batch
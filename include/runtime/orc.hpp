@@ -23,6 +23,9 @@
 #include "runtime/functor_id.hxx"
 
 #include "mega/values/compilation/megastructure_installation.hpp"
+#include "mega/values/native_types.hpp"
+
+#include <boost/filesystem/path.hpp>
 
 #include <memory>
 #include <set>
@@ -36,6 +39,14 @@ class Orc
 public:
     Orc( const mega::MegastructureInstallation& megastructureInstallation );
 
+    // eQuick modules are generated fast without IR optimisation and count their invocations
+    // eOptimised modules run the full O3 pipeline with aggressive code generation
+    enum Tier
+    {
+        eQuick,
+        eOptimised
+    };
+
     class Module
     {
     protected:
@@ -43,6 +54,8 @@ public:
         virtual ~Module() = 0;
 
         virtual void* getRawFunctionPtr( const std::string& strSymbol ) = 0;
+        virtual U64*  getRawInvocationCounter( const std::string& strSymbol ) = 0;
+        virtual U64*  getRawActiveCounter( const std::string& strSymbol ) = 0;
     public:
         using Ptr = std::shared_ptr< Module >;
 
@@ -50,10 +63,28 @@ public:
         {
             return getRawFunctionPtr( functionID.getSymbol() );
         }
+
+        // nullptr for eOptimised modules
+        inline U64* getInvocationCounter( const FunctorID& functionID )
+        {
+            return getRawInvocationCounter( functionID.getSymbol() );
+        }
+
+        // number of calls currently executing the function - nullptr for eOptimised modules
+        inline U64* getActiveCounter( const FunctorID& functionID )
+        {
+            return getRawActiveCounter( functionID.getSymbol() );
+        }
     };
  
     Module::Ptr compile( const std::string& strModule );
 
+    // compile the IR module and write the resulting relocatable object to objectFilePath
+    Module::Ptr compile( const std::string& strModule, const boost::filesystem::path& objectFilePath, Tier tier );
+
+    // link a previously cached relocatable object directly - no IR parse or codegen
+    Module::Ptr load( const boost::filesystem::path& objectFilePath, Tier tier );
+
 private:
     void unload( Module* pModule );
 
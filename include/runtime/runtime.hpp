@@ -33,41 +33,120 @@
 #include "mega/values/service/program.hpp"
 #include "mega/values/compilation/megastructure_installation.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace mega::runtime
 {
 
 class Runtime : public FunctionProvider
 {
+    // what is needed to recompile a module at Orc::eOptimised once any of its functions are hot
+    struct ModuleSource
+    {
+        std::vector< FunctorID > functorIDs;
+        boost::filesystem::path  irFilePath;
+        boost::filesystem::path  optimisedObjectFilePath;
+    };
+
     struct FunctionInfo
     {
         using FunctionPtrVector = std::vector< void** >;
-        void*             pFunction;
-        Orc::Module::Ptr  pModule;
-        FunctionPtrVector functionPointers;
+        void*                                 pFunction;
+        Orc::Module::Ptr                      pModule;
+        FunctionPtrVector                     functionPointers;
+        Orc::Tier                             tier         = Orc::eQuick;
+        U64*                                  pInvocations = nullptr;
+        U64*                                  pActive      = nullptr;
+        std::shared_ptr< const ModuleSource > pSource;
+    };
+
+    // a quick module replaced by its optimised code that may still be executing
+    struct RetiredModule
+    {
+        Orc::Module::Ptr    pModule;
+        std::vector< U64* > invocations;
+        std::vector< U64* > active;
+        std::vector< U64 >  lastInvocations;
+    };
+    using FunctionMap  = std::unordered_map< FunctorID, FunctionInfo, FunctorID::Hash >;
+    using FunctorIDSet = std::unordered_set< FunctorID, FunctorID::Hash >;
+
+    // a single translation unit, clang invocation and ORC module for one or more functions
+    struct Batch
+    {
+        std::vector< FunctorID > functorIDs;
+        std::string              strCPPCode;
+        std::string              strName;
+        U64                      uiDeterminant = 0U;
+        boost::filesystem::path  objectFilePath;
+        boost::filesystem::path  irFilePath;
+        std::future< void >      compilation;
+        Orc::Module::Ptr         pModule;
+        Orc::Tier                tier = Orc::eQuick;
     };
-    using FunctionMap = std::unordered_map< FunctorID, FunctionInfo, FunctorID::Hash >;
 
 public:
+    struct ObjectCacheStats
+    {
+        U64 hits   = 0U;
+        U64 misses = 0U;
+    };
+
     Runtime( const boost::filesystem::path& tempDir, const MegastructureInstallation& megaInstall );
 
     void             loadProgram( const service::Program& program );
     void             unloadProgram();
     service::Program getProgram() const;
+    ObjectCacheStats getObjectCacheStats() const
+    {
+        return ObjectCacheStats{ m_uiObjectCacheHits.load( std::memory_order_relaxed ),
+                                 m_uiObjectCacheMisses.load( std::memory_order_relaxed ) };
+    }
 
     // FunctionProvider
     virtual void getFunction( service::StashProvider& stashProvider, const FunctorID& functionID,
                               void** ppFunction ) override;
 
 private:
+    // materialise all functions at once into as few modules as possible compiling them concurrently
+    void materialise( service::StashProvider& stashProvider, const std::vector< FunctorID >& functorIDs );
+    void promoteHotFunctions( std::stop_token stopToken );
+    void reclaimRetiredModules( std::unique_lock< std::mutex >& lock );
+
+    void                    compile( service::StashProvider& stashProvider, std::vector< Batch >& batches );
+    boost::filesystem::path getManifestFilePath() const;
+    void                    appendManifest( const std::vector< FunctorID >& functorIDs );
+    void                    resetManifest();
+    std::vector< FunctorID > loadManifest() const;
+
     boost::filesystem::path        m_tempDir;
+    boost::filesystem::path        m_objectCacheDir;
+    std::string                    m_strToolchainHash;
+    // atomic since status requests read them while compile holds m_mutex
+    std::atomic< U64 >             m_uiObjectCacheHits{ 0U };
+    std::atomic< U64 >             m_uiObjectCacheMisses{ 0U };
     Clang                          m_clang;
     service::Program               m_program;
     std::unique_ptr< JITDatabase > m_pDatabase;
     FunctionMap                    m_materialisedFunctions;
+    std::vector< FunctorID >       m_prefetchFunctions;
+    FunctorIDSet                   m_manifestFunctions;
     il::Factory                    m_materialisedFunctionFactory;
     Orc                            m_orc;
+
+    // m_mutex guards m_materialisedFunctions against the tiering thread
+    std::mutex                                m_mutex;
+    std::condition_variable_any               m_tierCondition;
+    std::unordered_set< const ModuleSource* > m_promotedSources;
+    std::vector< RetiredModule >              m_retiredModules;
+    std::jthread                              m_tierThread;
 };
 
 } // namespace mega::runtime
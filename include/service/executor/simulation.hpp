@@ -61,6 +61,7 @@ public:
     virtual network::enrole::Request_Encoder getRootEnroleRequest() override;
     virtual network::stash::Request_Encoder  getRootStashRequest() override;
     virtual network::memory::Request_Encoder getDaemonMemoryRequest() override;
+    virtual network::sim::Request_Encoder    getDaemonSimRequest() override;
     virtual network::sim::Request_Encoder    getMPOSimRequest( runtime::MPO mpo ) override;
     virtual network::memory::Request_Sender  getLeafMemoryRequest() override;
     virtual network::jit::Request_Sender     getLeafJITRequest() override;
@@ -79,6 +80,9 @@ public:
                                          const runtime::MPO&,
                                          const network::Transaction&,
                                          boost::asio::yield_context& ) override;
+    virtual void         SimLeaseInvalidate( const runtime::MPO&,
+                                             const std::vector< runtime::MPO >&,
+                                             boost::asio::yield_context& ) override;
     virtual runtime::MPO SimCreate( boost::asio::yield_context& ) override;
     virtual void         SimDestroy( boost::asio::yield_context& ) override;
     virtual void         SimDestroyBlocking( boost::asio::yield_context& ) override;
@@ -98,6 +102,7 @@ public:
 
 private:
     void runSimulation( boost::asio::yield_context& yield_ctx );
+    void invalidateLeases();
 
     friend class TransactionMachine< Simulation >;
     // Simulation concept for state machine
@@ -129,6 +134,7 @@ private:
     std::optional< network::ReceivedMessage > m_simCreateMsgOpt;
     bool                                      m_bShuttingDown = false;
     std::optional< MsgTraits::Msg >           m_blockDestroyMsgOpt;
+    LeaseHolders                              m_leaseHolders;
 };
 
 } // namespace mega::service
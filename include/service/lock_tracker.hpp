@@ -21,8 +21,11 @@
 #define LOCK_TRACKER_SEPT_19_2022
 
 #include "mega/values/runtime/mpo.hpp"
+#include "mega/values/runtime/timestamp.hpp"
 
 #include <map>
+#include <set>
+#include <vector>
 
 namespace mega::service
 {
@@ -72,9 +75,25 @@ public:
     void onWrite( runtime::MPO mpo, runtime::TimeStamp lockCycle )
     {
         m_reads.erase( mpo );
+        m_leases.erase( mpo );
         m_writes.insert( { mpo, lockCycle } );
     }
 
+    // a lease keeps a read of another mpo valid across cycles until its owner invalidates it
+    runtime::TimeStamp isLeased( runtime::MPO mpo ) const
+    {
+        auto iFind = m_leases.find( mpo );
+        if( iFind != m_leases.end() )
+        {
+            return iFind->second;
+        }
+        return {};
+    }
+
+    void onLease( runtime::MPO mpo, runtime::TimeStamp lockCycle ) { m_leases.insert_or_assign( mpo, lockCycle ); }
+
+    void onInvalidate( runtime::MPO mpo ) { m_leases.erase( mpo ); }
+
     void onRelease( runtime::MPO mpo )
     {
         m_reads.erase( mpo );
@@ -83,7 +102,9 @@ public:
 
     const MPOLockMap& getReads() const { return m_reads; }
     const MPOLockMap& getWrites() const { return m_writes; }
+    const MPOLockMap& getLeases() const { return m_leases; }
 
+    // leases outlive the cycle
     void reset()
     {
         m_reads.clear();
@@ -91,7 +112,33 @@ public:
     }
 
 private:
-    MPOLockMap m_reads, m_writes;
+    MPOLockMap m_reads, m_writes, m_leases;
+};
+
+// the readers holding a lease on an mpo - kept by the simulation that owns it
+class LeaseHolders
+{
+public:
+    using MPOVector = std::vector< runtime::MPO >;
+
+    bool empty() const { return m_holders.empty(); }
+
+    // every read grants a lease that lasts until the owner next changes
+    void onRead( runtime::MPO reader ) { m_holders.insert( reader ); }
+
+    // the writer drops its own lease when granted the write
+    void onWrite( runtime::MPO writer ) { m_holders.erase( writer ); }
+
+    // takes the holders to invalidate - a read granted after this starts a new lease
+    MPOVector invalidate()
+    {
+        MPOVector holders{ m_holders.begin(), m_holders.end() };
+        m_holders.clear();
+        return holders;
+    }
+
+private:
+    std::set< runtime::MPO > m_holders;
 };
 } // namespace mega::service
 
@@ -79,6 +79,7 @@ public:
     virtual network::enrole::Request_Encoder getRootEnroleRequest()               = 0;
     virtual network::stash::Request_Encoder  getRootStashRequest()                = 0;
     virtual network::memory::Request_Encoder getDaemonMemoryRequest()             = 0;
+    virtual network::sim::Request_Encoder    getDaemonSimRequest()                = 0;
     virtual network::sim::Request_Encoder    getMPOSimRequest( runtime::MPO mpo ) = 0;
     virtual network::memory::Request_Sender  getLeafMemoryRequest()               = 0;
     virtual network::jit::Request_Sender     getLeafJITRequest()                  = 0;
@@ -107,6 +108,10 @@ public:
     runtime::PointerNet  allocateRemote( const runtime::MPO& remote, concrete::ObjectID objectType );
     runtime::PointerHeap networkToHeap( const runtime::PointerNet& ref );
 
+    // read locks with lease caching across cycles
+    runtime::TimeStamp acquireRead( const runtime::MPO& target );
+    void               leaseInvalidated( const runtime::MPO& owner );
+
     /*
     void                 readLock( runtime::PointerHeap& ref );
     void                 writeLock( runtime::PointerHeap& ref );
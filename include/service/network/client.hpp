@@ -24,6 +24,7 @@
 #include "service/network/logical_thread_manager.hpp"
 #include "service/network/receiver.hpp"
 #include "service/network/sender_factory.hpp"
+#include "service/network/shared_memory.hpp"
 #include "service/network/network.hpp"
 
 #include "common/assert_verify.hpp"
@@ -31,7 +32,10 @@
 #include <boost/asio/strand.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
 
+#include <chrono>
+#include <optional>
 #include <string>
 #include <thread>
 #include <functional>
@@ -42,11 +46,18 @@ namespace mega::network
 
 class Client
 {
-    using Strand = boost::asio::strand< boost::asio::io_context::executor_type >;
+    using Strand             = boost::asio::strand< boost::asio::io_context::executor_type >;
+    using DisconnectCallback = std::function< void() >;
 
 public:
     Client( boost::asio::io_context& ioContext, LogicalThreadManager& logicalthreadManager,
             const std::string& strServiceIP, short portNumber );
+
+    // resolves and connects without blocking the io context from a coroutine and throws on failure
+    // or when the connection is not made within the timeout
+    Client( boost::asio::io_context& ioContext, LogicalThreadManager& logicalthreadManager,
+            const std::string& strServiceIP, short portNumber, std::chrono::steady_clock::duration timeout,
+            boost::asio::yield_context& yield_ctx );
     ~Client();
 
     boost::asio::io_context& getIOContext() const { return m_ioContext; }
@@ -55,6 +66,16 @@ public:
     void stop();
     void disconnected();
 
+    template < typename TFunctor >
+    void setDisconnectCallback( TFunctor&& functor )
+    {
+        VERIFY_RTE_MSG( !m_disconnectCallback.has_value(), "Duplicate disconnect callback set" );
+        m_disconnectCallback = functor;
+    }
+
+    // open a segment created by the server and send through it from now on
+    void connectSharedMemory( LogicalThreadManager& logicalthreadManager, const std::string& strSegmentName );
+
 private:
     boost::asio::io_context& m_ioContext;
     Traits::Resolver         m_resolver;
@@ -62,7 +83,11 @@ private:
     Traits::Socket           m_socket;
     Traits::EndPoint         m_endPoint;
     SocketReceiver           m_receiver;
-    Sender::Ptr              m_pSender;
+    SwitchableSender::Ptr    m_pSender;
+
+    std::unique_ptr< SharedMemoryChannel >  m_pSharedMemory;
+    std::unique_ptr< SharedMemoryReceiver > m_pSharedMemoryReceiver;
+    std::optional< DisconnectCallback >     m_disconnectCallback;
 };
 
 } // namespace mega::network
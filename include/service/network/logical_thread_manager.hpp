@@ -23,6 +23,7 @@
 #include "mega/values/service/logical_thread_id.hpp"
 
 #include "service/network/logical_thread.hpp"
+#include "service/network/logical_thread_registry.hpp"
 
 #include <shared_mutex>
 #include <mutex>
@@ -32,9 +33,6 @@ namespace mega::network
 
 class LogicalThreadManager
 {
-    using LogicalThreadPtrMap = std::map< LogicalThreadID, LogicalThreadBase::Ptr >;
-    using LogicalThreadIDSet  = std::set< LogicalThreadID >;
-
 public:
     LogicalThreadManager( const std::string& strProcessName, boost::asio::io_context& ioContext );
     virtual ~LogicalThreadManager() = 0;
@@ -64,8 +62,9 @@ protected:
 protected:
     std::string                m_strProcessName;
     boost::asio::io_context&   m_ioContext;
-    LogicalThreadPtrMap        m_logicalthreads;
+    LogicalThreadRegistry      m_logicalthreads;
     ExternalLogicalThread::Ptr m_pExternalLogicalThread;
+    // guards m_pExternalLogicalThread and derived class state - the registry locks itself
     mutable std::shared_mutex  m_mutex;
     using WriteLock = std::unique_lock< std::shared_mutex >;
     using ReadLock  = std::shared_lock< std::shared_mutex >;
@@ -0,0 +1,128 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_logical_thread_registry
+#define GUARD_2026_October_18_logical_thread_registry
+
+#include "mega/values/service/logical_thread_id.hpp"
+
+#include "service/protocol/common/logical_thread_base.hpp"
+
+#include <array>
+#include <shared_mutex>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace mega::network
+{
+
+// Registry of the live logical threads of a process split into independently
+// locked shards keyed on the random bits of the LogicalThreadID.  Lookups on
+// the receive path only take a shared lock on one shard so concurrent receiver
+// threads almost never touch the same cache line.
+class LogicalThreadRegistry
+{
+    struct IDHash
+    {
+        inline std::size_t operator()( const LogicalThreadID& id ) const noexcept { return id.getRandomBits(); }
+    };
+    using Map = std::unordered_map< LogicalThreadID, LogicalThreadBase::Ptr, IDHash >;
+
+    static constexpr U64 ShardBits  = 6;
+    static constexpr U64 ShardCount = 1U << ShardBits;
+
+    struct alignas( 64 ) Shard
+    {
+        mutable std::shared_mutex mutex;
+        Map                       map;
+    };
+
+    // map buckets use the low bits so take the shard from the high bits
+    inline Shard& getShard( const LogicalThreadID& id )
+    {
+        return m_shards[ id.getRandomBits() >> ( 64U - ShardBits ) ];
+    }
+    inline const Shard& getShard( const LogicalThreadID& id ) const
+    {
+        return m_shards[ id.getRandomBits() >> ( 64U - ShardBits ) ];
+    }
+
+    using WriteLock = std::unique_lock< std::shared_mutex >;
+    using ReadLock  = std::shared_lock< std::shared_mutex >;
+
+public:
+    inline void insert( const LogicalThreadID& id, LogicalThreadBase::Ptr pLogicalThread )
+    {
+        Shard&    shard = getShard( id );
+        WriteLock lock( shard.mutex );
+        shard.map.insert( { id, std::move( pLogicalThread ) } );
+    }
+
+    inline bool erase( const LogicalThreadID& id )
+    {
+        Shard&    shard = getShard( id );
+        WriteLock lock( shard.mutex );
+        return shard.map.erase( id ) != 0U;
+    }
+
+    inline LogicalThreadBase::Ptr find( const LogicalThreadID& id ) const
+    {
+        const Shard& shard = getShard( id );
+        ReadLock     lock( shard.mutex );
+        auto         iFind = shard.map.find( id );
+        if( iFind != shard.map.end() )
+        {
+            return iFind->second;
+        }
+        else
+        {
+            return {};
+        }
+    }
+
+    // visits each shard under its own lock so the result is not a single snapshot
+    template < typename Functor >
+    inline void forEach( Functor&& functor ) const
+    {
+        for( const Shard& shard : m_shards )
+        {
+            ReadLock lock( shard.mutex );
+            for( const auto& [ id, pLogicalThread ] : shard.map )
+            {
+                functor( id, pLogicalThread );
+            }
+        }
+    }
+
+    inline std::vector< LogicalThreadID > getIDs() const
+    {
+        std::vector< LogicalThreadID > ids;
+        forEach( [ &ids ]( const LogicalThreadID& id, const LogicalThreadBase::Ptr& ) { ids.push_back( id ); } );
+        return ids;
+    }
+
+private:
+    std::array< Shard, ShardCount > m_shards;
+};
+
+} // namespace mega::network
+
+#endif // GUARD_2026_October_18_logical_thread_registry
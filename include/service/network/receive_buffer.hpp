@@ -0,0 +1,199 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_receive_buffer
+#define GUARD_2026_October_18_receive_buffer
+
+#include "mega/values/native_types.hpp"
+#include "mega/values/service/logical_thread_id.hpp"
+
+#include "common/assert_verify.hpp"
+
+#include <boost/asio/buffer.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace mega::network
+{
+
+class ReceiveBuffer
+{
+public:
+    ReceiveBuffer( U64 szCapacity )
+        : m_data( szCapacity )
+    {
+    }
+
+    inline char*       data() { return m_data.data(); }
+    inline const char* data() const { return m_data.data(); }
+    inline U64         capacity() const { return m_data.size(); }
+
+private:
+    std::vector< char > m_data;
+};
+
+// Process wide pool of receive buffers so connection churn and large messages do not
+// allocate once the pool is warm.  Buffers are refcounted and return to the pool on release.
+class ReceiveBufferPool : public std::enable_shared_from_this< ReceiveBufferPool >
+{
+public:
+    using Ptr = std::shared_ptr< ReceiveBufferPool >;
+
+    static constexpr U64 DEFAULT_CAPACITY = 1 << 16;
+    static constexpr U64 MAX_POOLED       = 64;
+
+    // buffers larger than this are released rather than pooled
+    static constexpr U64 MAX_POOLED_CAPACITY = 1 << 24;
+
+    static Ptr get()
+    {
+        static Ptr pPool = std::make_shared< ReceiveBufferPool >();
+        return pPool;
+    }
+
+    std::shared_ptr< ReceiveBuffer > acquire( U64 szMinCapacity = DEFAULT_CAPACITY )
+    {
+        std::unique_ptr< ReceiveBuffer > pBuffer;
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            auto iFind = std::find_if( m_free.begin(), m_free.end(),
+                                       [ szMinCapacity ]( const std::unique_ptr< ReceiveBuffer >& pFree )
+                                       { return pFree->capacity() >= szMinCapacity; } );
+            if( iFind != m_free.end() )
+            {
+                pBuffer = std::move( *iFind );
+                m_free.erase( iFind );
+            }
+        }
+        if( !pBuffer )
+        {
+            pBuffer = std::make_unique< ReceiveBuffer >( std::max( szMinCapacity, DEFAULT_CAPACITY ) );
+        }
+        return { pBuffer.release(), [ pPool = shared_from_this() ]( ReceiveBuffer* p ) { pPool->release( p ); } };
+    }
+
+private:
+    void release( ReceiveBuffer* p )
+    {
+        std::unique_ptr< ReceiveBuffer > pBuffer( p );
+        if( pBuffer->capacity() <= MAX_POOLED_CAPACITY )
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            if( m_free.size() < MAX_POOLED )
+            {
+                m_free.push_back( std::move( pBuffer ) );
+            }
+        }
+    }
+
+    std::mutex                                      m_mutex;
+    std::vector< std::unique_ptr< ReceiveBuffer > > m_free;
+};
+
+// Frames size prefixed messages out of large reads into a pooled buffer.
+// Usage: read_some into prepare(), commit() the bytes read then frame() every
+// complete message in place.  Partial messages are carried into the next read.
+class MessageFramer
+{
+    static constexpr U64 MessageSizeSize = sizeof( MessageSize );
+
+    // compact when less than this remains at the tail of the buffer
+    static constexpr U64 MIN_READ_SIZE = 1 << 12;
+
+public:
+    MessageFramer( ReceiveBufferPool::Ptr pPool = ReceiveBufferPool::get() )
+        : m_pPool( std::move( pPool ) )
+        , m_pBuffer( m_pPool->acquire() )
+    {
+    }
+
+    inline boost::asio::mutable_buffer prepare()
+    {
+        const U64 szPending = m_end - m_begin;
+        const U64 szFrame   = szPending >= MessageSizeSize ? MessageSizeSize + peekSize() : 0U;
+
+        if( szFrame > m_pBuffer->capacity() )
+        {
+            // single message larger than the buffer
+            auto pLarger = m_pPool->acquire( szFrame );
+            std::memcpy( pLarger->data(), m_pBuffer->data() + m_begin, szPending );
+            m_pBuffer = std::move( pLarger );
+            m_begin   = 0U;
+            m_end     = szPending;
+        }
+        else if( m_begin != 0U
+                 && ( m_pBuffer->capacity() - m_end < MIN_READ_SIZE || m_begin + szFrame > m_pBuffer->capacity() ) )
+        {
+            std::memmove( m_pBuffer->data(), m_pBuffer->data() + m_begin, szPending );
+            m_begin = 0U;
+            m_end   = szPending;
+        }
+        return boost::asio::buffer( m_pBuffer->data() + m_end, m_pBuffer->capacity() - m_end );
+    }
+
+    inline void commit( U64 szBytes )
+    {
+        VERIFY_RTE( m_end + szBytes <= m_pBuffer->capacity() );
+        m_end += szBytes;
+    }
+
+    // calls functor with a span over each complete message - valid only for the call
+    template < typename TFunctor >
+    inline void frame( TFunctor&& functor )
+    {
+        while( m_end - m_begin >= MessageSizeSize )
+        {
+            const U64 szSize = peekSize();
+            if( m_end - m_begin - MessageSizeSize < szSize )
+            {
+                break;
+            }
+            const std::span< const char > message( m_pBuffer->data() + m_begin + MessageSizeSize, szSize );
+            m_begin += MessageSizeSize + szSize;
+            functor( message );
+        }
+        if( m_begin == m_end )
+        {
+            m_begin = m_end = 0U;
+        }
+    }
+
+private:
+    inline U64 peekSize() const
+    {
+        MessageSize size;
+        std::memcpy( &size, m_pBuffer->data() + m_begin, MessageSizeSize );
+        return size;
+    }
+
+    ReceiveBufferPool::Ptr           m_pPool;
+    std::shared_ptr< ReceiveBuffer > m_pBuffer;
+    U64                              m_begin = 0U;
+    U64                              m_end   = 0U;
+};
+
+} // namespace mega::network
+
+#endif // GUARD_2026_October_18_receive_buffer
@@ -29,6 +29,7 @@
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/spawn.hpp>
 
+#include <atomic>
 #include <functional>
 #include <future>
 
@@ -58,6 +59,9 @@ public:
     }
     void stop() { m_bContinue = false; }
 
+    // messages dispatched so far - the shared memory receiver waits on this when the peer switches
+    U64 getReceivedCount() const { return m_uiReceived.load( std::memory_order_acquire ); }
+
 private:
     void receive( Sender::Ptr pSender, boost::asio::yield_context& yield_ctx );
     void onError( const boost::system::error_code& ec );
@@ -67,6 +71,7 @@ private:
     LogicalThreadManager&   m_logicalThreadManager;
     Traits::Socket&         m_socket;
     std::function< void() > m_disconnectHandler;
+    std::atomic< U64 >      m_uiReceived = 0U;
 };
 
 class ConcurrentChannelReceiver
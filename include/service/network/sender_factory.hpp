@@ -29,6 +29,7 @@
 #include <boost/asio/experimental/concurrent_channel.hpp>
 #include <boost/asio/experimental/channel.hpp>
 
+#include <atomic>
 #include <memory>
 
 namespace mega::network
@@ -38,6 +39,39 @@ Sender::Ptr make_socket_sender( Traits::Socket& socket );
 Sender::Ptr make_concurrent_channel_sender( ConcurrentChannel& channel );
 Sender::Ptr make_channel_sender( Channel& channel );
 
+class SharedMemoryChannel;
+class SharedMemorySender;
+
+// Connection sender whose identity stays fixed while the transport underneath is switched
+// once, from the socket to shared memory, after the peers agree to upgrade.  switchTo may be
+// called from any thread but the switch happens on a later send once no socket send is still
+// suspended.  The first bytes through shared memory carry the number of messages sent over the
+// socket so the peer dispatches those first and the switch cannot reorder messages.
+class SwitchableSender : public Sender
+{
+public:
+    using Ptr = std::shared_ptr< SwitchableSender >;
+
+    SwitchableSender( Sender::Ptr pInitial );
+    virtual ~SwitchableSender();
+
+    void switchTo( SharedMemoryChannel& channel );
+    bool isSwitched() const { return m_bSwitched.load(); }
+
+    virtual boost::system::error_code send( const Message& msg );
+    virtual boost::system::error_code send( const Message& msg, boost::asio::yield_context& yield_ctx );
+
+private:
+    template < typename TSend >
+    boost::system::error_code sendImpl( TSend&& send );
+
+    Sender::Ptr                           m_pInitial;
+    std::shared_ptr< SharedMemorySender > m_pSwitched;
+    std::atomic< SharedMemoryChannel* >   m_pPending = nullptr;
+    std::atomic< bool >                   m_bSwitched = false;
+    U64                                   m_uiInitialSent = 0U, m_uiInitialSending = 0U;
+};
+
 } // namespace mega::network
 
 #endif // SENDER_15_JUNE_2022
@@ -24,6 +24,7 @@
 #include "logical_thread_manager.hpp"
 #include "receiver.hpp"
 #include "sender_factory.hpp"
+#include "shared_memory.hpp"
 
 #include "mega/values/service/logical_thread_id.hpp"
 
@@ -61,6 +62,13 @@ public:
         const std::optional< Label >&   getLabel() const { return m_labelOpt; }
 
         void setType( Node type ) { m_typeOpt = type; }
+
+        boost::asio::ip::address getRemoteAddress() const;
+        // true when the peer connected over loopback and so shares this machine
+        bool isLocal() const;
+        // create the named segment and receive from it - the sender switches over once the peer
+        // sends its first message through the segment
+        void createSharedMemory( const std::string& strSegmentName );
         void setLabel( Label label ) { m_labelOpt = label; }
 
         template < typename TFunctor >
@@ -78,14 +86,16 @@ public:
         void            disconnected();
 
     private:
-        Server&                             m_server;
-        Strand                              m_strand;
-        Traits::Socket                      m_socket;
-        SocketReceiver                      m_receiver;
-        Sender::Ptr                         m_pSender;
-        std::optional< Node >               m_typeOpt;
-        std::optional< DisconnectCallback > m_disconnectCallback;
-        std::optional< Label >              m_labelOpt;
+        Server&                                 m_server;
+        Strand                                  m_strand;
+        Traits::Socket                          m_socket;
+        SocketReceiver                          m_receiver;
+        SwitchableSender::Ptr                   m_pSender;
+        std::unique_ptr< SharedMemoryChannel >  m_pSharedMemory;
+        std::unique_ptr< SharedMemoryReceiver > m_pSharedMemoryReceiver;
+        std::optional< Node >                   m_typeOpt;
+        std::optional< DisconnectCallback >     m_disconnectCallback;
+        std::optional< Label >                  m_labelOpt;
     };
 
     using ConnectionMap = std::set< Connection::Ptr >;
@@ -0,0 +1,149 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_shared_memory
+#define GUARD_2026_October_18_shared_memory
+
+#include "service/protocol/common/sender.hpp"
+
+#include "mega/values/native_types.hpp"
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace mega::network
+{
+
+// Single producer single consumer byte ring living in shared memory.  Writers and readers
+// spin briefly and then sleep on a futex word in the shared header so a co-located peer is
+// woken without touching the network stack.  Messages larger than the ring stream through it.
+class SharedMemoryRing
+{
+public:
+    struct Header
+    {
+        alignas( 64 ) std::atomic< U64 > head; // bytes written
+        alignas( 64 ) std::atomic< U64 > tail; // bytes read
+        alignas( 64 ) std::atomic< U32 > dataSignal;
+        std::atomic< U32 > consumerWaiting;
+        alignas( 64 ) std::atomic< U32 > spaceSignal;
+        std::atomic< U32 > producerWaiting;
+        std::atomic< U32 > closed;
+    };
+    static_assert( std::atomic< U64 >::is_always_lock_free, "Shared memory ring requires lock free atomics" );
+    static_assert( std::atomic< U32 >::is_always_lock_free, "Shared memory ring requires lock free atomics" );
+
+    SharedMemoryRing( Header* pHeader, char* pData, U64 szCapacity );
+
+    // block until all bytes are written - returns false if the ring is closed
+    bool write( const char* pData, U64 szSize );
+    // block until all bytes are read - returns false if the ring is closed or bStop is set
+    bool read( char* pData, U64 szSize, const std::atomic< bool >& bStop );
+
+    void close();
+    bool isClosed() const { return m_pHeader->closed.load() != 0U; }
+
+private:
+    U64 available() const;
+    U64 space() const;
+
+    Header* m_pHeader;
+    char*   m_pData;
+    U64     m_szCapacity;
+};
+
+// Pair of rings in one named segment.  The creating side writes to the first ring and
+// reads from the second while the opening side does the reverse.  The segment is created
+// exclusively with owner only permissions and its name is removed once the peer attaches.
+class SharedMemoryChannel
+{
+public:
+    static constexpr U64 DEFAULT_RING_SIZE = 1 << 22;
+
+    struct Create
+    {
+    };
+    struct Open
+    {
+    };
+
+    SharedMemoryChannel( Create, const std::string& strName, U64 szRingSize = DEFAULT_RING_SIZE );
+    SharedMemoryChannel( Open, const std::string& strName );
+    ~SharedMemoryChannel();
+
+    SharedMemoryChannel( const SharedMemoryChannel& )            = delete;
+    SharedMemoryChannel& operator=( const SharedMemoryChannel& ) = delete;
+
+    const std::string& getName() const { return m_strName; }
+    SharedMemoryRing&  outbound() { return *m_pOutbound; }
+    SharedMemoryRing&  inbound() { return *m_pInbound; }
+
+    void close();
+    // remove the name so no other process can open the segment - the mapping stays valid
+    void unlink();
+
+private:
+    void map( bool bCreator );
+
+    std::string                                  m_strName;
+    bool                                         m_bCreator;
+    boost::interprocess::shared_memory_object    m_sharedMemory;
+    boost::interprocess::mapped_region           m_region;
+    std::unique_ptr< SharedMemoryRing >          m_pOutbound, m_pInbound;
+};
+
+class LogicalThreadManager;
+class SocketReceiver;
+
+// Reads messages from the inbound ring on a dedicated thread, decodes them there and posts
+// dispatch to the connection executor.  The peer first writes how many messages it sent over
+// the socket and nothing is dispatched until the socket receiver has dispatched them all.
+// onAttach is then called so the connection can switch its own sender over to the ring.
+class SharedMemoryReceiver
+{
+public:
+    SharedMemoryReceiver( LogicalThreadManager& logicalthreadManager, SharedMemoryChannel& channel,
+                          const SocketReceiver& socketReceiver );
+    ~SharedMemoryReceiver();
+
+    void run( boost::asio::any_io_executor executor, Sender::Ptr pSender, std::function< void() > onAttach );
+    void stop();
+
+private:
+    void receive( boost::asio::any_io_executor executor, Sender::Ptr pSender, std::function< void() > onAttach );
+
+    LogicalThreadManager& m_logicalThreadManager;
+    SharedMemoryChannel&  m_channel;
+    const SocketReceiver& m_socketReceiver;
+    std::atomic< bool >   m_bStop = false;
+    std::thread           m_thread;
+};
+
+} // namespace mega::network
+
+#endif // GUARD_2026_October_18_shared_memory
@@ -39,6 +39,7 @@ public:
         bool m_bMemory         = false;
         bool m_bLocks          = false;
         bool m_bLog            = false;
+        bool m_bDispatch       = false;
     };
     StatusPrinter( Config config );
 
@@ -0,0 +1,95 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_dispatch_table
+#define GUARD_2026_October_18_dispatch_table
+
+#include "service/protocol/model/messages.hxx"
+
+#include "mega/values/service/status.hpp"
+
+#include <boost/asio/spawn.hpp>
+
+#include <array>
+#include <chrono>
+#include <stdexcept>
+
+namespace mega::network
+{
+
+// process wide per message ID request counters and latency histograms
+void           recordDispatch( MessageID id, std::chrono::steady_clock::duration duration );
+DispatchStatus getDispatchStatus();
+
+// Dense MessageID -> handler jump table for a logical thread class.
+// Each generated protocol Impl contributes its requests via registerHandlers
+// so the table is built at compile time and dispatch is a single indexed call.
+template < typename LogicalThreadType >
+class DispatchTable
+{
+public:
+    using Handler = Message ( * )( LogicalThreadType&, const Message&, boost::asio::yield_context& );
+
+    template < typename... Interfaces >
+    static constexpr DispatchTable make()
+    {
+        DispatchTable table;
+        ( Interfaces::registerHandlers( table ), ... );
+        return table;
+    }
+
+    // a duplicate fails constant evaluation so overlapping interfaces do not compile
+    constexpr void add( MessageID id, Handler pHandler )
+    {
+        if( m_handlers[ id ] != nullptr )
+        {
+            throw std::logic_error( "Duplicate message handler in dispatch table" );
+        }
+        m_handlers[ id ] = pHandler;
+    }
+
+    constexpr bool contains( MessageID id ) const { return id < messageCount && m_handlers[ id ] != nullptr; }
+
+    // returns an empty Message when the logical thread does not handle the request
+    Message dispatch( LogicalThreadType& logicalThread, const Message& msg, boost::asio::yield_context& yield_ctx ) const
+    {
+        const MessageID id = msg.getID();
+        if( !contains( id ) )
+        {
+            return Message{};
+        }
+
+        struct Timer
+        {
+            const MessageID                             id;
+            const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+            ~Timer() { recordDispatch( id, std::chrono::steady_clock::now() - startTime ); }
+        } timer{ id };
+
+        return m_handlers[ id ]( logicalThread, msg, yield_ctx );
+    }
+
+private:
+    std::array< Handler, messageCount > m_handlers{};
+};
+
+} // namespace mega::network
+
+#endif // GUARD_2026_October_18_dispatch_table
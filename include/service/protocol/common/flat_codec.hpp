@@ -0,0 +1,276 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_flat_codec
+#define GUARD_2026_October_18_flat_codec
+
+#include "mega/values/native_types.hpp"
+
+#include "mega/values/compilation/interface/type_id.hpp"
+#include "mega/values/compilation/concrete/type_id.hpp"
+#include "mega/values/compilation/concrete/object_id.hpp"
+
+#include "mega/values/runtime/machine_id.hpp"
+#include "mega/values/runtime/process_id.hpp"
+#include "mega/values/runtime/owner_id.hpp"
+#include "mega/values/runtime/mp.hpp"
+#include "mega/values/runtime/mpo.hpp"
+#include "mega/values/runtime/timestamp.hpp"
+
+#include "mega/values/service/logical_thread_id.hpp"
+
+#include "common/assert_verify.hpp"
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <bit>
+#include <limits>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace mega::network
+{
+
+// Every encoded message is prefixed with a single codec byte so that nodes
+// running either codec can decode what the other sends.
+enum class WireCodec : U8
+{
+    eBoost = 1,
+    eFlat  = 2
+};
+
+namespace flat
+{
+static_assert( std::endian::native == std::endian::little, "Flat codec assumes a little endian host" );
+
+static constexpr auto boostFallbackFlags = boost::archive::no_header | boost::archive::no_codecvt
+                                           | boost::archive::no_xml_tag_checking | boost::archive::no_tracking;
+
+// Types whose object representation IS their wire representation.  Anything
+// not listed here falls back to an embedded boost archive so that types which
+// deliberately refuse serialisation ( SenderRef, PointerHeap ... ) keep doing so.
+template < typename T >
+struct IsFlatValue : std::bool_constant< std::is_arithmetic_v< T > || std::is_enum_v< T > >
+{
+};
+
+#define MEGA_FLAT_VALUE( Type )                                                                       \
+    template <>                                                                                       \
+    struct IsFlatValue< Type > : std::true_type                                                       \
+    {                                                                                                 \
+        static_assert( std::is_trivially_copyable_v< Type >, "Flat value must be trivially copyable" ); \
+    };
+
+MEGA_FLAT_VALUE( mega::interface::TypeID )
+MEGA_FLAT_VALUE( mega::concrete::TypeID )
+MEGA_FLAT_VALUE( mega::concrete::ObjectID )
+MEGA_FLAT_VALUE( mega::runtime::MachineID )
+MEGA_FLAT_VALUE( mega::runtime::ProcessID )
+MEGA_FLAT_VALUE( mega::runtime::OwnerID )
+MEGA_FLAT_VALUE( mega::runtime::MP )
+MEGA_FLAT_VALUE( mega::runtime::MPO )
+MEGA_FLAT_VALUE( mega::runtime::TimeStamp )
+MEGA_FLAT_VALUE( mega::network::LogicalThreadID )
+
+#undef MEGA_FLAT_VALUE
+
+template < typename T >
+inline constexpr bool IsFlatValue_v = IsFlatValue< T >::value;
+
+class Writer
+{
+public:
+    explicit Writer( std::streambuf& buffer )
+        : m_buffer( buffer )
+    {
+    }
+
+    inline void bytes( const void* pData, U64 szSize )
+    {
+        const auto szWritten = m_buffer.sputn( reinterpret_cast< const char* >( pData ), szSize );
+        VERIFY_RTE_MSG( static_cast< U64 >( szWritten ) == szSize, "Flat codec failed to write: " << szSize );
+    }
+    inline void size( U64 szSize )
+    {
+        VERIFY_RTE_MSG( szSize <= std::numeric_limits< U32 >::max(), "Flat codec sequence too large: " << szSize );
+        const U32 uiSize = static_cast< U32 >( szSize );
+        bytes( &uiSize, sizeof( U32 ) );
+    }
+    inline std::streambuf& buffer() { return m_buffer; }
+
+private:
+    std::streambuf& m_buffer;
+};
+
+class Reader
+{
+public:
+    explicit Reader( std::streambuf& buffer )
+        : m_buffer( buffer )
+    {
+    }
+
+    inline void bytes( void* pData, U64 szSize )
+    {
+        const auto szRead = m_buffer.sgetn( reinterpret_cast< char* >( pData ), szSize );
+        VERIFY_RTE_MSG( static_cast< U64 >( szRead ) == szSize, "Flat codec message truncated reading: " << szSize );
+    }
+    inline U32 size()
+    {
+        U32 uiSize = 0U;
+        bytes( &uiSize, sizeof( U32 ) );
+        return uiSize;
+    }
+    inline std::streambuf& buffer() { return m_buffer; }
+
+private:
+    std::streambuf& m_buffer;
+};
+
+template < typename T >
+void write( Writer& writer, const T& value );
+template < typename T >
+void read( Reader& reader, T& value );
+
+inline void write( Writer& writer, const std::string& str )
+{
+    writer.size( str.size() );
+    writer.bytes( str.data(), str.size() );
+}
+inline void read( Reader& reader, std::string& str )
+{
+    str.resize( reader.size() );
+    reader.bytes( str.data(), str.size() );
+}
+
+inline void write( Writer& writer, const boost::filesystem::path& filePath )
+{
+    write( writer, filePath.string() );
+}
+inline void read( Reader& reader, boost::filesystem::path& filePath )
+{
+    std::string str;
+    read( reader, str );
+    filePath = std::move( str );
+}
+
+template < typename T >
+inline void write( Writer& writer, const std::optional< T >& value )
+{
+    const U8 bHasValue = value.has_value() ? 1U : 0U;
+    writer.bytes( &bHasValue, sizeof( U8 ) );
+    if( bHasValue )
+    {
+        write( writer, value.value() );
+    }
+}
+template < typename T >
+inline void read( Reader& reader, std::optional< T >& value )
+{
+    U8 bHasValue = 0U;
+    reader.bytes( &bHasValue, sizeof( U8 ) );
+    if( bHasValue )
+    {
+        T temp;
+        read( reader, temp );
+        value = std::move( temp );
+    }
+    else
+    {
+        value.reset();
+    }
+}
+
+template < typename T, typename TAllocator >
+inline void write( Writer& writer, const std::vector< T, TAllocator >& values )
+{
+    writer.size( values.size() );
+    if constexpr( IsFlatValue_v< T > && !std::is_same_v< T, bool > )
+    {
+        writer.bytes( values.data(), values.size() * sizeof( T ) );
+    }
+    else
+    {
+        for( const auto& value : values )
+        {
+            write( writer, static_cast< const T& >( value ) );
+        }
+    }
+}
+template < typename T, typename TAllocator >
+inline void read( Reader& reader, std::vector< T, TAllocator >& values )
+{
+    const U32 uiSize = reader.size();
+    if constexpr( IsFlatValue_v< T > && !std::is_same_v< T, bool > )
+    {
+        values.resize( uiSize );
+        reader.bytes( values.data(), values.size() * sizeof( T ) );
+    }
+    else
+    {
+        values.clear();
+        values.reserve( uiSize );
+        for( U32 ui = 0U; ui != uiSize; ++ui )
+        {
+            T value;
+            read( reader, value );
+            values.emplace_back( std::move( value ) );
+        }
+    }
+}
+
+template < typename T >
+inline void write( Writer& writer, const T& value )
+{
+    if constexpr( IsFlatValue_v< T > )
+    {
+        writer.bytes( &value, sizeof( T ) );
+    }
+    else
+    {
+        // the archive writes straight into the same buffer and reads back exactly what it wrote
+        boost::archive::binary_oarchive archive( writer.buffer(), boostFallbackFlags );
+        archive& value;
+    }
+}
+template < typename T >
+inline void read( Reader& reader, T& value )
+{
+    if constexpr( IsFlatValue_v< T > )
+    {
+        reader.bytes( &value, sizeof( T ) );
+    }
+    else
+    {
+        boost::archive::binary_iarchive archive( reader.buffer(), boostFallbackFlags );
+        archive& value;
+    }
+}
+
+} // namespace flat
+
+} // namespace mega::network
+
+#endif // GUARD_2026_October_18_flat_codec
@@ -24,6 +24,7 @@
 #include "mega/values/runtime/pointer.hpp"
 
 #include "event/file_log.hpp"
+#include "event/memory_codec.hpp"
 
 #include <boost/serialization/split_member.hpp>
 
@@ -68,9 +69,10 @@ public:
                                                read.getType() } };
             m_structure.emplace_back( record );
         }
-        inline void push_back( const event::Memory::Read& read )
+        // the value is always forwarded in full since the receiver holds no previous values to apply a delta to
+        inline void push_back( const runtime::PointerHeap& ref, std::string_view value )
         {
-            event::Memory::DataIO record{ { read.getRef() }, std::string{ read.getData() } };
+            event::Memory::DataIO record{ { ref, event::Memory::eFull }, std::string{ value } };
             m_memory.emplace_back( record );
         }
         inline void push_back( const event::Event::Read& read )
@@ -161,6 +163,8 @@ private:
     mega::event::FileStorage&       m_log;
     const mega::event::IndexRecord& m_iteratorEnd;
     mega::event::IndexRecord        m_iterator;
+    runtime::TimeStamp              m_timestamp;
+    mega::event::MemoryDecoder      m_memoryDecoder;
 };
 
 } // namespace mega::network
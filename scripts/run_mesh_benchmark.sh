@@ -0,0 +1,58 @@
+#!/bin/bash
+
+# Measures cross daemon sim lock latency with and without the daemon mesh.
+# Starts a root and two daemons on this machine, creates an executor and
+# simulation on each daemon and then times repeated read lock / release
+# cycles from the simulation on daemon 0 against the simulation on daemon 1.
+# The cycles run inside one terminal process so only the lock round trips
+# are timed.
+
+if [ x"${BUILD_PATH}" == "x" ]; then
+    echo "BUILD_PATH is not configured"
+    exit 1
+fi
+
+if [ x"${CFG_TUPLE}" == "x" ]; then
+    echo "CFG_TUPLE is not configured"
+    exit 1
+fi
+
+Iterations=${1:-100}
+SecondDaemonPort=${2:-4139}
+BinPath=${BUILD_PATH}/${CFG_TUPLE}/mega/install/bin
+
+run_mode()
+{
+    MeshFlag=$1
+
+    ${BinPath}/root --level warn --console error &
+    RootPID=$!
+    sleep 1
+
+    ${BinPath}/daemon --level warn --console error ${MeshFlag} &
+    DaemonAPID=$!
+    sleep 1
+
+    ${BinPath}/daemon --level warn --console error --port ${SecondDaemonPort} ${MeshFlag} &
+    DaemonBPID=$!
+    sleep 1
+
+    ExecutorA=$(mega --sim --create 0)
+    ExecutorB=$(mega --sim --create 1)
+    SimA=$(mega --sim --create ${ExecutorA})
+    SimB=$(mega --sim --create ${ExecutorB})
+
+    # first lock opens the peer connection when meshed so keep it out of the timing
+    mega --sim --id ${SimA} --read ${SimB} > /dev/null
+    mega --sim --id ${SimA} --release ${SimB}
+
+    Result=$(mega --sim --id ${SimA} --read ${SimB} --cycles ${Iterations})
+
+    echo "mode: ${MeshFlag:-root} sims: ${SimA} -> ${SimB} ${Result}"
+
+    kill ${DaemonBPID} ${DaemonAPID} ${RootPID}
+    wait ${DaemonBPID} ${DaemonAPID} ${RootPID} 2> /dev/null
+}
+
+run_mode ""
+run_mode "--mesh"
@@ -53,6 +53,7 @@
 #include <boost/dll.hpp>
 #include <boost/process.hpp>
 
+#include <chrono>
 #include <iostream>
 #include <ostream>
 #include <vector>
@@ -282,10 +283,25 @@ public:
         taskProgress.onStarted( TaskReport{ TaskReport::eSTARTED, m_taskName }.str() );
     }
 
+    void reportStageReads( mega::pipeline::Progress& taskProgress )
+    {
+        const auto& stats   = m_environment.getStageReadStatistics();
+        const U64   uiReads = stats.uiHits + stats.uiMisses;
+        if( uiReads != 0U )
+        {
+            std::ostringstream os;
+            os << "Stage file load: " << uiReads << " stage files in "
+               << std::chrono::duration_cast< std::chrono::milliseconds >( stats.readTime ).count()
+               << "ms with stage cache hit rate " << ( stats.uiHits * 100U ) / uiReads << "%";
+            msg( taskProgress, os.str() );
+        }
+    }
+
     void cached( mega::pipeline::Progress& taskProgress )
     {
         VERIFY_RTE( !m_bCompleted );
         m_bCompleted = true;
+        reportStageReads( taskProgress );
         taskProgress.onCompleted( TaskReport{ TaskReport::eCACHED, m_taskName }.str() );
     }
 
@@ -293,6 +309,7 @@ public:
     {
         VERIFY_RTE( !m_bCompleted );
         m_bCompleted = true;
+        reportStageReads( taskProgress );
         taskProgress.onCompleted( TaskReport{ TaskReport::eSUCCESS, m_taskName }.str() );
     }
 
@@ -300,6 +317,7 @@ public:
     {
         VERIFY_RTE( !m_bCompleted );
         m_bCompleted = true;
+        reportStageReads( taskProgress );
         taskProgress.onFailed( TaskReport{ TaskReport::eFAILED, m_taskName }.str() );
     }
 
@@ -346,7 +346,26 @@ pipeline::Schedule CompilerPipeline::getSchedule( pipeline::Progress&, pipeline:
     //     dependencies.add( complete, completionTasks );
     // }
 
-    return { dependencies };
+    pipeline::Schedule schedule( dependencies );
+
+    // stages that only read files produced upstream can be cut off when nothing upstream changed.
+    // Tasks reading mega sources, cpp sources or user headers directly always run.
+    {
+        pipeline::Dependencies::TaskSet earlyCutoff{ interfaceTree,
+                                                     symbolAnalysis,
+                                                     concreteTree,
+                                                     concreteTypeID,
+                                                     hyperGraph,
+                                                     automata,
+                                                     clang_Traits_Gen,
+                                                     clang_Traits_Analysis,
+                                                     cpp_decls,
+                                                     decisions };
+        earlyCutoff.insert( symbolRolloutTasks.begin(), symbolRolloutTasks.end() );
+        schedule.setEarlyCutoff( earlyCutoff );
+    }
+
+    return schedule;
 }
 
 void CompilerPipeline::execute( const pipeline::TaskDescriptor& pipelineTask, pipeline::Progress& progress,
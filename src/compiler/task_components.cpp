@@ -136,7 +136,8 @@ public:
             VERIFY_RTE( pComponent->get_name() == componentInfo.getName() );
         }
 
-        database.save_Components_to_temp();
+        const task::FileHash fileHashCode = database.save_Components_to_temp();
+        m_environment.setBuildHashCode( componentsListing, fileHashCode );
         m_environment.temp_to_real( componentsListing );
 
         succeeded( taskProgress );
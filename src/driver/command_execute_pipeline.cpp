@@ -47,7 +47,9 @@
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/archive/xml_oarchive.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <thread>
 
 namespace driver::execute_pipeline
 {
@@ -58,6 +60,7 @@ void command( mega::network::Log& log, bool bHelp, const std::vector< std::strin
         symbolXML;
     bool        bRunLocally = false, bForceNoStash = false, bExecuteUpTo = false;
     std::string strTaskName, strSourceFile;
+    mega::U32   uiWorkers = std::max( 1U, std::thread::hardware_concurrency() );
 
     namespace po = boost::program_options;
     po::options_description commandOptions( " Execute a Megastructure Pipeline" );
@@ -75,6 +78,7 @@ void command( mega::network::Log& log, bool bHelp, const std::vector< std::strin
         ( "source",             po::value< std::string >( &strSourceFile ),                         "Source file for specific task. ( Local only )" )
         ( "force_no_stash",     po::bool_switch( &bForceNoStash ),                                  "Prevent stash restore for specified task. ( Local only )" )
         ( "execute_up_to",      po::bool_switch( &bExecuteUpTo ),                                   "Only execute up to the specified task. ( Local only )" )
+        ( "workers",            po::value< mega::U32 >( &uiWorkers ),                               "Number of worker threads. Defaults to the core count. ( Local only )" )
         ;
         // clang-format on
     }
@@ -144,7 +148,8 @@ void command( mega::network::Log& log, bool bHelp, const std::vector< std::strin
                 }
                 pipelineResult
                     = runPipelineLocally( stashDir, symbolXMLOpt, toolchain, pipelineConfig, strTaskName, strSourceFile,
-                                          inputPipelineResultPath, bForceNoStash, bExecuteUpTo, false, std::cout );
+                                          inputPipelineResultPath, bForceNoStash, bExecuteUpTo, false, std::cout,
+                                          uiWorkers );
             }
         }
 
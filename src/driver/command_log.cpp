@@ -141,7 +141,7 @@ void printLog( mega::event::FileStorage& log, const Options& options, mega::runt
             const auto& data         = memoryRecord.getData();
 
             std::ostringstream osMem;
-            osMem << memoryRecord.getRef();
+            osMem << memoryRecord.getRef() << ' ' << toString( memoryRecord.getEncoding() );
 
             int x = 0;
             for( auto j = data.begin(), jEnd = data.end(); j != jEnd; ++j, ++x )
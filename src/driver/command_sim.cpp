@@ -23,6 +23,7 @@
 #include <boost/program_options.hpp>
 #include <boost/filesystem/path.hpp>
 
+#include <chrono>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -60,6 +61,7 @@ void command( mega::network::Log& log, bool bHelp, const std::vector< std::strin
 {
     std::string strCreate, strList, strDestroy, strID, strRead, strWrite, strRelease, strSuspend, strResume, strStop,
         strStart, strErrorCheck;
+    unsigned int uiCycles = 0U;
 
     namespace po = boost::program_options;
     po::options_description commandOptions( " Simulation Commands" );
@@ -73,6 +75,7 @@ void command( mega::network::Log& log, bool bHelp, const std::vector< std::strin
             ( "read",       po::value( &strRead ) ,         "Request Read Lock on specified MPO ( use id to specify who from )" )
             ( "write",      po::value( &strWrite ) ,        "Request Write Lock on specified MPO ( use id to specify who from )" )
             ( "release",    po::value( &strRelease ) ,      "Request Release Lock on specified MPO ( use id to specify who from )" )
+            ( "cycles",     po::value( &uiCycles ) ,        "Repeat read and release cycles and report the mean cycle time" )
 
             ( "error",      po::value( &strErrorCheck ),    "Send test request to MPO that will generate exception error in simulation" )
 
@@ -140,8 +143,25 @@ void command( mega::network::Log& log, bool bHelp, const std::vector< std::strin
             const mega::runtime::MPO       sourceMPO = toMPO( strID );
             const mega::runtime::MPO       targetMPO = toMPO( strRead );
             mega::service::Terminal        terminal( log );
-            const mega::runtime::TimeStamp lockCycle = terminal.SimRead( sourceMPO, targetMPO );
-            std::cout << lockCycle << std::endl;
+            if( uiCycles == 0U )
+            {
+                const mega::runtime::TimeStamp lockCycle = terminal.SimRead( sourceMPO, targetMPO );
+                std::cout << lockCycle << std::endl;
+            }
+            else
+            {
+                // time the cycles within one terminal connection so process start up is not measured
+                const auto startTime = std::chrono::steady_clock::now();
+                for( unsigned int ui = 0U; ui != uiCycles; ++ui )
+                {
+                    terminal.SimRead( sourceMPO, targetMPO );
+                    terminal.SimRelease( sourceMPO, targetMPO );
+                }
+                const auto elapsed = std::chrono::duration_cast< std::chrono::microseconds >(
+                    std::chrono::steady_clock::now() - startTime );
+                std::cout << "cycles: " << uiCycles << " mean lock cycle us: " << elapsed.count() / uiCycles
+                          << std::endl;
+            }
         }
         else if( !strWrite.empty() )
         {
@@ -59,6 +59,7 @@ void command( mega::network::Log& log, bool bHelp, const std::vector< std::strin
             ( "locks",   po::value< bool >( &m_config.m_bLocks )->default_value( true ), "Report active lock status ( true by default )" )
             ( "logs",    po::bool_switch( &m_config.m_bLog ),               "Report log file path" )
             ( "runtime", po::bool_switch( &m_config.m_bRuntime ),           "Report runtime info including active program name" )
+            ( "dispatch", po::bool_switch( &m_config.m_bDispatch ),         "Report per message request counts and latency histograms" )
             ;
         // clang-format on
     }
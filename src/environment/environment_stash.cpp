@@ -18,12 +18,16 @@
 //  OF THE POSSIBILITY OF SUCH DAMAGES.
 
 #include "environment/environment_stash.hpp"
+#include "environment/stage_file_cache.hpp"
 
 #include "database/serialisation.hpp"
 #include "database/file_header.hpp"
 #include "database/object_loader.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
 #include <set>
+#include <sstream>
 
 namespace mega::io
 {
@@ -34,6 +38,44 @@ StashEnvironment::StashEnvironment( mega::pipeline::Stash& stash, const Director
 {
 }
 
+std::unique_ptr< std::istream > StashEnvironment::read( const BuildFilePath& filePath ) const
+{
+    const auto startTime  = std::chrono::steady_clock::now();
+    const Path actualPath = toPath( filePath );
+
+    // the build hash code identifies the contents while the size and write time guard against
+    // a file rewritten by a task that did not record a new build hash code for it
+    std::ostringstream osVersion;
+    try
+    {
+        osVersion << m_stash.getBuildHashCode( actualPath ).toHexString();
+    }
+    catch( std::exception& )
+    {
+        m_stageReadStatistics.uiMisses++;
+        auto pStream = BuildEnvironment::read( filePath );
+        m_stageReadStatistics.readTime += std::chrono::steady_clock::now() - startTime;
+        return pStream;
+    }
+    osVersion << '_' << boost::filesystem::file_size( actualPath ) << '_'
+              << boost::filesystem::last_write_time( actualPath );
+
+    StageFileCache&        cache   = StageFileCache::get();
+    StageFileCache::Buffer pBuffer = cache.find( actualPath, osVersion.str() );
+    if( pBuffer )
+    {
+        m_stageReadStatistics.uiHits++;
+    }
+    else
+    {
+        m_stageReadStatistics.uiMisses++;
+        pBuffer = cache.insert( actualPath, osVersion.str(), StageFileCache::load( actualPath ) );
+    }
+    auto pStream = StageFileCache::makeStream( std::move( pBuffer ) );
+    m_stageReadStatistics.readTime += std::chrono::steady_clock::now() - startTime;
+    return pStream;
+}
+
 bool StashEnvironment::restore( const CompilationFilePath& filePath, task::DeterminantHash hashCode ) const
 {
     const Path actualPath = toPath( filePath );
@@ -42,7 +84,8 @@ bool StashEnvironment::restore( const CompilationFilePath& filePath, task::Deter
         // check the file header for the correct version
         ::data::NullObjectPartLoader nullObjectPartLoader;
 
-        std::unique_ptr< std::istream >   pFileStream = read( filePath );
+        // bypass the cache since the restored file has no build hash code yet
+        std::unique_ptr< std::istream >   pFileStream = BuildEnvironment::read( filePath );
         std::set< mega::io::ObjectInfo* > objectInfos;
         boost::archive::MegaIArchive      archive( *pFileStream, objectInfos, nullObjectPartLoader );
 
@@ -0,0 +1,199 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "environment/stage_file_cache.hpp"
+
+#include "common/assert_verify.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <iterator>
+#include <streambuf>
+
+namespace mega::io
+{
+namespace
+{
+class BufferStreamBuf : public std::streambuf
+{
+    StageFileCache::Buffer m_pBuffer;
+
+public:
+    explicit BufferStreamBuf( StageFileCache::Buffer pBuffer )
+        : m_pBuffer( std::move( pBuffer ) )
+    {
+        // the get area is never written through so sharing the immutable contents is safe
+        char* pBegin = const_cast< char* >( m_pBuffer->data() );
+        setg( pBegin, pBegin, pBegin + m_pBuffer->size() );
+    }
+
+protected:
+    pos_type seekoff( off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode which ) override
+    {
+        if( !( which & std::ios_base::in ) )
+        {
+            return pos_type( off_type( -1 ) );
+        }
+        off_type base = 0;
+        switch( dir )
+        {
+            case std::ios_base::beg:
+                base = 0;
+                break;
+            case std::ios_base::cur:
+                base = gptr() - eback();
+                break;
+            case std::ios_base::end:
+                base = egptr() - eback();
+                break;
+            default:
+                return pos_type( off_type( -1 ) );
+        }
+        const off_type position = base + offset;
+        if( position < 0 || position > egptr() - eback() )
+        {
+            return pos_type( off_type( -1 ) );
+        }
+        setg( eback(), eback() + position, egptr() );
+        return pos_type( position );
+    }
+
+    pos_type seekpos( pos_type position, std::ios_base::openmode which ) override
+    {
+        return seekoff( off_type( position ), std::ios_base::beg, which );
+    }
+};
+
+class BufferStream : public std::istream
+{
+    BufferStreamBuf m_streamBuf;
+
+public:
+    explicit BufferStream( StageFileCache::Buffer pBuffer )
+        : std::istream( nullptr )
+        , m_streamBuf( std::move( pBuffer ) )
+    {
+        rdbuf( &m_streamBuf );
+    }
+};
+} // namespace
+
+StageFileCache::StageFileCache( U64 uiCapacityBytes )
+    : m_uiCapacityBytes( uiCapacityBytes )
+{
+}
+
+StageFileCache& StageFileCache::get()
+{
+    static StageFileCache cache( DEFAULT_CAPACITY_BYTES );
+    return cache;
+}
+
+StageFileCache::Buffer StageFileCache::find( const boost::filesystem::path& filePath, const std::string& strVersion )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    auto iFind = m_entries.find( Key{ filePath.string(), strVersion } );
+    if( iFind == m_entries.end() )
+    {
+        ++m_statistics.uiMisses;
+        return {};
+    }
+    ++m_statistics.uiHits;
+    m_lru.splice( m_lru.begin(), m_lru, iFind->second.iterLRU );
+    return iFind->second.pBuffer;
+}
+
+StageFileCache::Buffer StageFileCache::insert( const boost::filesystem::path& filePath,
+                                               const std::string& strVersion, Buffer pBuffer )
+{
+    VERIFY_RTE( pBuffer );
+    if( pBuffer->size() > m_uiCapacityBytes )
+    {
+        return pBuffer;
+    }
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    Key  key{ filePath.string(), strVersion };
+    auto iFind = m_entries.find( key );
+    if( iFind != m_entries.end() )
+    {
+        m_lru.splice( m_lru.begin(), m_lru, iFind->second.iterLRU );
+        return iFind->second.pBuffer;
+    }
+
+    m_lru.push_front( key );
+    m_entries.insert( { std::move( key ), Entry{ pBuffer, m_lru.begin() } } );
+    m_statistics.uiBytes += pBuffer->size();
+    ++m_statistics.uiEntries;
+    evict();
+    return pBuffer;
+}
+
+void StageFileCache::evict()
+{
+    while( m_statistics.uiBytes > m_uiCapacityBytes )
+    {
+        VERIFY_RTE( !m_lru.empty() );
+        auto iFind = m_entries.find( m_lru.back() );
+        VERIFY_RTE( iFind != m_entries.end() );
+        m_statistics.uiBytes -= iFind->second.pBuffer->size();
+        --m_statistics.uiEntries;
+        ++m_statistics.uiEvictions;
+        m_entries.erase( iFind );
+        m_lru.pop_back();
+    }
+}
+
+StageFileCache::Buffer StageFileCache::load( const boost::filesystem::path& filePath )
+{
+    boost::filesystem::ifstream inputFileStream( filePath, std::ios_base::in | std::ios_base::binary );
+    VERIFY_RTE_MSG( inputFileStream.good(), "Failed to open file: " << filePath.string() );
+
+    auto pContents = std::make_shared< std::string >();
+    pContents->reserve( boost::filesystem::file_size( filePath ) );
+    pContents->assign( std::istreambuf_iterator< char >( inputFileStream ), std::istreambuf_iterator< char >() );
+    return pContents;
+}
+
+std::unique_ptr< std::istream > StageFileCache::makeStream( Buffer pBuffer )
+{
+    VERIFY_RTE( pBuffer );
+    return std::make_unique< BufferStream >( std::move( pBuffer ) );
+}
+
+StageFileCache::Statistics StageFileCache::getStatistics() const
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    return m_statistics;
+}
+
+void StageFileCache::clear()
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_entries.clear();
+    m_lru.clear();
+    m_statistics.uiBytes   = 0U;
+    m_statistics.uiEntries = 0U;
+}
+
+} // namespace mega::io
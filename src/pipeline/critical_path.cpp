@@ -0,0 +1,134 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "pipeline/critical_path.hpp"
+
+#include <algorithm>
+#include <deque>
+
+namespace mega::pipeline
+{
+
+void TaskDurations::record( const TaskDescriptor& task, Duration duration )
+{
+    m_durations[ Key{ task.getName(), task.getSourceFile() } ] = static_cast< U64 >( duration.count() );
+}
+
+std::optional< TaskDurations::Duration > TaskDurations::get( const TaskDescriptor& task ) const
+{
+    auto iFind = m_durations.find( Key{ task.getName(), task.getSourceFile() } );
+    if( iFind != m_durations.end() )
+    {
+        return Duration{ iFind->second };
+    }
+    return {};
+}
+
+TaskDurations::Duration TaskDurations::estimate( const TaskDescriptor& task ) const
+{
+    if( auto durationOpt = get( task ); durationOpt.has_value() )
+    {
+        return durationOpt.value();
+    }
+
+    U64 uiNameTotal = 0U, uiNameCount = 0U, uiTotal = 0U;
+    for( const auto& [ key, uiMicroseconds ] : m_durations )
+    {
+        if( key.first == task.getName() )
+        {
+            uiNameTotal += uiMicroseconds;
+            ++uiNameCount;
+        }
+        uiTotal += uiMicroseconds;
+    }
+    if( uiNameCount != 0U )
+    {
+        return Duration{ uiNameTotal / uiNameCount };
+    }
+    if( !m_durations.empty() )
+    {
+        return Duration{ uiTotal / m_durations.size() };
+    }
+    // with no history every task costs the same so the path length counts tasks
+    return Duration{ 1 };
+}
+
+CriticalPath::CriticalPath( const Dependencies& dependencies, const TaskDurations& durations )
+{
+    const Dependencies::Graph& graph = dependencies.getDependencies();
+
+    // a task can only be costed once every task depending on it has been
+    std::map< TaskDescriptor, std::size_t > pendingDependents;
+    std::map< TaskDescriptor, Duration >    longestDependent;
+    for( const TaskDescriptor& task : dependencies.getTasks() )
+    {
+        pendingDependents.insert( { task, 0U } );
+    }
+    for( const auto& [ task, dependency ] : graph )
+    {
+        pendingDependents.insert( { task, 0U } );
+        ++pendingDependents[ dependency ];
+    }
+
+    std::deque< TaskDescriptor > open;
+    for( const auto& [ task, szPending ] : pendingDependents )
+    {
+        if( szPending == 0U )
+        {
+            open.push_back( task );
+        }
+    }
+
+    while( !open.empty() )
+    {
+        const TaskDescriptor task = open.front();
+        open.pop_front();
+
+        Duration remaining = durations.estimate( task );
+        if( auto iFind = longestDependent.find( task ); iFind != longestDependent.end() )
+        {
+            remaining += iFind->second;
+        }
+        m_remaining.insert( { task, remaining } );
+        m_length = std::max( m_length, remaining );
+
+        for( auto i = graph.lower_bound( task ), iEnd = graph.upper_bound( task ); i != iEnd; ++i )
+        {
+            Duration& longest = longestDependent[ i->second ];
+            longest           = std::max( longest, remaining );
+            if( --pendingDependents[ i->second ] == 0U )
+            {
+                open.push_back( i->second );
+            }
+        }
+    }
+}
+
+CriticalPath::Duration CriticalPath::getRemaining( const TaskDescriptor& task ) const
+{
+    auto iFind = m_remaining.find( task );
+    if( iFind != m_remaining.end() )
+    {
+        return iFind->second;
+    }
+    return Duration{ 0 };
+}
+
+} // namespace mega::pipeline
@@ -35,7 +35,14 @@
 #include "common/file.hpp"
 #include "common/time.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
 
 namespace mega::pipeline
 {
@@ -135,33 +142,115 @@ void Dependencies::add( const TaskDescriptor& newTask, const TaskDescriptor::Vec
 Schedule::Schedule( const Dependencies& dependencies )
     : m_dependencies( dependencies )
 {
+    for( const TaskDescriptor& task : m_dependencies.getTasks() )
+    {
+        m_inDegree.insert( { task, 0U } );
+    }
+    for( const auto& [ task, dependency ] : m_dependencies.getDependencies() )
+    {
+        m_dependents.insert( { dependency, task } );
+        ++m_inDegree[ task ];
+    }
+    for( const auto& [ task, szInDegree ] : m_inDegree )
+    {
+        if( szInDegree == 0U )
+        {
+            m_ready.insert( task );
+        }
+    }
 }
 
 TaskDescriptor::Vector Schedule::getReady() const
 {
     TaskDescriptor::Vector ready;
+    std::set_union( m_ready.begin(), m_ready.end(), m_taken.begin(), m_taken.end(), std::back_inserter( ready ) );
+    return ready;
+}
+
+TaskDescriptor::Vector Schedule::takeReady()
+{
+    TaskDescriptor::Vector ready( m_ready.begin(), m_ready.end() );
+    m_taken.insert( m_ready.begin(), m_ready.end() );
+    m_ready.clear();
+    return ready;
+}
+
+void Schedule::setEarlyCutoff( const Dependencies::TaskSet& candidates )
+{
+    m_cutoffCandidates = candidates;
+}
+
+bool Schedule::canSkip( const TaskDescriptor& task ) const
+{
+    if( !m_cutoffCandidates.count( task ) )
+    {
+        return false;
+    }
+    const Dependencies::Graph& graph = m_dependencies.getDependencies();
+    auto                       i = graph.lower_bound( task ), iEnd = graph.upper_bound( task );
+    // tasks without dependencies read inputs outside of the schedule
+    if( i == iEnd )
     {
-        const Dependencies::Graph& graph = m_dependencies.getDependencies();
-        for( const TaskDescriptor& task : m_dependencies.getTasks() )
+        return false;
+    }
+    for( ; i != iEnd; ++i )
+    {
+        if( m_tainted.count( i->second ) )
         {
-            if( m_complete.count( task ) )
-                continue;
-            bool bWaiting = false;
-            for( auto i = graph.lower_bound( task ), iEnd = graph.upper_bound( task ); i != iEnd; ++i )
+            return false;
+        }
+    }
+    return true;
+}
+
+void Schedule::complete( const TaskDescriptor& task, bool bOutputsChanged )
+{
+    if( !m_complete.insert( task ).second )
+    {
+        return;
+    }
+    m_ready.erase( task );
+    m_taken.erase( task );
+
+    const Dependencies::Graph& graph = m_dependencies.getDependencies();
+    auto                       markTainted = [ & ]( const TaskDescriptor& completed, bool bChanged )
+    {
+        bool bTainted = bChanged;
+        for( auto i = graph.lower_bound( completed ), iEnd = graph.upper_bound( completed ); i != iEnd && !bTainted;
+             ++i )
+        {
+            bTainted = m_tainted.count( i->second ) != 0U;
+        }
+        if( bTainted )
+        {
+            m_tainted.insert( completed );
+        }
+    };
+    markTainted( task, bOutputsChanged );
+
+    // skipping a task completes it in turn so its dependents are visited with the same worklist
+    std::vector< TaskDescriptor > completed{ task };
+    while( !completed.empty() )
+    {
+        const TaskDescriptor next = completed.back();
+        completed.pop_back();
+        for( auto i = m_dependents.lower_bound( next ), iEnd = m_dependents.upper_bound( next ); i != iEnd; ++i )
+        {
+            if( --m_inDegree[ i->second ] == 0U )
             {
-                if( !m_complete.count( i->second ) )
+                if( canSkip( i->second ) )
                 {
-                    bWaiting = true;
-                    break;
+                    m_complete.insert( i->second );
+                    m_skipped.insert( i->second );
+                    completed.push_back( i->second );
+                }
+                else
+                {
+                    m_ready.insert( i->second );
                 }
-            }
-            if( !bWaiting )
-            {
-                ready.push_back( task );
             }
         }
     }
-    return ready;
 }
 
 std::vector< TaskDescriptor > Schedule::getTasks( const std::string& strTaskName ) const
@@ -212,14 +301,18 @@ Schedule Schedule::getUpTo( const std::string& strTaskName, bool bInclusive ) co
 {
     auto result = getTasks( strTaskName );
     VERIFY_RTE_MSG( !result.empty(), "Failed to locate tasks: " << strTaskName );
-    return { Dependencies( m_dependencies, result, bInclusive ) };
+    Schedule schedule( Dependencies( m_dependencies, result, bInclusive ) );
+    schedule.setEarlyCutoff( m_cutoffCandidates );
+    return schedule;
 }
 
 Schedule Schedule::getUpTo( const std::string& strTaskName, const std::string& strSourceFile, bool bInclusive ) const
 {
     std::optional< TaskDescriptor > result = getTask( strTaskName, strSourceFile );
     VERIFY_RTE_MSG( result.has_value(), "Failed to locate task: " << strTaskName << " with source: " << strSourceFile );
-    return { Dependencies( m_dependencies, { result.value() }, bInclusive ) };
+    Schedule schedule( Dependencies( m_dependencies, { result.value() }, bInclusive ) );
+    schedule.setEarlyCutoff( m_cutoffCandidates );
+    return schedule;
 }
 
 Stash::~Stash() = default;
@@ -267,13 +360,109 @@ Pipeline::Ptr Registry::getPipeline( const mega::utilities::ToolChain& toolChain
     }
 }
 
+bool executeSchedule( Schedule& schedule, U32 uiWorkers,
+                      const std::function< bool( const TaskDescriptor& ) >& executeTask,
+                      const std::function< bool( const TaskDescriptor& ) >& outputsChanged )
+{
+    VERIFY_RTE_MSG( uiWorkers != 0U, "Pipeline execution requires at least one worker" );
+
+    std::mutex                   mutex;
+    std::condition_variable      condition;
+    std::deque< TaskDescriptor > readyQueue;
+    U32                          uiRunning = 0U;
+    bool                         bFailed   = false;
+    std::exception_ptr           pException;
+
+    auto feed = [ & ]()
+    {
+        for( const TaskDescriptor& task : schedule.takeReady() )
+        {
+            readyQueue.push_back( task );
+        }
+    };
+
+    auto worker = [ & ]()
+    {
+        std::unique_lock< std::mutex > lock( mutex );
+        while( true )
+        {
+            // stop on failure or when nothing is queued or running
+            if( bFailed || ( readyQueue.empty() && ( uiRunning == 0U ) ) )
+            {
+                condition.notify_all();
+                return;
+            }
+            if( readyQueue.empty() )
+            {
+                condition.wait( lock );
+                continue;
+            }
+
+            const TaskDescriptor task = readyQueue.front();
+            readyQueue.pop_front();
+            ++uiRunning;
+
+            lock.unlock();
+            bool bSuccess = false, bChanged = true;
+            try
+            {
+                bSuccess = executeTask( task );
+                if( bSuccess && outputsChanged )
+                {
+                    bChanged = outputsChanged( task );
+                }
+            }
+            catch( ... )
+            {
+                bSuccess = false;
+                lock.lock();
+                pException = std::current_exception();
+                lock.unlock();
+            }
+            lock.lock();
+
+            --uiRunning;
+            if( bSuccess )
+            {
+                schedule.complete( task, bChanged );
+                feed();
+            }
+            else
+            {
+                bFailed = true;
+            }
+            condition.notify_all();
+        }
+    };
+
+    feed();
+    {
+        std::vector< std::thread > threads;
+        for( U32 ui = 1U; ui < uiWorkers; ++ui )
+        {
+            threads.emplace_back( worker );
+        }
+        worker();
+        for( std::thread& thread : threads )
+        {
+            thread.join();
+        }
+    }
+
+    if( pException )
+    {
+        std::rethrow_exception( pException );
+    }
+    return !bFailed && schedule.isComplete();
+}
+
 PipelineResult runPipelineLocally( const boost::filesystem::path&           stashDir,
                                    std::optional< boost::filesystem::path > symbolFile,
                                    const mega::utilities::ToolChain&        toolChain,
                                    const mega::pipeline::Configuration& pipelineConfig, const std::string& strTaskName,
                                    const std::string&             strSourceFile,
                                    const boost::filesystem::path& inputPipelineResultPath, bool bForceNoStash,
-                                   bool bExecuteUpTo, bool bInclusive, std::ostream& osLog )
+                                   bool bExecuteUpTo, bool bInclusive, std::ostream& osLog, U32 uiWorkers )
 {
     VERIFY_RTE_MSG( !stashDir.empty(), "Local pipeline execution requires stash directry" );
     task::Stash          stash( stashDir );
@@ -288,6 +477,9 @@ PipelineResult runPipelineLocally( const boost::filesystem::path&           stas
     }
 
     // load previous builds hash codes
+    const std::string                strToolChainHash = toolChain.toolChainHash.toHexString();
+    PipelineResult::BuildHashCodeMap previousBuildHashCodes;
+    std::string                      strPreviousToolChainHash;
     if( !inputPipelineResultPath.empty() )
     {
         mega::pipeline::PipelineResult buildPipelineResult;
@@ -295,88 +487,145 @@ PipelineResult runPipelineLocally( const boost::filesystem::path&           stas
         boost::archive::xml_iarchive archive( *pInFileStream );
         archive&                     boost::serialization::make_nvp( "PipelineResult", buildPipelineResult );
         buildHashCodes.set( buildPipelineResult.getBuildHashCodes() );
+        previousBuildHashCodes   = buildPipelineResult.getBuildHashCodes();
+        strPreviousToolChainHash = buildPipelineResult.getToolChainHash();
     }
     osLog << "Initialising pipeline" << std::endl;
 
     mega::pipeline::Pipeline::Ptr pPipeline = mega::pipeline::Registry::getPipeline( toolChain, pipelineConfig, osLog );
 
-    mega::pipeline::PipelineResult pipelineResult( true, "", buildHashCodes.get() );
+    mega::pipeline::PipelineResult pipelineResult( true, "", buildHashCodes.get(), strToolChainHash );
 
+    // guards the stash and build hash codes which both the progress report and the stash use from every worker
+    std::mutex stashMutex;
+
+    // tasks report from every worker thread so each callback takes the lock
     struct ProgressReport : public mega::pipeline::Progress
     {
         mega::pipeline::PipelineResult& m_pipelineResult;
         task::Stash&                    m_stash;
         task::BuildHashCodes&           m_buildHashCodes;
+        std::mutex&                     m_stashMutex;
         std::ostream&                   m_osLog;
         using clock = std::chrono::steady_clock;
-        std::chrono::time_point< clock > m_stopWatch;
+        std::map< std::thread::id, std::chrono::time_point< clock > > m_stopWatches;
+        std::mutex                                                    m_mutex;
 
         ProgressReport( mega::pipeline::PipelineResult& pipelineResult, task::Stash& stash,
-                        task::BuildHashCodes& buildHashCodes, std::ostream& osLog )
+                        task::BuildHashCodes& buildHashCodes, std::mutex& stashMutex, std::ostream& osLog )
             : m_pipelineResult( pipelineResult )
             , m_stash( stash )
             , m_buildHashCodes( buildHashCodes )
+            , m_stashMutex( stashMutex )
             , m_osLog( osLog )
         {
         }
         virtual void onStarted( const std::string& )
         {
-            m_stopWatch = clock::now();
+            std::lock_guard< std::mutex > lock( m_mutex );
+            m_stopWatches[ std::this_thread::get_id() ] = clock::now();
             // m_osLog << strMsg << std::endl;
         }
-        virtual void onProgress( const std::string& strMsg ) { m_osLog << strMsg << std::endl; }
+        virtual void onProgress( const std::string& strMsg )
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            m_osLog << strMsg << std::endl;
+        }
         virtual void onFailed( const std::string& strMsg )
         {
-            m_osLog << common::printDuration( common::elapsed( m_stopWatch ) ) << " " << strMsg << std::endl;
-            m_pipelineResult = mega::pipeline::PipelineResult( false, strMsg, m_buildHashCodes.get() );
+            std::lock_guard< std::mutex > lock( m_mutex );
+            m_osLog << common::printDuration( common::elapsed( m_stopWatches[ std::this_thread::get_id() ] ) ) << " "
+                    << strMsg << std::endl;
+            PipelineResult::BuildHashCodeMap buildHashCodes;
+            {
+                // other workers may still be setting build hash codes
+                std::lock_guard< std::mutex > stashLock( m_stashMutex );
+                buildHashCodes = m_buildHashCodes.get();
+            }
+            m_pipelineResult = mega::pipeline::PipelineResult( false, strMsg, buildHashCodes );
         }
         virtual void onCompleted( const std::string& strMsg )
         {
-            m_osLog << common::printDuration( common::elapsed( m_stopWatch ) ) << " " << strMsg << std::endl;
+            std::lock_guard< std::mutex > lock( m_mutex );
+            m_osLog << common::printDuration( common::elapsed( m_stopWatches[ std::this_thread::get_id() ] ) ) << " "
+                    << strMsg << std::endl;
+        }
+        bool succeeded()
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            return m_pipelineResult.getSuccess();
         }
-    } progressReporter( pipelineResult, stash, buildHashCodes, osLog );
+    } progressReporter( pipelineResult, stash, buildHashCodes, stashMutex, osLog );
 
+    // tasks set the build hash code of each output so comparing against the previous build
+    // on the worker thread running the task determines if the task changed any output
     struct StashImpl : public mega::pipeline::Stash
     {
-        task::Stash&          m_stash;
-        task::BuildHashCodes& m_buildHashCodes;
-        SymbolTable&          m_symbolTable;
-        bool                  bForceNoStash;
-
-        StashImpl( task::Stash& stash, task::BuildHashCodes& buildHashCodes, SymbolTable& symbolTable,
-                   bool _bForceNoStash )
+        task::Stash&                            m_stash;
+        task::BuildHashCodes&                   m_buildHashCodes;
+        const PipelineResult::BuildHashCodeMap& m_previousBuildHashCodes;
+        SymbolTable&                            m_symbolTable;
+        bool                                    bForceNoStash;
+        std::set< std::thread::id >             m_outputsChanged;
+        std::mutex&                             m_mutex;
+
+        StashImpl( task::Stash& stash, task::BuildHashCodes& buildHashCodes,
+                   const PipelineResult::BuildHashCodeMap& previousBuildHashCodes, SymbolTable& symbolTable,
+                   bool _bForceNoStash, std::mutex& stashMutex )
             : m_stash( stash )
             , m_buildHashCodes( buildHashCodes )
+            , m_previousBuildHashCodes( previousBuildHashCodes )
             , m_symbolTable( symbolTable )
             , bForceNoStash( _bForceNoStash )
+            , m_mutex( stashMutex )
         {
         }
 
+        bool takeOutputsChanged()
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            return m_outputsChanged.erase( std::this_thread::get_id() ) != 0U;
+        }
+
         virtual task::FileHash getBuildHashCode( const boost::filesystem::path& filePath )
         {
+            std::lock_guard< std::mutex > lock( m_mutex );
             return m_buildHashCodes.get( filePath );
         }
         virtual void setBuildHashCode( const boost::filesystem::path& filePath, task::FileHash hashCode )
         {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            auto iFind = m_previousBuildHashCodes.find( filePath );
+            if( ( iFind == m_previousBuildHashCodes.end() ) || !( iFind->second == hashCode ) )
+            {
+                m_outputsChanged.insert( std::this_thread::get_id() );
+            }
             m_buildHashCodes.set( filePath, hashCode );
         }
         virtual void stash( const boost::filesystem::path& file, task::DeterminantHash code )
         {
+            std::lock_guard< std::mutex > lock( m_mutex );
             m_stash.stash( file, code );
         }
         virtual bool restore( const boost::filesystem::path& file, task::DeterminantHash code )
         {
             if( bForceNoStash )
                 return false;
+            std::lock_guard< std::mutex > lock( m_mutex );
             return m_stash.restore( file, code );
         }
-        virtual mega::SymbolTable getSymbolTable() { return m_symbolTable; }
+        virtual mega::SymbolTable getSymbolTable()
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            return m_symbolTable;
+        }
         virtual mega::SymbolTable newSymbols( const mega::SymbolRequest& request )
         {
+            std::lock_guard< std::mutex > lock( m_mutex );
             m_symbolTable.add( request );
             return m_symbolTable;
         }
-    } stashImpl( stash, buildHashCodes, symbolTable, bForceNoStash );
+    } stashImpl( stash, buildHashCodes, previousBuildHashCodes, symbolTable, bForceNoStash, stashMutex );
 
     struct DependenciesImpl : public mega::pipeline::DependencyProvider
     {
@@ -452,29 +701,64 @@ PipelineResult runPipelineLocally( const boost::filesystem::path&           stas
             }
         }
 
-        while( !schedule.isComplete() && pipelineResult.getSuccess() )
+        // skipped tasks keep the outputs and hash codes of the previous build so early cutoff
+        // requires those hash codes and must not apply when the stash is being bypassed
+        bool bEarlyCutoff = !previousBuildHashCodes.empty() && !bForceNoStash;
+        if( bEarlyCutoff && ( strPreviousToolChainHash != strToolChainHash ) )
         {
-            bool bProgress = false;
-
-            for( const mega::pipeline::TaskDescriptor& task : schedule.getReady() )
+            // every determinant includes the tool chain so a skipped task would keep stale outputs
+            osLog << "Tool chain changed since the previous build so early cutoff is disabled" << std::endl;
+            bEarlyCutoff = false;
+        }
+        if( bEarlyCutoff )
+        {
+            for( const auto& [ filePath, hashCode ] : previousBuildHashCodes )
             {
-                pPipeline->execute( task, progressReporter, stashImpl, dependencies );
-                if( !pipelineResult.getSuccess() )
+                if( !boost::filesystem::exists( filePath ) )
                 {
-                    osLog << "Pipeline task: " << task.getName() << " " << task.getSourceFile()
-                          << "failed: " << pipelineResult.getMessage() << std::endl;
-                    THROW_RTE( "Pipeline task: " << task.getName() << " " << task.getSourceFile()
-                                                 << "failed: " << pipelineResult.getMessage() );
+                    osLog << "Previous build output missing: " << filePath.string()
+                          << " so early cutoff is disabled" << std::endl;
+                    bEarlyCutoff = false;
                     break;
                 }
-                schedule.complete( task );
-                bProgress = true;
             }
-            VERIFY_RTE_MSG( bProgress, "Failed to make progress executing pipeline: " << pipelineResult.getMessage() );
         }
+        osLog << "Executing pipeline with " << uiWorkers << " workers"
+              << ( bEarlyCutoff ? " and early cutoff" : "" ) << std::endl;
+
+        std::function< bool( const mega::pipeline::TaskDescriptor& ) > outputsChanged;
+        if( bEarlyCutoff )
+        {
+            outputsChanged = [ & ]( const mega::pipeline::TaskDescriptor& )
+            { return stashImpl.takeOutputsChanged(); };
+        }
+        const bool bCompleted = executeSchedule(
+            schedule, uiWorkers,
+            [ & ]( const mega::pipeline::TaskDescriptor& task )
+            {
+                stashImpl.takeOutputsChanged();
+                pPipeline->execute( task, progressReporter, stashImpl, dependencies );
+                return progressReporter.succeeded();
+            },
+            outputsChanged );
+
+        for( const mega::pipeline::TaskDescriptor& task : schedule.getSkipped() )
+        {
+            osLog << "Skipped unchanged: " << task.getName() << " " << task.getSourceFile() << std::endl;
+        }
+        osLog << "Early cutoff skipped " << schedule.getSkipped().size() << " of "
+              << schedule.getDependencies().getTasks().size() << " tasks" << std::endl;
+        if( !pipelineResult.getSuccess() )
+        {
+            osLog << "Pipeline failed: " << pipelineResult.getMessage() << std::endl;
+            THROW_RTE( "Pipeline failed: " << pipelineResult.getMessage() );
+        }
+        VERIFY_RTE_MSG( bCompleted, "Failed to make progress executing pipeline: " << pipelineResult.getMessage() );
         if( pipelineResult.getSuccess() )
         {
-            pipelineResult = mega::pipeline::PipelineResult( true, "", buildHashCodes.get() );
+            std::ostringstream os;
+            os << "Early cutoff skipped " << schedule.getSkipped().size() << " tasks";
+            pipelineResult = mega::pipeline::PipelineResult( true, os.str(), buildHashCodes.get(), strToolChainHash );
         }
     }
 
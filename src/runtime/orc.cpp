@@ -33,7 +33,10 @@
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/DataLayout.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/IRBuilder.h"
 
+#include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
 #include "llvm/ExecutionEngine/JITSymbol.h"
@@ -56,15 +59,26 @@
 
 #include "llvm/IRReader/IRReader.h"
 
+#include "llvm/Passes/OptimizationLevel.h"
+#include "llvm/Passes/PassBuilder.h"
+
 #include "llvm/Target/TargetMachine.h"
 
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
 
 #include "common/clang_warnings_end.hpp"
 ////////////////////////////////////////
 
+#include <boost/filesystem/operations.hpp>
+
+#include <mutex>
+#include <vector>
+
 namespace mega::runtime
 {
 namespace
@@ -84,31 +98,156 @@ llvm::ExitOnError ExitOnErr;
 
 Orc::Module::~Module() = default;
 
-class ModuleImpl : public Orc::Module
+// Persists the object code of any module whose identifier is an object file path.
+// Modules compiled without a cache path are identified by a uuid and are not written.
+// Cache hits never reach here since Orc::load links the object file directly.
+class PersistentObjectCache : public llvm::ObjectCache
+{
+public:
+    static constexpr const char* OBJECT_FILE_EXTENSION = ".o";
+
+    static bool isCached( const std::string& strModuleID )
+    {
+        return boost::filesystem::path( strModuleID ).extension() == OBJECT_FILE_EXTENSION;
+    }
+
+    virtual void notifyObjectCompiled( const llvm::Module* pModule, llvm::MemoryBufferRef object ) override
+    {
+        const std::string strModuleID = pModule->getModuleIdentifier();
+        if( !isCached( strModuleID ) )
+        {
+            return;
+        }
+
+        // write to a temporary and rename so a concurrent executor never links a partial object
+        const boost::filesystem::path objectFilePath = strModuleID;
+        const boost::filesystem::path tempFilePath   = objectFilePath.string() + "." + common::uuid();
+        {
+            std::error_code      ec;
+            llvm::raw_fd_ostream os( tempFilePath.string(), ec, llvm::sys::fs::OF_None );
+            VERIFY_RTE_MSG( !ec, "Failed to write object file: " << tempFilePath.string() << " : " << ec.message() );
+            os << object.getBuffer();
+        }
+        boost::filesystem::rename( tempFilePath, objectFilePath );
+    }
+
+    virtual std::unique_ptr< llvm::MemoryBuffer > getObject( const llvm::Module* ) override { return nullptr; }
+};
+
+static const std::string INVOCATION_COUNTER_PREFIX = "__mega_invocations_";
+static const std::string ACTIVE_COUNTER_PREFIX     = "__mega_active_";
+
+// Each externally visible function gets a counter global incremented on entry so the
+// runtime can find hot functions to recompile at Orc::eOptimised and an active count
+// held for the duration of the call so a replaced module is only unloaded once idle.
+// A function that unwinds leaves its active count raised so its module is never unloaded.
+void instrumentInvocations( llvm::Module& module )
 {
-    // A function object that creates a simple pass pipeline to apply to each
-    // module as it passes through the IRTransformLayer.
-    /*class MyOptimizationTransform
+    llvm::Type* pI64 = llvm::Type::getInt64Ty( module.getContext() );
+    for( llvm::Function& function : module )
     {
-    public:
-        MyOptimizationTransform()
-            : PM( std::make_unique< llvm::legacy::PassManager >() )
+        if( function.isDeclaration() || !function.hasExternalLinkage() )
+        {
+            continue;
+        }
+        auto pCounter = new llvm::GlobalVariable( module, pI64, false, llvm::GlobalValue::ExternalLinkage,
+                                                  llvm::ConstantInt::get( pI64, 0 ),
+                                                  INVOCATION_COUNTER_PREFIX + function.getName().str() );
+
+        llvm::BasicBlock& entry = function.getEntryBlock();
+        llvm::IRBuilder<> builder( &entry, entry.getFirstInsertionPt() );
+        builder.CreateAtomicRMW( llvm::AtomicRMWInst::Add, pCounter, llvm::ConstantInt::get( pI64, 1 ),
+                                 llvm::MaybeAlign(), llvm::AtomicOrdering::Monotonic );
+
+        // nothing can be inserted between a musttail call and its return so such functions have
+        // no active count and their module is never unloaded
+        std::vector< llvm::ReturnInst* > returns;
+        bool                             bMustTail = false;
+        for( llvm::BasicBlock& block : function )
+        {
+            if( auto pReturn = llvm::dyn_cast< llvm::ReturnInst >( block.getTerminator() ) )
+            {
+                returns.push_back( pReturn );
+                bMustTail = bMustTail || block.getTerminatingMustTailCall();
+            }
+        }
+        if( bMustTail )
         {
-            PM->add( llvm::createTailCallEliminationPass() );
-            PM->add( llvm::createFunctionInliningPass() );
-            PM->add( llvm::createIndVarSimplifyPass() );
-            PM->add( llvm::createCFGSimplificationPass() );
+            continue;
         }
-        llvm::Expected< llvm::orc::ThreadSafeModule > operator()( llvm::orc::ThreadSafeModule               TSM,
-                                                                  llvm::orc::MaterializationResponsibility& R )
+
+        auto pActive = new llvm::GlobalVariable( module, pI64, false, llvm::GlobalValue::ExternalLinkage,
+                                                 llvm::ConstantInt::get( pI64, 0 ),
+                                                 ACTIVE_COUNTER_PREFIX + function.getName().str() );
+        builder.CreateAtomicRMW( llvm::AtomicRMWInst::Add, pActive, llvm::ConstantInt::get( pI64, 1 ),
+                                 llvm::MaybeAlign(), llvm::AtomicOrdering::Monotonic );
+        for( llvm::ReturnInst* pReturn : returns )
         {
-            TSM.withModuleDo( [ this ]( llvm::Module& M ) { PM->run( M ); } );
-            return std::move( TSM );
+            builder.SetInsertPoint( pReturn );
+            builder.CreateAtomicRMW( llvm::AtomicRMWInst::Sub, pActive, llvm::ConstantInt::get( pI64, 1 ),
+                                     llvm::MaybeAlign(), llvm::AtomicOrdering::Release );
         }
-    private:
-        std::unique_ptr< llvm::legacy::PassManager > PM;
-    };*/
+    }
+}
+
+void optimiseModule( llvm::Module& module, llvm::TargetMachine* pTargetMachine )
+{
+    llvm::LoopAnalysisManager     loopAnalysis;
+    llvm::FunctionAnalysisManager functionAnalysis;
+    llvm::CGSCCAnalysisManager    cgsccAnalysis;
+    llvm::ModuleAnalysisManager   moduleAnalysis;
+
+    llvm::PassBuilder passBuilder( pTargetMachine );
+    passBuilder.registerModuleAnalyses( moduleAnalysis );
+    passBuilder.registerCGSCCAnalyses( cgsccAnalysis );
+    passBuilder.registerFunctionAnalyses( functionAnalysis );
+    passBuilder.registerLoopAnalyses( loopAnalysis );
+    passBuilder.crossRegisterProxies( loopAnalysis, functionAnalysis, cgsccAnalysis, moduleAnalysis );
+
+    // all functions in the module are optimised together so calls between them can be inlined
+    llvm::ModulePassManager passManager = passBuilder.buildPerModuleDefaultPipeline( llvm::OptimizationLevel::O3 );
+    passManager.run( module, moduleAnalysis );
+}
+
+std::unique_ptr< llvm::orc::LLJIT > createJIT( Orc::Tier tier, llvm::ObjectCache* pObjectCache )
+{
+    auto JTMB = ExitOnErr( llvm::orc::JITTargetMachineBuilder::detectHost() );
+    JTMB.setCodeGenOptLevel( tier == Orc::eQuick ? llvm::CodeGenOpt::None : llvm::CodeGenOpt::Aggressive );
+
+    auto pJIT = ExitOnErr( llvm::orc::LLJITBuilder()
+                               .setJITTargetMachineBuilder( JTMB )
+                               .setCompileFunctionCreator(
+                                   [ pObjectCache ]( llvm::orc::JITTargetMachineBuilder JTMB_ )
+                                       -> llvm::Expected< std::unique_ptr< llvm::orc::IRCompileLayer::IRCompiler > >
+                                   {
+                                       return std::make_unique< llvm::orc::ConcurrentIRCompiler >(
+                                           std::move( JTMB_ ), pObjectCache );
+                                   } )
+                               .create() );
+
+    // counters are added when the module is parsed since symbols cannot be added by a transform
+    if( tier == Orc::eOptimised )
+    {
+        pJIT->getIRTransformLayer().setTransform(
+            [ JTMB ]( llvm::orc::ThreadSafeModule TSM, llvm::orc::MaterializationResponsibility& ) mutable
+            -> llvm::Expected< llvm::orc::ThreadSafeModule >
+            {
+                auto pTargetMachine = JTMB.createTargetMachine();
+                if( !pTargetMachine )
+                {
+                    return pTargetMachine.takeError();
+                }
+                TSM.withModuleDo( [ &pTargetMachine ]( llvm::Module& module )
+                                  { optimiseModule( module, pTargetMachine->get() ); } );
+                return std::move( TSM );
+            } );
+    }
+
+    return pJIT;
+}
 
+class ModuleImpl : public Orc::Module
+{
     llvm::Error createSMDiagnosticError( llvm::SMDiagnostic& Diag )
     {
         using namespace llvm;
@@ -132,21 +271,50 @@ class ModuleImpl : public Orc::Module
         return createSMDiagnosticError( Err );
     }
 
+    void addProcessSymbols()
+    {
+        m_jitDynLib.addGenerator( ExitOnErr( llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+            m_jit.getDataLayout().getGlobalPrefix() ) ) );
+    }
+
 public:
-    ModuleImpl( llvm::orc::LLJIT& jit, const std::string& strModule )
+    struct IR
+    {
+    };
+    struct Object
+    {
+    };
+
+    // strModuleID is the object file path when the compiled object should be cached
+    ModuleImpl( IR, llvm::orc::LLJIT& jit, Orc::Tier tier, const std::string& strModule,
+                const std::string& strModuleID )
         : m_name( common::uuid() )
         , m_jit( jit )
         , m_jitDynLib( ExitOnErr( m_jit.createJITDylib( m_name ) ) )
     {
-        // m_jit.getIRTransformLayer().setTransform( MyOptimizationTransform() );
-
-        m_jitDynLib.addGenerator( ExitOnErr( llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
-            m_jit.getDataLayout().getGlobalPrefix() ) ) );
+        addProcessSymbols();
 
-        auto jitModule = ExitOnErr( parseModule( strModule, m_name ) );
+        auto jitModule = ExitOnErr( parseModule( strModule, strModuleID.empty() ? m_name : strModuleID ) );
+        if( tier == Orc::eQuick )
+        {
+            jitModule.withModuleDo( []( llvm::Module& module ) { instrumentInvocations( module ); } );
+        }
         ExitOnErr( m_jit.addIRModule( m_jitDynLib, std::move( jitModule ) ) );
     }
 
+    ModuleImpl( Object, llvm::orc::LLJIT& jit, const boost::filesystem::path& objectFilePath )
+        : m_name( common::uuid() )
+        , m_jit( jit )
+        , m_jitDynLib( ExitOnErr( m_jit.createJITDylib( m_name ) ) )
+    {
+        addProcessSymbols();
+
+        // no null terminator required so large objects are memory mapped rather than read
+        auto pObjectBuffer = ExitOnErr( llvm::errorOrToExpected( llvm::MemoryBuffer::getFile(
+            objectFilePath.string(), /*IsText*/ false, /*RequiresNullTerminator*/ false ) ) );
+        ExitOnErr( m_jit.addObjectFile( m_jitDynLib, std::move( pObjectBuffer ) ) );
+    }
+
     ~ModuleImpl() { ExitOnErr( m_jit.getExecutionSession().removeJITDylib( m_jitDynLib ) ); }
 
     virtual void* getRawFunctionPtr( const std::string& strSymbol )
@@ -156,7 +324,28 @@ public:
         return reinterpret_cast< void* >( functionPtr.getValue() );
     }
 
+    virtual U64* getRawInvocationCounter( const std::string& strSymbol )
+    {
+        return getCounter( INVOCATION_COUNTER_PREFIX + strSymbol );
+    }
+
+    virtual U64* getRawActiveCounter( const std::string& strSymbol )
+    {
+        return getCounter( ACTIVE_COUNTER_PREFIX + strSymbol );
+    }
+
 private:
+    U64* getCounter( const std::string& strCounterSymbol )
+    {
+        auto counterPtr = m_jit.lookup( m_jitDynLib, strCounterSymbol );
+        if( !counterPtr )
+        {
+            llvm::consumeError( counterPtr.takeError() );
+            return nullptr;
+        }
+        return reinterpret_cast< U64* >( counterPtr->getValue() );
+    }
+
     const std::string    m_name;
     llvm::orc::LLJIT&    m_jit;
     llvm::orc::JITDylib& m_jitDynLib;
@@ -167,7 +356,9 @@ class Orc::Pimpl
 public:
     Pimpl( const mega::MegastructureInstallation& megastructureInstallation )
         : m_megastructureInstallation( megastructureInstallation )
-        , m_pLLJit( ExitOnErr( llvm::orc::LLJITBuilder().create() ) )
+        , m_pObjectCache( std::make_unique< PersistentObjectCache >() )
+        , m_pQuickJIT( createJIT( Orc::eQuick, m_pObjectCache.get() ) )
+        , m_pOptimisedJIT( createJIT( Orc::eOptimised, m_pObjectCache.get() ) )
     {
         // ensure symbols available for megastructure libs
         /*{
@@ -180,31 +371,52 @@ public:
                 m_pLLJit->getDataLayout().getGlobalPrefix() ) ) );
         }*/
 
-        m_pLLJit->getMainJITDylib().addGenerator(
-            ExitOnErr( llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
-                m_pLLJit->getDataLayout().getGlobalPrefix() ) ) );
+        for( auto pJIT : { m_pQuickJIT.get(), m_pOptimisedJIT.get() } )
+        {
+            pJIT->getMainJITDylib().addGenerator( ExitOnErr(
+                llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess( pJIT->getDataLayout().getGlobalPrefix() ) ) );
+        }
+    }
+
+    llvm::orc::LLJIT& getJIT( Orc::Tier tier ) { return tier == Orc::eQuick ? *m_pQuickJIT : *m_pOptimisedJIT; }
+
+    std::shared_ptr< ModuleImpl > compile( const std::string& strModule, const std::string& strModuleID, Orc::Tier tier )
+    {
+        return track( new ModuleImpl( ModuleImpl::IR{}, getJIT( tier ), tier, strModule, strModuleID ) );
     }
 
-    std::shared_ptr< ModuleImpl > compile( const std::string& strModule )
+    std::shared_ptr< ModuleImpl > load( const boost::filesystem::path& objectFilePath, Orc::Tier tier )
+    {
+        return track( new ModuleImpl( ModuleImpl::Object{}, getJIT( tier ), objectFilePath ) );
+    }
+
+    std::shared_ptr< ModuleImpl > track( ModuleImpl* pModuleImpl )
     {
         Pimpl*                        pThis = this;
         std::shared_ptr< ModuleImpl > pModule(
-            new ModuleImpl( *m_pLLJit, strModule ), [ pThis ]( Module* pModule_ ) { pThis->unload( pModule_ ); } );
+            pModuleImpl, [ pThis ]( Module* pModule_ ) { pThis->unload( pModule_ ); } );
+        std::lock_guard< std::mutex > lock( m_mutex );
         m_modules.insert( pModule.get() );
         return pModule;
     }
 
     void unload( Module* pModule )
     {
-        auto iFind = m_modules.find( pModule );
-        VERIFY_RTE( iFind != m_modules.end() );
-        m_modules.erase( pModule );
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            auto                          iFind = m_modules.find( pModule );
+            VERIFY_RTE( iFind != m_modules.end() );
+            m_modules.erase( pModule );
+        }
         delete pModule;
     }
 
-    mega::MegastructureInstallation     m_megastructureInstallation;
-    std::unique_ptr< llvm::orc::LLJIT > m_pLLJit;
-    std::set< Module* >                 m_modules;
+    mega::MegastructureInstallation          m_megastructureInstallation;
+    std::unique_ptr< PersistentObjectCache > m_pObjectCache;
+    std::unique_ptr< llvm::orc::LLJIT >      m_pQuickJIT;
+    std::unique_ptr< llvm::orc::LLJIT >      m_pOptimisedJIT;
+    std::mutex                               m_mutex;
+    std::set< Module* >                      m_modules;
 };
 
 Orc::Orc( const mega::MegastructureInstallation& megastructureInstallation )
@@ -214,7 +426,19 @@ Orc::Orc( const mega::MegastructureInstallation& megastructureInstallation )
 
 Orc::Module::Ptr Orc::compile( const std::string& strModule )
 {
-    return m_pPimpl->compile( strModule );
+    return m_pPimpl->compile( strModule, {}, eQuick );
+}
+
+Orc::Module::Ptr Orc::compile( const std::string& strModule, const boost::filesystem::path& objectFilePath, Tier tier )
+{
+    VERIFY_RTE_MSG( PersistentObjectCache::isCached( objectFilePath.string() ),
+                    "Invalid object cache file path: " << objectFilePath.string() );
+    return m_pPimpl->compile( strModule, objectFilePath.string(), tier );
+}
+
+Orc::Module::Ptr Orc::load( const boost::filesystem::path& objectFilePath, Tier tier )
+{
+    return m_pPimpl->load( objectFilePath, tier );
 }
 
 } // namespace mega::runtime
@@ -17,8 +17,8 @@
 //  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
 //  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
 //  OF THE POSSIBILITY OF SUCH DAMAGES.
-
 #include "runtime/runtime.hpp"
+#include "runtime/batch.hpp"
 #include "runtime/functor_dispatch.hpp"
 #include "runtime/functor_id.hxx"
 #include "runtime/clang.hpp"
@@ -27,11 +27,38 @@
 
 #include "il/backend/backend.hpp"
 
+#include "log/log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+
 namespace mega::runtime
 {
+namespace
+{
+// quick tier functions invoked this many times are recompiled at Orc::eOptimised
+static constexpr U64                       HOT_INVOCATIONS    = 10000;
+static constexpr std::chrono::milliseconds TIER_POLL_INTERVAL = std::chrono::milliseconds( 100 );
+
+boost::filesystem::path toOptimisedObjectFilePath( const boost::filesystem::path& objectFilePath )
+{
+    return objectFilePath.parent_path() / ( objectFilePath.stem().string() + "_O3" + objectFilePath.extension().string() );
+}
+
+static_assert( std::is_trivially_copyable_v< FunctorID >, "FunctorID manifest requires trivially copyable FunctorID" );
+} // namespace
 
 Runtime::Runtime( const boost::filesystem::path& tempDir, const MegastructureInstallation& megaInstall )
     : m_tempDir( tempDir )
+    , m_objectCacheDir( tempDir / "objects" )
+    , m_strToolchainHash( megaInstall.getToolchain().toolChainHash.toHexString() )
     , m_clang( megaInstall.getClangPath() )
     , m_orc( megaInstall )
 {
@@ -39,6 +66,12 @@ Runtime::Runtime( const boost::filesystem::path& tempDir, const MegastructureIns
     {
         boost::filesystem::create_directories( m_tempDir );
     }
+    if( !boost::filesystem::exists( m_objectCacheDir ) )
+    {
+        boost::filesystem::create_directories( m_objectCacheDir );
+    }
+
+    m_tierThread = std::jthread( [ this ]( std::stop_token stopToken ) { promoteHotFunctions( stopToken ); } );
 }
 
 void Runtime::loadProgram( const service::Program& program )
@@ -51,11 +84,17 @@ void Runtime::loadProgram( const service::Program& program )
     m_pDatabase.swap( pNewDatabase );
 
     m_program = program;
+
+    // functions materialised by a previous run of the program are batched on the next miss
+    m_prefetchFunctions = loadManifest();
+    m_manifestFunctions = { m_prefetchFunctions.begin(), m_prefetchFunctions.end() };
 }
 void Runtime::unloadProgram()
 {
     m_program = service::Program{};
     m_pDatabase.reset();
+    m_prefetchFunctions.clear();
+    m_manifestFunctions.clear();
 }
 
 service::Program Runtime::getProgram() const
@@ -63,8 +102,193 @@ service::Program Runtime::getProgram() const
     return m_program;
 }
 
+boost::filesystem::path Runtime::getManifestFilePath() const
+{
+    std::ostringstream osFileName;
+    osFileName << m_program << ".functors";
+    return m_tempDir / osFileName.str();
+}
+
+void Runtime::appendManifest( const std::vector< FunctorID >& functorIDs )
+{
+    // one append per materialised batch - only functions not already recorded are written
+    std::ofstream outFile( getManifestFilePath().string(), std::ios::binary | std::ios::app );
+    VERIFY_RTE_MSG( outFile.good(), "Failed to write function manifest: " << getManifestFilePath().string() );
+    for( const auto& functorID : functorIDs )
+    {
+        if( m_manifestFunctions.insert( functorID ).second )
+        {
+            outFile.write( reinterpret_cast< const char* >( &functorID ), sizeof( FunctorID ) );
+        }
+    }
+}
+
+void Runtime::resetManifest()
+{
+    // only rewritten when the manifest is found to be stale
+    std::ofstream outFile( getManifestFilePath().string(), std::ios::binary | std::ios::trunc );
+    VERIFY_RTE_MSG( outFile.good(), "Failed to write function manifest: " << getManifestFilePath().string() );
+    m_manifestFunctions.clear();
+    for( const auto& [ functorID, _ ] : m_materialisedFunctions )
+    {
+        m_manifestFunctions.insert( functorID );
+        outFile.write( reinterpret_cast< const char* >( &functorID ), sizeof( FunctorID ) );
+    }
+}
+
+std::vector< FunctorID > Runtime::loadManifest() const
+{
+    std::vector< FunctorID > functorIDs;
+
+    std::ifstream inFile( getManifestFilePath().string(), std::ios::binary );
+    if( inFile.good() )
+    {
+        std::array< char, sizeof( FunctorID ) > buffer;
+        while( inFile.read( buffer.data(), buffer.size() ) )
+        {
+            functorIDs.push_back( std::bit_cast< FunctorID >( buffer ) );
+        }
+    }
+    return functorIDs;
+}
+
+void Runtime::compile( service::StashProvider& stashProvider, std::vector< Batch >& batches )
+{
+    // resolve from the object cache or stash and start clang for everything else concurrently
+    for( auto& batch : batches )
+    {
+        const task::DeterminantHash determinant{ batch.strCPPCode };
+        batch.uiDeterminant = determinant.get();
+
+        // object code persists across executor restarts keyed on program, functor, determinant and toolchain
+        std::ostringstream osObjectFile;
+        osObjectFile << batch.strName << '_' << determinant.toHexString() << '_' << m_strToolchainHash << ".o";
+        batch.objectFilePath = m_objectCacheDir / osObjectFile.str();
+        batch.irFilePath     = m_tempDir / ( batch.strName + ".ir" );
+
+        // prefer code optimised by a previous run
+        if( const auto optimisedFilePath = toOptimisedObjectFilePath( batch.objectFilePath );
+            boost::filesystem::exists( optimisedFilePath ) )
+        {
+            m_uiObjectCacheHits += batch.functorIDs.size();
+            batch.tier    = Orc::eOptimised;
+            batch.pModule = m_orc.load( optimisedFilePath, Orc::eOptimised );
+        }
+        else if( boost::filesystem::exists( batch.objectFilePath ) )
+        {
+            m_uiObjectCacheHits += batch.functorIDs.size();
+            batch.pModule = m_orc.load( batch.objectFilePath, Orc::eQuick );
+        }
+        else
+        {
+            m_uiObjectCacheMisses += batch.functorIDs.size();
+
+            if( !stashProvider.restore( batch.irFilePath.string(), batch.uiDeterminant ) )
+            {
+                const boost::filesystem::path inputCPPFilePath = m_tempDir / ( batch.strName + ".cpp" );
+                {
+                    auto pFStream = boost::filesystem::createNewFileStream( inputCPPFilePath );
+                    *pFStream << batch.strCPPCode;
+                }
+                batch.compilation
+                    = std::async( std::launch::async,
+                                  [ &clang = m_clang, inputCPPFilePath, irFilePath = batch.irFilePath ]()
+                                  { clang.compileToLLVMIR( inputCPPFilePath, irFilePath, nullptr ); } );
+            }
+        }
+    }
+
+    // the stash provider and ORC are only used from this thread
+    for( auto& batch : batches )
+    {
+        if( !batch.pModule )
+        {
+            if( batch.compilation.valid() )
+            {
+                batch.compilation.get();
+                stashProvider.stash( batch.irFilePath.string(), batch.uiDeterminant );
+            }
+
+            std::ostringstream osIR;
+            boost::filesystem::loadAsciiFile( batch.irFilePath, osIR );
+            batch.pModule = m_orc.compile( osIR.str(), batch.objectFilePath, Orc::eQuick );
+        }
+
+        auto pSource = std::make_shared< const ModuleSource >(
+            ModuleSource{ batch.functorIDs, batch.irFilePath, toOptimisedObjectFilePath( batch.objectFilePath ) } );
+
+        for( const auto& functorID : batch.functorIDs )
+        {
+            FunctionInfo functionInfo{ batch.pModule->get( functorID ), batch.pModule };
+            VERIFY_RTE_MSG( functionInfo.pFunction, "Failed to compiled function: " << functorID );
+            functionInfo.tier    = batch.tier;
+            functionInfo.pSource = pSource;
+            if( batch.tier == Orc::eQuick )
+            {
+                functionInfo.pInvocations = batch.pModule->getInvocationCounter( functorID );
+                functionInfo.pActive      = batch.pModule->getActiveCounter( functorID );
+            }
+            m_materialisedFunctions.insert( { functorID, std::move( functionInfo ) } );
+        }
+    }
+}
+
+void Runtime::materialise( service::StashProvider& stashProvider, const std::vector< FunctorID >& functorIDs )
+{
+    VERIFY_RTE_MSG( m_pDatabase, "No program database loaded when attempting to materialise functions" );
+
+    std::vector< std::pair< FunctorID, std::string > > functions;
+    {
+        std::unordered_set< FunctorID, FunctorID::Hash > unique;
+        for( const auto& functorID : functorIDs )
+        {
+            if( !m_materialisedFunctions.contains( functorID ) && unique.insert( functorID ).second )
+            {
+                const auto functionDef = dispatchFactory( *m_pDatabase, m_materialisedFunctionFactory, functorID );
+                functions.emplace_back( functorID, il::generateCPP( functionDef ) );
+            }
+        }
+    }
+    if( functions.empty() )
+    {
+        return;
+    }
+
+    std::vector< Batch > batches;
+    for( const auto& [ uiBegin, uiEnd ] : partitionBatches( functions.size(), std::thread::hardware_concurrency() ) )
+    {
+        Batch& batch = batches.emplace_back();
+        for( U64 i = uiBegin; i != uiEnd; ++i )
+        {
+            batch.functorIDs.push_back( functions[ i ].first );
+            batch.strCPPCode += functions[ i ].second;
+            batch.strCPPCode += '\n';
+        }
+
+        std::ostringstream osName;
+        osName << m_program << '_' << batch.functorIDs.front();
+        if( batch.functorIDs.size() > 1U )
+        {
+            osName << "_batch_" << batch.functorIDs.size();
+        }
+        batch.strName = osName.str();
+    }
+
+    SPDLOG_TRACE( "RUNTIME: Materialising {} functions in {} batches", functions.size(), batches.size() );
+    compile( stashProvider, batches );
+
+    std::vector< FunctorID > materialised;
+    for( const auto& [ functorID, _ ] : functions )
+    {
+        materialised.push_back( functorID );
+    }
+    appendManifest( materialised );
+}
+
 void Runtime::getFunction( service::StashProvider& stashProvider, const FunctorID& functionID, void** ppFunction )
 {
+    std::lock_guard< std::mutex > lock( m_mutex );
+
     // attempt to find function in hash table
     auto iFind = m_materialisedFunctions.find( functionID );
     if( iFind == m_materialisedFunctions.end() )
@@ -72,48 +296,174 @@ void Runtime::getFunction( service::StashProvider& stashProvider, const FunctorI
         VERIFY_RTE_MSG(
             m_pDatabase, "No program database loaded when attempting to materialise function: " << functionID );
 
-        std::ostringstream osIR;
+        if( !m_prefetchFunctions.empty() )
         {
-            const auto functionDef = dispatchFactory( *m_pDatabase, m_materialisedFunctionFactory, functionID );
+            std::vector< FunctorID > functorIDs;
+            functorIDs.swap( m_prefetchFunctions );
+            functorIDs.push_back( functionID );
+            try
+            {
+                materialise( stashProvider, functorIDs );
+            }
+            catch( std::exception& ex )
+            {
+                // a stale manifest only costs the batch - fall back to materialising the function alone
+                // and drop the stale entries since appending never removes them
+                SPDLOG_WARN( "RUNTIME: Batch materialisation failed with: {}", ex.what() );
+                resetManifest();
+            }
+        }
+
+        iFind = m_materialisedFunctions.find( functionID );
+        if( iFind == m_materialisedFunctions.end() )
+        {
+            materialise( stashProvider, { functionID } );
+            iFind = m_materialisedFunctions.find( functionID );
+            VERIFY_RTE_MSG( iFind != m_materialisedFunctions.end(), "Failed to materialise function: " << functionID );
+        }
+    }
 
-            const std::string           strCPPCode = il::generateCPP( functionDef );
-            const task::DeterminantHash determinant{ strCPPCode };
+    // the tiering thread swaps the same pointers
+    std::atomic_ref< void* >( *ppFunction ).store( iFind->second.pFunction, std::memory_order_release );
 
-            std::ostringstream osFunctionID;
-            osFunctionID << m_program << '_' << functionID;
-            const boost::filesystem::path irFilePath = m_tempDir / ( osFunctionID.str() + ".ir" );
+    // record the pointer to the function pointer so can reset when reprogram
+    iFind->second.functionPointers.push_back( ppFunction );
+}
 
-            if( stashProvider.restore( irFilePath.string(), determinant.get() ) )
+void Runtime::promoteHotFunctions( std::stop_token stopToken )
+{
+    std::unique_lock< std::mutex > lock( m_mutex );
+    while( !m_tierCondition.wait_for( lock, stopToken, TIER_POLL_INTERVAL, [] { return false; } )
+           && !stopToken.stop_requested() )
+    {
+        reclaimRetiredModules( lock );
+
+        std::vector< std::shared_ptr< const ModuleSource > > hotSources;
+        for( const auto& [ functorID, functionInfo ] : m_materialisedFunctions )
+        {
+            if( functionInfo.tier == Orc::eQuick && functionInfo.pInvocations && functionInfo.pSource
+                && std::atomic_ref< U64 >( *functionInfo.pInvocations ).load( std::memory_order_relaxed )
+                       >= HOT_INVOCATIONS
+                && m_promotedSources.insert( functionInfo.pSource.get() ).second )
             {
-                boost::filesystem::loadAsciiFile( irFilePath, osIR );
+                hotSources.push_back( functionInfo.pSource );
             }
-            else
+        }
+
+        for( const auto& pSource : hotSources )
+        {
+            // compile and resolve without the lock - lookup is where ORC actually optimises and generates code
+            Orc::Module::Ptr      pModule;
+            std::vector< void* > functions;
+            lock.unlock();
+            try
             {
-                const boost::filesystem::path inputCPPFilePath = m_tempDir / ( osFunctionID.str() + ".cpp" );
+                if( boost::filesystem::exists( pSource->irFilePath ) )
                 {
-                    auto pFStream = boost::filesystem::createNewFileStream( inputCPPFilePath );
-                    *pFStream << strCPPCode;
+                    std::ostringstream osIR;
+                    boost::filesystem::loadAsciiFile( pSource->irFilePath, osIR );
+                    pModule = m_orc.compile( osIR.str(), pSource->optimisedObjectFilePath, Orc::eOptimised );
+                    for( const auto& functorID : pSource->functorIDs )
+                    {
+                        functions.push_back( pModule->get( functorID ) );
+                    }
                 }
-                m_clang.compileToLLVMIR( inputCPPFilePath, irFilePath, nullptr );
+            }
+            catch( std::exception& ex )
+            {
+                SPDLOG_WARN( "RUNTIME: Failed to optimise hot functions with: {}", ex.what() );
+                pModule.reset();
+            }
+            lock.lock();
 
-                stashProvider.stash( irFilePath.string(), determinant.get() );
-                boost::filesystem::loadAsciiFile( irFilePath, osIR );
+            if( !pModule )
+            {
+                continue;
             }
-        }
 
-        auto pModule = m_orc.compile( osIR.str() );
+            RetiredModule retired;
+            for( U64 i = 0; i != pSource->functorIDs.size(); ++i )
+            {
+                auto iFind = m_materialisedFunctions.find( pSource->functorIDs[ i ] );
+                if( iFind == m_materialisedFunctions.end() || iFind->second.pSource != pSource )
+                {
+                    continue;
+                }
+                FunctionInfo& functionInfo = iFind->second;
+
+                // threads may still be executing the quick code so keep its module alive until idle
+                retired.pModule = std::move( functionInfo.pModule );
+                retired.invocations.push_back( functionInfo.pInvocations );
+                retired.active.push_back( functionInfo.pActive );
+                retired.lastInvocations.push_back(
+                    functionInfo.pInvocations
+                        ? std::atomic_ref< U64 >( *functionInfo.pInvocations ).load( std::memory_order_relaxed )
+                        : 0U );
 
-        void* pFunction = pModule->get( functionID );
-        VERIFY_RTE_MSG( pFunction, "Failed to compiled function: " << functionID );
+                functionInfo.pFunction    = functions[ i ];
+                functionInfo.pModule      = pModule;
+                functionInfo.tier         = Orc::eOptimised;
+                functionInfo.pInvocations = nullptr;
+                functionInfo.pActive      = nullptr;
 
-        FunctionInfo functionInfo{ pFunction, std::move( pModule ) };
-        iFind = m_materialisedFunctions.insert( { functionID, std::move( functionInfo ) } ).first;
+                for( void** ppFunction : functionInfo.functionPointers )
+                {
+                    std::atomic_ref< void* >( *ppFunction ).store( functions[ i ], std::memory_order_release );
+                }
+            }
+            if( retired.pModule )
+            {
+                m_retiredModules.push_back( std::move( retired ) );
+            }
+        }
     }
+}
 
-    *ppFunction = iFind->second.pFunction;
+void Runtime::reclaimRetiredModules( std::unique_lock< std::mutex >& lock )
+{
+    // A retired module is unloaded once none of its functions are executing and none were entered
+    // over the last poll interval - callers that read a function pointer before it was swapped
+    // have had a full interval to enter the quick code and raise its active count.
+    std::vector< Orc::Module::Ptr > reclaimed;
+    for( auto i = m_retiredModules.begin(); i != m_retiredModules.end(); )
+    {
+        bool bIdle = true;
+        for( U64 j = 0; j != i->active.size(); ++j )
+        {
+            if( !i->active[ j ] || !i->invocations[ j ] )
+            {
+                // without the counters cannot tell when it is idle
+                bIdle = false;
+                break;
+            }
+            const U64 uiInvocations
+                = std::atomic_ref< U64 >( *i->invocations[ j ] ).load( std::memory_order_relaxed );
+            if( std::atomic_ref< U64 >( *i->active[ j ] ).load( std::memory_order_acquire ) != 0U
+                || uiInvocations != i->lastInvocations[ j ] )
+            {
+                bIdle = false;
+            }
+            i->lastInvocations[ j ] = uiInvocations;
+        }
 
-    // record the pointer to the function pointer so can reset when reprogram
-    iFind->second.functionPointers.push_back( ppFunction );
+        if( bIdle )
+        {
+            reclaimed.push_back( std::move( i->pModule ) );
+            i = m_retiredModules.erase( i );
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    if( !reclaimed.empty() )
+    {
+        SPDLOG_TRACE( "RUNTIME: Unloading {} retired modules", reclaimed.size() );
+        lock.unlock();
+        reclaimed.clear();
+        lock.lock();
+    }
 }
 
 } // namespace mega::runtime
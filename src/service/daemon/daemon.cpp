@@ -29,6 +29,7 @@
 
 #include <boost/filesystem/operations.hpp>
 #include <boost/asio/ip/host_name.hpp>
+#include <boost/asio/post.hpp>
 
 #include <iostream>
 
@@ -50,6 +51,10 @@ public:
     void run( boost::asio::yield_context& yield_ctx )
     {
         m_daemon.m_machineID = getRootRequest< network::enrole::Request_Encoder >( yield_ctx ).EnroleDaemon();
+
+        // publish the listening port so peer daemons can connect directly in mesh mode
+        getRootRequest< network::enrole::Request_Encoder >( yield_ctx )
+            .EnroleDaemonListen( m_daemon.m_server.getEndPoint().port() );
         // m_daemon.setActiveProject( getRootRequest< network::project::Request_Encoder >( yield_ctx ).GetProject() );
 
         std::ostringstream os;
@@ -63,11 +68,13 @@ public:
 ////////////////////////////////////////////////////////////////
 // Daemon
 Daemon::Daemon( boost::asio::io_context& ioContext, network::Log log, const std::string& strRootIP,
-                short rootPortNumber, short daemonPortNumber )
+                short rootPortNumber, short daemonPortNumber, bool bMesh )
     : network::LogicalThreadManager( network::Node::makeProcessName( network::Node::Daemon ), ioContext )
     , m_log( log )
     , m_rootClient( ioContext, *this, strRootIP, rootPortNumber )
     , m_server( ioContext, *this, daemonPortNumber )
+    , m_bMesh( bMesh )
+    , m_releaseBatches( ioContext )
 {
     m_server.waitForConnection();
 
@@ -88,6 +95,8 @@ void Daemon::getGeneralStatusReport( const URL& url, Branch& report )
 {
     using namespace std::string_literals;
 
+    const std::string strMesh = m_bMesh ? std::to_string( m_peers.size() ) + " peers"s : "off"s;
+
     Table table;
     // clang-format off
     table.m_rows.push_back( { Line{ "    Hostname: "s }, Line{ boost::asio::ip::host_name() } } );
@@ -95,6 +104,7 @@ void Daemon::getGeneralStatusReport( const URL& url, Branch& report )
     table.m_rows.push_back( { Line{ "          IP: "s }, Line{ m_server.getEndPoint().address().to_string() } } );
     table.m_rows.push_back( { Line{ "        PORT: "s }, Line{ std::to_string( m_server.getEndPoint().port() ) } } );
     table.m_rows.push_back( { Line{ "  Machine ID: "s }, Line{ m_machineID } } );
+    table.m_rows.push_back( { Line{ "        Mesh: "s }, Line{ strMesh } } );
     table.m_rows.push_back( { Line{ "    Log File: "s }, Line{ m_log.logFile, report::makeFileURL( url, m_log.logFile ) } } );
     // clang-format on
 
@@ -126,8 +136,29 @@ void Daemon::onLeafDisconnect( mega::runtime::MP leafMP )
     logicalthreadInitiated( std::make_shared< DaemonLeafDisconnect >( *this, leafMP ) );
 }
 
+void Daemon::onPeerDisconnect( runtime::MachineID machineID, const network::Client* pPeer )
+{
+    SPDLOG_TRACE( "Daemon {} lost peer daemon {}", m_machineID, machineID );
+
+    // called from the peer client's own receiver so destroy it once that has returned.
+    // A reconnect may already have replaced the entry so only erase the client that failed.
+    boost::asio::post( m_server.getIOContext(),
+                       [ this, machineID, pPeer ]()
+                       {
+                           if( auto iFind = m_peers.find( machineID );
+                               iFind != m_peers.end() && iFind->second.get() == pPeer )
+                           {
+                               m_peers.erase( iFind );
+                           }
+                       } );
+}
+
 void Daemon::shutdown()
 {
+    for( auto& [ machineID, pPeer ] : m_peers )
+    {
+        pPeer->stop();
+    }
     m_rootClient.stop();
     m_server.stop();
 }
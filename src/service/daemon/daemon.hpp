@@ -20,6 +20,8 @@
 #ifndef DAEMON_25_MAY_2022
 #define DAEMON_25_MAY_2022
 
+#include "release_batches.hpp"
+
 #include "service/network/client.hpp"
 #include "service/network/server.hpp"
 #include "service/network/logical_thread_manager.hpp"
@@ -29,6 +31,10 @@
 
 #include <boost/asio/io_context.hpp>
 
+#include <map>
+#include <memory>
+#include <set>
+
 namespace mega::service
 {
 
@@ -40,7 +46,7 @@ class Daemon : public network::LogicalThreadManager
 public:
     Daemon( boost::asio::io_context& ioContext, network::Log log, const std::string& strRootIP,
             short rootPortNumber   = mega::network::MegaRootPort(),
-            short daemonPortNumber = mega::network::MegaDaemonPort() );
+            short daemonPortNumber = mega::network::MegaDaemonPort(), bool bMesh = false );
 
     void shutdown();
 
@@ -53,13 +59,27 @@ public:
 
 private:
     void onLeafDisconnect( mega::runtime::MP mp );
-
-    network::Log       m_log;
-    network::Client    m_rootClient;
-    network::Server    m_server;
-    runtime::MachineID m_machineID;
+    void onPeerDisconnect( runtime::MachineID machineID, const network::Client* pPeer );
+
+    // direct connections to peer daemons opened lazily in mesh mode
+    using PeerMap = std::map< runtime::MachineID, std::unique_ptr< network::Client > >;
+
+    network::Log                   m_log;
+    network::Client                m_rootClient;
+    network::Server                m_server;
+    runtime::MachineID             m_machineID;
+    const bool                     m_bMesh;
+    PeerMap                        m_peers;
+    std::set< runtime::MachineID > m_connectingPeers;
+    ReleaseBatches                 m_releaseBatches;
 };
 
+// connections from peer daemons take no part in broadcasts to this daemon's leafs
+inline bool isPeerDaemon( const network::Server::Connection& connection )
+{
+    return connection.getTypeOpt().has_value() && connection.getTypeOpt().value() == network::Node::Daemon;
+}
+
 } // namespace mega::service
 
 #endif // DAEMON_25_MAY_2022
@@ -21,6 +21,8 @@
 
 #include "log/log.hpp"
 
+#include "common/string.hpp"
+
 #include "boost/process.hpp"
 
 namespace mega::service
@@ -45,6 +47,25 @@ runtime::MP DaemonRequestLogicalThread::EnroleLeafWithDaemon( const std::string&
     return leafMP;
 }
 
+std::string DaemonRequestLogicalThread::EnroleSharedMemory( const runtime::MP& leafMP, boost::asio::yield_context& )
+{
+    network::Server::Connection::Ptr pConnection
+        = m_daemon.m_server.getConnection( getOriginatingStackResponseSender() );
+    VERIFY_RTE( pConnection );
+
+    // only co-located leafs can share memory - anything else stays on the socket
+    if( leafMP.getMachineID() != m_daemon.m_machineID || !pConnection->isLocal() )
+    {
+        return {};
+    }
+
+    // unique per leaf and created exclusively so another local user cannot claim the name first
+    const std::string strSegmentName = "mega_" + common::uuid();
+    pConnection->createSharedMemory( strSegmentName );
+    SPDLOG_TRACE( "Leaf {} using shared memory {}", leafMP, strSegmentName );
+    return strSegmentName;
+}
+
 void DaemonRequestLogicalThread::EnroleDaemonSpawn( const std::string& strProgram,
                                                     const std::string& strStartupUUID,
                                                     boost::asio::yield_context& )
@@ -71,6 +71,7 @@ int main( int argc, const char* argv[] )
     short                   daemonPortNumber   = mega::network::MegaDaemonPort();
     boost::filesystem::path logFolder          = boost::filesystem::current_path() / "log";
     std::string             strConsoleLogLevel = "warn", strLogFileLevel = "warn";
+    bool                    bMesh              = false;
     {
         bool bShowHelp = false;
 
@@ -87,6 +88,7 @@ int main( int argc, const char* argv[] )
         ( "level",      po::value< std::string >( &strLogFileLevel ),                               "Log file logging level" )
         ( "root",       po::value< short >( &rootPortNumber )->default_value( rootPortNumber ),     "Root port number" )
         ( "port",       po::value< short >( &daemonPortNumber )->default_value( daemonPortNumber ), "Daemon port number" )
+        ( "mesh",       po::bool_switch( &bMesh ),                                                  "Route inter-daemon sim and mpo traffic directly" )
         ;
         // clang-format on
 
@@ -115,7 +117,7 @@ int main( int argc, const char* argv[] )
 
         boost::asio::io_context ioContext( 1 );
 
-        mega::service::Daemon daemon( ioContext, log, strIP, rootPortNumber, daemonPortNumber );
+        mega::service::Daemon daemon( ioContext, log, strIP, rootPortNumber, daemonPortNumber, bMesh );
 
         std::vector< std::thread > threads;
         for( NumThreadsType i = 0; i < uiNumThreads; ++i )
@@ -25,6 +25,9 @@
 
 #include "log/log.hpp"
 
+#include <map>
+#include <optional>
+
 namespace mega::service
 {
 
@@ -33,6 +36,10 @@ void DaemonRequestLogicalThread::MPODestroyed( const runtime::MPO& mpo, boost::a
 {
     for( auto pCon : m_daemon.m_server.getConnections() )
     {
+        if( isPeerDaemon( *pCon ) )
+        {
+            continue;
+        }
         network::memory::Request_Sender sender( *this, pCon->getSender(), yield_ctx );
         sender.MPODestroyed( mpo );
     }
@@ -61,6 +68,7 @@ runtime::TimeStamp DaemonRequestLogicalThread::SimLockRead( const runtime::MPO&
                                                             boost::asio::yield_context& yield_ctx )
 {
     SPDLOG_TRACE( "DaemonRequestLogicalThread::SimLockRead from: {} to: {}", requestingMPO, targetMPO );
+    m_daemon.m_releaseBatches.wait( requestingMPO, yield_ctx );
     if( network::Server::Connection::Ptr pConnection = m_daemon.m_server.findConnection( targetMPO.getMP() ) )
     {
         ASSERT( m_daemon.m_machineID == targetMPO.getMachineID() );
@@ -71,7 +79,8 @@ runtime::TimeStamp DaemonRequestLogicalThread::SimLockRead( const runtime::MPO&
     {
         ASSERT( m_daemon.m_machineID != targetMPO.getMachineID() );
 
-        network::sim::Request_Sender sender( *this, m_daemon.m_rootClient.getSender(), yield_ctx );
+        network::sim::Request_Sender sender(
+            *this, getPeerOrRootSender( targetMPO.getMachineID(), yield_ctx ), yield_ctx );
         return sender.SimLockRead( requestingMPO, targetMPO );
     }
 }
@@ -81,6 +90,7 @@ runtime::TimeStamp DaemonRequestLogicalThread::SimLockWrite( const runtime::MPO&
                                                              boost::asio::yield_context& yield_ctx )
 {
     SPDLOG_TRACE( "DaemonRequestLogicalThread::SimLockWrite from: {} to: {}", requestingMPO, targetMPO );
+    m_daemon.m_releaseBatches.wait( requestingMPO, yield_ctx );
     if( network::Server::Connection::Ptr pConnection = m_daemon.m_server.findConnection( targetMPO.getMP() ) )
     {
         network::sim::Request_Sender sender( *this, pConnection->getSender(), yield_ctx );
@@ -88,7 +98,8 @@ runtime::TimeStamp DaemonRequestLogicalThread::SimLockWrite( const runtime::MPO&
     }
     else
     {
-        network::sim::Request_Sender sender( *this, m_daemon.m_rootClient.getSender(), yield_ctx );
+        network::sim::Request_Sender sender(
+            *this, getPeerOrRootSender( targetMPO.getMachineID(), yield_ctx ), yield_ctx );
         return sender.SimLockWrite( requestingMPO, targetMPO );
     }
 }
@@ -99,6 +110,7 @@ void DaemonRequestLogicalThread::SimLockRelease( const runtime::MPO&         req
                                                  boost::asio::yield_context& yield_ctx )
 {
     SPDLOG_TRACE( "DaemonRequestLogicalThread::SimLockRelease from: {} to: {}", requestingMPO, targetMPO );
+    m_daemon.m_releaseBatches.wait( requestingMPO, yield_ctx );
     if( network::Server::Connection::Ptr pConnection = m_daemon.m_server.findConnection( targetMPO.getMP() ) )
     {
         network::sim::Request_Sender sender( *this, pConnection->getSender(), yield_ctx );
@@ -106,9 +118,231 @@ void DaemonRequestLogicalThread::SimLockRelease( const runtime::MPO&         req
     }
     else
     {
-        network::sim::Request_Sender sender( *this, m_daemon.m_rootClient.getSender(), yield_ctx );
+        network::sim::Request_Sender sender(
+            *this, getPeerOrRootSender( targetMPO.getMachineID(), yield_ctx ), yield_ctx );
         return sender.SimLockRelease( requestingMPO, targetMPO, transaction );
     }
 }
 
+namespace
+{
+// completes an unacknowledged release batch on its own logical thread so the requester does not wait.
+// Further lock requests from the requester are held in ReleaseBatches::wait until it is done.
+class DaemonLockReleaseBatch : public DaemonRequestLogicalThread
+{
+    const runtime::MPO                        m_requestingMPO;
+    const std::vector< runtime::MPO >         m_targetMPOs;
+    const std::vector< network::Transaction > m_transactions;
+
+public:
+    DaemonLockReleaseBatch( Daemon& daemon, const runtime::MPO& requestingMPO,
+                            const std::vector< runtime::MPO >&         targetMPOs,
+                            const std::vector< network::Transaction >& transactions )
+        : DaemonRequestLogicalThread( daemon, daemon.createLogicalThreadID() )
+        , m_requestingMPO( requestingMPO )
+        , m_targetMPOs( targetMPOs )
+        , m_transactions( transactions )
+    {
+    }
+    void run( boost::asio::yield_context& yield_ctx )
+    {
+        try
+        {
+            releaseLockBatch( m_requestingMPO, m_targetMPOs, m_transactions, yield_ctx );
+        }
+        catch( std::exception& ex )
+        {
+            SPDLOG_WARN( "Unacknowledged lock release batch from: {} failed: {}", m_requestingMPO, ex.what() );
+        }
+        m_daemon.m_releaseBatches.completed( m_requestingMPO );
+    }
+};
+} // namespace
+
+void DaemonRequestLogicalThread::SimLockReleaseBatch( const runtime::MPO&                        requestingMPO,
+                                                      const std::vector< runtime::MPO >&         targetMPOs,
+                                                      const std::vector< network::Transaction >& transactions,
+                                                      const bool&                                bAcknowledge,
+                                                      boost::asio::yield_context&                yield_ctx )
+{
+    SPDLOG_TRACE( "DaemonRequestLogicalThread::SimLockReleaseBatch from: {} releases: {} acknowledge: {}",
+                  requestingMPO, targetMPOs.size(), bAcknowledge );
+    VERIFY_RTE_MSG( targetMPOs.size() == transactions.size(), "Mismatched lock release batch from: " << requestingMPO );
+
+    m_daemon.m_releaseBatches.wait( requestingMPO, yield_ctx );
+    if( bAcknowledge )
+    {
+        releaseLockBatch( requestingMPO, targetMPOs, transactions, yield_ctx );
+    }
+    else
+    {
+        // the next lock request from requestingMPO waits for this batch to complete
+        m_daemon.m_releaseBatches.started( requestingMPO );
+        m_daemon.logicalthreadInitiated(
+            std::make_shared< DaemonLockReleaseBatch >( m_daemon, requestingMPO, targetMPOs, transactions ) );
+    }
+}
+
+void DaemonRequestLogicalThread::sendRequestWaves( const RequestQueues&        queues,
+                                                   const runtime::MPO&         requestingMPO,
+                                                   boost::asio::yield_context& yield_ctx )
+{
+    // requests are queued per destination since responses on this logical thread cannot be told
+    // apart within one process. Releases routed through the root all share the root's queue.
+    RequestArray                 wave;
+    std::optional< std::string > strError;
+    for( std::size_t szWave = 0U;; ++szWave )
+    {
+        for( const auto& [ pSender, requests ] : queues )
+        {
+            if( szWave < requests.size() )
+            {
+                wave.push_back( requests[ szWave ] );
+            }
+        }
+        if( wave.empty() )
+        {
+            break;
+        }
+
+        // send the whole wave then collect the response to every request that went out so nothing
+        // is left outstanding on this logical thread
+        {
+            LogicalThreadBase::OutBoundRequestStack stack( shared_from_this() );
+            std::size_t                             szSent = 0U;
+            for( const auto& [ pSender, msg ] : wave )
+            {
+                if( const boost::system::error_code ec = pSender->send( msg, yield_ctx ) )
+                {
+                    if( !strError.has_value() )
+                    {
+                        strError = "Error writing request wave: " + ec.what();
+                    }
+                    continue;
+                }
+                ++szSent;
+            }
+            for( std::size_t szResponses = 0U; szResponses != szSent; ++szResponses )
+            {
+                try
+                {
+                    dispatchInBoundRequestsUntilResponse( yield_ctx );
+                }
+                catch( std::exception& ex )
+                {
+                    if( !strError.has_value() )
+                    {
+                        strError = ex.what();
+                    }
+                }
+            }
+        }
+        wave.clear();
+    }
+
+    // later waves still go out after a failure so one failed request does not hold back the rest
+    VERIFY_RTE_MSG( !strError.has_value(), "Request waves from: " << requestingMPO << " failed: " << strError.value() );
+}
+
+void DaemonRequestLogicalThread::releaseLockBatch( const runtime::MPO&                        requestingMPO,
+                                                   const std::vector< runtime::MPO >&         targetMPOs,
+                                                   const std::vector< network::Transaction >& transactions,
+                                                   boost::asio::yield_context&                yield_ctx )
+{
+    using Batch = std::pair< std::vector< runtime::MPO >, std::vector< network::Transaction > >;
+
+    // everything for another machine goes as one batch
+    RequestQueues                         queues;
+    std::map< runtime::MachineID, Batch > remote;
+
+    for( std::size_t i = 0; i != targetMPOs.size(); ++i )
+    {
+        const runtime::MPO& targetMPO = targetMPOs[ i ];
+        if( network::Server::Connection::Ptr pConnection = m_daemon.m_server.findConnection( targetMPO.getMP() ) )
+        {
+            network::Message release = network::sim::MSG_SimLockRelease_Request::make(
+                getID(), network::sim::MSG_SimLockRelease_Request{ requestingMPO, targetMPO, transactions[ i ] } );
+            network::Sender::Ptr pSender = pConnection->getSender();
+            queues[ pSender ].push_back(
+                { pSender,
+                  network::mpo::MSG_MPODown_Request::make(
+                      getID(), network::mpo::MSG_MPODown_Request{ std::move( release ), targetMPO } ) } );
+        }
+        else
+        {
+            Batch& batch = remote[ targetMPO.getMachineID() ];
+            batch.first.push_back( targetMPO );
+            batch.second.push_back( transactions[ i ] );
+        }
+    }
+
+    for( auto& [ machineID, batch ] : remote )
+    {
+        network::Sender::Ptr pSender = getPeerOrRootSender( machineID, yield_ctx );
+        queues[ pSender ].push_back(
+            { pSender,
+              network::sim::MSG_SimLockReleaseBatch_Request::make(
+                  getID(),
+                  network::sim::MSG_SimLockReleaseBatch_Request{
+                      requestingMPO, std::move( batch.first ), std::move( batch.second ), true } ) } );
+    }
+
+    sendRequestWaves( queues, requestingMPO, yield_ctx );
+}
+
+void DaemonRequestLogicalThread::SimLeaseInvalidate( const runtime::MPO&                ownerMPO,
+                                                     const std::vector< runtime::MPO >& leaseHolders,
+                                                     boost::asio::yield_context&        yield_ctx )
+{
+    SPDLOG_TRACE(
+        "DaemonRequestLogicalThread::SimLeaseInvalidate from: {} lease holders: {}", ownerMPO, leaseHolders.size() );
+    // the owner waits on this response so every reachable lease holder has dropped its lease before it changes
+    try
+    {
+        invalidateLeases( ownerMPO, leaseHolders, yield_ctx );
+    }
+    catch( std::exception& ex )
+    {
+        // a lease holder that has gone simply never reads again
+        SPDLOG_WARN( "Lease invalidation from: {} failed: {}", ownerMPO, ex.what() );
+    }
+}
+
+void DaemonRequestLogicalThread::invalidateLeases( const runtime::MPO&                ownerMPO,
+                                                   const std::vector< runtime::MPO >& leaseHolders,
+                                                   boost::asio::yield_context&        yield_ctx )
+{
+    RequestQueues                                               queues;
+    std::map< runtime::MachineID, std::vector< runtime::MPO > > remote;
+
+    for( const runtime::MPO& leaseHolder : leaseHolders )
+    {
+        if( network::Server::Connection::Ptr pConnection = m_daemon.m_server.findConnection( leaseHolder.getMP() ) )
+        {
+            network::Message invalidate = network::sim::MSG_SimLeaseInvalidate_Request::make(
+                getID(), network::sim::MSG_SimLeaseInvalidate_Request{ ownerMPO, { leaseHolder } } );
+            network::Sender::Ptr pSender = pConnection->getSender();
+            queues[ pSender ].push_back(
+                { pSender,
+                  network::mpo::MSG_MPODown_Request::make(
+                      getID(), network::mpo::MSG_MPODown_Request{ std::move( invalidate ), leaseHolder } ) } );
+        }
+        else
+        {
+            remote[ leaseHolder.getMachineID() ].push_back( leaseHolder );
+        }
+    }
+
+    for( auto& [ machineID, mpos ] : remote )
+    {
+        network::Sender::Ptr pSender = getPeerOrRootSender( machineID, yield_ctx );
+        queues[ pSender ].push_back(
+            { pSender,
+              network::sim::MSG_SimLeaseInvalidate_Request::make(
+                  getID(), network::sim::MSG_SimLeaseInvalidate_Request{ ownerMPO, std::move( mpos ) } ) } );
+    }
+
+    sendRequestWaves( queues, ownerMPO, yield_ctx );
+}
+
 } // namespace mega::service
@@ -0,0 +1,115 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "request.hpp"
+
+#include "log/log.hpp"
+
+#include <boost/lexical_cast.hpp>
+
+#include <chrono>
+
+namespace mega::service
+{
+namespace
+{
+// an unreachable peer falls back to the root after this rather than the tcp connect timeout
+constexpr auto PEER_CONNECT_TIMEOUT = std::chrono::seconds( 2 );
+} // namespace
+
+network::Sender::Ptr DaemonRequestLogicalThread::getPeerSender( const runtime::MachineID&   machineID,
+                                                                   boost::asio::yield_context& yield_ctx )
+{
+    if( !m_daemon.m_bMesh )
+    {
+        return {};
+    }
+
+    // a peer that connected to this daemon is reused in the other direction
+    if( auto pConnection = m_daemon.m_server.findConnection( network::Server::Connection::Label{ machineID } ) )
+    {
+        return pConnection->getSender();
+    }
+    if( auto iFind = m_daemon.m_peers.find( machineID ); iFind != m_daemon.m_peers.end() )
+    {
+        return iFind->second->getSender();
+    }
+
+    const std::string strEndPoint
+        = getRootRequest< network::enrole::Request_Encoder >( yield_ctx ).EnroleDaemonEndPoint( machineID );
+    const auto iSeparator = strEndPoint.rfind( ':' );
+    if( iSeparator == std::string::npos )
+    {
+        SPDLOG_WARN( "No end point for daemon: {} routing via root", machineID );
+        return {};
+    }
+
+    // another request may have connected while waiting for the root
+    if( auto iFind = m_daemon.m_peers.find( machineID ); iFind != m_daemon.m_peers.end() )
+    {
+        return iFind->second->getSender();
+    }
+    // or be connecting now in which case this request is routed via the root rather than waiting
+    if( !m_daemon.m_connectingPeers.insert( machineID ).second )
+    {
+        return {};
+    }
+
+    network::Sender::Ptr pSender;
+    try
+    {
+        const std::string strIP = strEndPoint.substr( 0, iSeparator );
+        const short       port  = boost::lexical_cast< short >( strEndPoint.substr( iSeparator + 1 ) );
+
+        // the daemon runs a single io thread so the connection must not block it
+        auto pClient = std::make_unique< network::Client >(
+            m_daemon.m_server.getIOContext(), m_daemon, strIP, port, PEER_CONNECT_TIMEOUT, yield_ctx );
+        pClient->setDisconnectCallback( [ machineID, pPeer = pClient.get(), &daemon = m_daemon ]()
+                                        { daemon.onPeerDisconnect( machineID, pPeer ); } );
+        pSender = pClient->getSender();
+        m_daemon.m_peers.insert( { machineID, std::move( pClient ) } );
+    }
+    catch( std::exception& ex )
+    {
+        m_daemon.m_connectingPeers.erase( machineID );
+        SPDLOG_WARN(
+            "Failed to connect to daemon: {} at: {} routing via root. Error: {}", machineID, strEndPoint, ex.what() );
+        return {};
+    }
+    m_daemon.m_connectingPeers.erase( machineID );
+
+    network::enrole::Request_Sender( *this, pSender, yield_ctx ).EnroleDaemonPeer( m_daemon.m_machineID );
+    SPDLOG_TRACE( "Daemon {} connected to peer daemon {} at {}", m_daemon.m_machineID, machineID, strEndPoint );
+
+    return pSender;
+}
+
+void DaemonRequestLogicalThread::EnroleDaemonPeer( const runtime::MachineID& daemonMachineID,
+                                                   boost::asio::yield_context& )
+{
+    network::Server::Connection::Ptr pConnection
+        = m_daemon.m_server.getConnection( getOriginatingStackResponseSender() );
+    VERIFY_RTE( pConnection );
+    pConnection->setType( network::Node::Daemon );
+    m_daemon.m_server.labelConnection( network::Server::Connection::Label{ daemonMachineID }, pConnection );
+    SPDLOG_TRACE( "Daemon {} accepted peer daemon {}", m_daemon.m_machineID, daemonMachineID );
+}
+
+} // namespace mega::service
@@ -0,0 +1,114 @@
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#ifndef GUARD_2026_October_18_release_batches
+#define GUARD_2026_October_18_release_batches
+
+#include "service/protocol/model/sim.hxx"
+
+#include "mega/values/runtime/mpo.hpp"
+
+#include "common/assert_verify.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <map>
+#include <memory>
+#include <optional>
+
+namespace mega::service
+{
+
+// unacknowledged lock release batches still running for a requesting mpo. Lock requests from that
+// mpo wait until they complete so a release is never overtaken by the next lock.
+class ReleaseBatches
+{
+    struct Pending
+    {
+        U64                                          uiBatches = 0U;
+        std::shared_ptr< boost::asio::steady_timer > pCompleted;
+    };
+    using PendingMap = std::map< runtime::MPO, Pending >;
+
+public:
+    ReleaseBatches( boost::asio::io_context& ioContext )
+        : m_ioContext( ioContext )
+    {
+    }
+
+    void started( const runtime::MPO& requestingMPO )
+    {
+        Pending& pending = m_pending[ requestingMPO ];
+        if( pending.uiBatches++ == 0U )
+        {
+            pending.pCompleted = std::make_shared< boost::asio::steady_timer >( m_ioContext );
+            pending.pCompleted->expires_at( boost::asio::steady_timer::time_point::max() );
+        }
+    }
+
+    void completed( const runtime::MPO& requestingMPO )
+    {
+        auto iFind = m_pending.find( requestingMPO );
+        VERIFY_RTE_MSG( iFind != m_pending.end(), "No pending lock release batch for: " << requestingMPO );
+        if( --iFind->second.uiBatches == 0U )
+        {
+            iFind->second.pCompleted->cancel();
+            m_pending.erase( iFind );
+        }
+    }
+
+    void wait( const runtime::MPO& requestingMPO, boost::asio::yield_context& yield_ctx )
+    {
+        // another batch may start while waiting so check again on every wake up
+        for( auto iFind = m_pending.find( requestingMPO ); iFind != m_pending.end();
+             iFind      = m_pending.find( requestingMPO ) )
+        {
+            std::shared_ptr< boost::asio::steady_timer > pCompleted = iFind->second.pCompleted;
+            boost::system::error_code                    ec;
+            pCompleted->async_wait( yield_ctx[ ec ] );
+        }
+    }
+
+    // executors send their lock requests wrapped in MPOUp so the routing handlers
+    // unwrap them here to find the mpo whose release batches they must wait for
+    static std::optional< runtime::MPO > getLockRequester( const network::Message& msg )
+    {
+        switch( msg.getID() )
+        {
+            case network::sim::MSG_SimLockRead_Request::ID:
+                return network::sim::MSG_SimLockRead_Request::get( msg ).requestingMPO;
+            case network::sim::MSG_SimLockWrite_Request::ID:
+                return network::sim::MSG_SimLockWrite_Request::get( msg ).requestingMPO;
+            case network::sim::MSG_SimLockRelease_Request::ID:
+                return network::sim::MSG_SimLockRelease_Request::get( msg ).requestingMPO;
+            default:
+                return std::nullopt;
+        }
+    }
+
+private:
+    boost::asio::io_context& m_ioContext;
+    PendingMap               m_pending;
+};
+
+} // namespace mega::service
+
+#endif // GUARD_2026_October_18_release_batches
@@ -35,6 +35,8 @@
 #include "service/protocol/model/memory.hxx"
 #include "service/protocol/model/sim.hxx"
 
+#include <map>
+
 namespace mega::service
 {
 
@@ -76,6 +78,42 @@ public:
                                    getID() );
     }
 
+    // in mesh mode the direct connection to the daemon for machineID - null when routing via the root
+    network::Sender::Ptr getPeerSender( const runtime::MachineID& machineID, boost::asio::yield_context& yield_ctx );
+
+    network::Sender::Ptr getPeerOrRootSender( const runtime::MachineID&   machineID,
+                                              boost::asio::yield_context& yield_ctx )
+    {
+        if( network::Sender::Ptr pPeer = getPeerSender( machineID, yield_ctx ) )
+        {
+            return pPeer;
+        }
+        return m_daemon.m_rootClient.getSender();
+    }
+
+    using RequestArray  = std::vector< std::pair< network::Sender::Ptr, network::Message > >;
+    using RequestQueues = std::map< network::Sender::Ptr, RequestArray >;
+
+    // sends the queued requests in waves taking at most one request from each queue per wave.
+    // Every request in a wave is sent before awaiting any response.
+    void sendRequestWaves( const RequestQueues&        queues,
+                           const runtime::MPO&         requestingMPO,
+                           boost::asio::yield_context& yield_ctx );
+
+    // releases a batch of locks, sending every release before awaiting any acknowledgement
+    void releaseLockBatch( const runtime::MPO&                        requestingMPO,
+                           const std::vector< runtime::MPO >&         targetMPOs,
+                           const std::vector< network::Transaction >& transactions,
+                           boost::asio::yield_context&                yield_ctx );
+
+    // holds a routed lock request until its requester's unacknowledged release batches have completed
+    void waitForReleaseBatches( const network::Message& request, boost::asio::yield_context& yield_ctx );
+
+    // delivers a lease invalidation from ownerMPO to every lease holder
+    void invalidateLeases( const runtime::MPO&                ownerMPO,
+                           const std::vector< runtime::MPO >& leaseHolders,
+                           boost::asio::yield_context&        yield_ctx );
+
     // network::leaf_daemon::Impl
     virtual network::Message TermRoot( const network::Message&     request,
                                        boost::asio::yield_context& yield_ctx ) override;
@@ -123,6 +161,9 @@ public:
     // network::enrole::Impl
     virtual runtime::MP EnroleLeafWithDaemon( const std::string& startupUUID, const network::Node& type,
                                               boost::asio::yield_context& yield_ctx ) override;
+    virtual void        EnroleDaemonPeer( const runtime::MachineID&   daemonMachineID,
+                                          boost::asio::yield_context& yield_ctx ) override;
+    virtual std::string EnroleSharedMemory( const runtime::MP& leafMP, boost::asio::yield_context& yield_ctx ) override;
     virtual void        EnroleDaemonSpawn( const std::string& strProgram, const std::string& startupUUID,
                                            boost::asio::yield_context& yield_ctx ) override;
 
@@ -164,6 +205,14 @@ public:
                                                const runtime::MPO&         targetMPO,
                                                const network::Transaction& transaction,
                                                boost::asio::yield_context& yield_ctx ) override;
+    virtual void               SimLockReleaseBatch( const runtime::MPO&                        requestingMPO,
+                                                    const std::vector< runtime::MPO >&         targetMPOs,
+                                                    const std::vector< network::Transaction >& transactions,
+                                                    const bool&                                bAcknowledge,
+                                                    boost::asio::yield_context&                yield_ctx ) override;
+    virtual void               SimLeaseInvalidate( const runtime::MPO&                ownerMPO,
+                                                   const std::vector< runtime::MPO >& leaseHolders,
+                                                   boost::asio::yield_context&        yield_ctx ) override;
 };
 
 } // namespace mega::service
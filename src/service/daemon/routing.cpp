@@ -39,26 +39,23 @@ DaemonRequestLogicalThread::~DaemonRequestLogicalThread()
 network::Message DaemonRequestLogicalThread::dispatchInBoundRequest( const network::Message&     msg,
                                                                      boost::asio::yield_context& yield_ctx )
 {
-    network::Message result;
-    if( result = network::mpo::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::leaf_daemon::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::root_daemon::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::enrole::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::status::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::report::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::job::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::memory::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::project::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::sim::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
+    // clang-format off
+    static constexpr auto table = network::DispatchTable< DaemonRequestLogicalThread >::make
+    <
+        network::mpo::Impl,
+        network::leaf_daemon::Impl,
+        network::root_daemon::Impl,
+        network::enrole::Impl,
+        network::status::Impl,
+        network::report::Impl,
+        network::job::Impl,
+        network::memory::Impl,
+        network::project::Impl,
+        network::sim::Impl
+    >();
+    // clang-format on
+
+    if( network::Message result = table.dispatch( *this, msg, yield_ctx ); result )
         return result;
     THROW_RTE( "DaemonRequestLogicalThread::dispatchInBoundRequest failed: " << msg.getName() );
 }
@@ -140,6 +137,10 @@ network::Message DaemonRequestLogicalThread::RootAllBroadcast( const network::Me
     {
         for( auto pConnection : m_daemon.m_server.getConnections() )
         {
+            if( isPeerDaemon( *pConnection ) )
+            {
+                continue;
+            }
             network::daemon_leaf::Request_Sender sender( *this, pConnection->getSender(), yield_ctx );
             const network::Message               response = sender.RootAllBroadcast( request );
             responses.push_back( response );
@@ -211,14 +212,31 @@ network::Message DaemonRequestLogicalThread::MPDown( const network::Message&
     return sender.MPDown( request, mp );
 }
 
+void DaemonRequestLogicalThread::waitForReleaseBatches( const network::Message&     request,
+                                                        boost::asio::yield_context& yield_ctx )
+{
+    // lock requests from executors arrive wrapped in MPOUp and are routed straight down to the target
+    // so they never reach SimLockRead or SimLockWrite here. Hold them behind the requester's release batches.
+    if( std::optional< runtime::MPO > requestingMPO = ReleaseBatches::getLockRequester( request ) )
+    {
+        m_daemon.m_releaseBatches.wait( requestingMPO.value(), yield_ctx );
+    }
+}
+
 network::Message DaemonRequestLogicalThread::MPUp( const network::Message& request, const runtime::MP& mp,
                                                    boost::asio::yield_context& yield_ctx )
 {
+    waitForReleaseBatches( request, yield_ctx );
     if( network::Server::Connection::Ptr pConnection = m_daemon.m_server.findConnection( mp ) )
     {
         network::mpo::Request_Sender sender( *this, pConnection->getSender(), yield_ctx );
         return sender.MPDown( request, mp );
     }
+    else if( network::Sender::Ptr pPeer = getPeerSender( mp.getMachineID(), yield_ctx ) )
+    {
+        network::mpo::Request_Sender sender( *this, pPeer, yield_ctx );
+        return sender.MPDown( request, mp );
+    }
     else
     {
         network::mpo::Request_Sender sender( *this, m_daemon.m_rootClient.getSender(), yield_ctx );
@@ -245,11 +263,17 @@ network::Message DaemonRequestLogicalThread::MPOUp( const network::Message&
                                                     const runtime::MPO&         mpo,
                                                     boost::asio::yield_context& yield_ctx )
 {
+    waitForReleaseBatches( request, yield_ctx );
     if( network::Server::Connection::Ptr pConnection = m_daemon.m_server.findConnection( mpo.getMP() ) )
     {
         network::mpo::Request_Sender sender( *this, pConnection->getSender(), yield_ctx );
         return sender.MPODown( request, mpo );
     }
+    else if( network::Sender::Ptr pPeer = getPeerSender( mpo.getMachineID(), yield_ctx ) )
+    {
+        network::mpo::Request_Sender sender( *this, pPeer, yield_ctx );
+        return sender.MPODown( request, mpo );
+    }
     else
     {
         network::mpo::Request_Sender sender( *this, m_daemon.m_rootClient.getSender(), yield_ctx );
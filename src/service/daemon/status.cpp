@@ -32,7 +32,7 @@ network::Status DaemonRequestLogicalThread::GetStatus( const std::vector< networ
     network::Status status{ childNodeStatus };
     {
         std::vector< network::LogicalThreadID > logicalthreads;
-        for( const auto& [ id, pCon ] : m_daemon.m_logicalthreads )
+        for( const auto& id : m_daemon.reportLogicalThreads() )
         {
             if( id != getID() )
             {
@@ -43,6 +43,7 @@ network::Status DaemonRequestLogicalThread::GetStatus( const std::vector< networ
         status.setMachineID( m_daemon.m_machineID );
         status.setDescription( m_daemon.m_strProcessName );
         status.setLogFile( m_daemon.getLog().logFile.string() );
+        status.setDispatch( network::getDispatchStatus() );
     }
 
     return status;
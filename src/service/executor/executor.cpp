@@ -242,7 +242,7 @@ runtime::MPO Executor::createSimulation( network::LogicalThread&     callingLogi
         const network::LogicalThreadID id;
         SPDLOG_TRACE( "Executor::createSimulation {} {}", m_strProcessName, id );
         pSimulation = std::make_shared< Simulation >( *this, id, m_processClock );
-        m_logicalthreads.insert( std::make_pair( pSimulation->getID(), pSimulation ) );
+        m_logicalthreads.insert( pSimulation->getID(), pSimulation );
         spawnInitiatedLogicalThread( pSimulation );
     }
 
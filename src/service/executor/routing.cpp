@@ -37,24 +37,22 @@ ExecutorRequestLogicalThread::~ExecutorRequestLogicalThread()
 network::Message ExecutorRequestLogicalThread::dispatchInBoundRequest( const network::Message&     msg,
                                                                        boost::asio::yield_context& yield_ctx )
 {
-    network::Message result;
-    if( result = network::leaf_exe::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::job::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::mpo::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::sim::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::status::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::report::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::project::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::enrole::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::host::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
+    // clang-format off
+    static constexpr auto table = network::DispatchTable< ExecutorRequestLogicalThread >::make
+    <
+        network::leaf_exe::Impl,
+        network::job::Impl,
+        network::mpo::Impl,
+        network::sim::Impl,
+        network::status::Impl,
+        network::report::Impl,
+        network::project::Impl,
+        network::enrole::Impl,
+        network::host::Impl
+    >();
+    // clang-format on
+
+    if( network::Message result = table.dispatch( *this, msg, yield_ctx ); result )
         return result;
     THROW_RTE( "ExecutorRequestLogicalThread::dispatchInBoundRequest failed for: " << msg.getName() );
 }
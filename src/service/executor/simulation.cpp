@@ -46,6 +46,7 @@
 
 #include <boost/filesystem/operations.hpp>
 
+#include <algorithm>
 #include <memory>
 
 namespace mega::service
@@ -93,6 +94,12 @@ network::memory::Request_Encoder Simulation::getDaemonMemoryRequest()
              { return leafRequest.ExeDaemon( msg ); },
              getID() };
 }
+network::sim::Request_Encoder Simulation::getDaemonSimRequest()
+{
+    return { [ leafRequest = getLeafRequest( *m_pYieldContext ) ]( const network::Message& msg ) mutable
+             { return leafRequest.ExeDaemon( msg ); },
+             getID() };
+}
 network::sim::Request_Encoder Simulation::getMPOSimRequest( runtime::MPO mpo )
 {
     return { [ leafRequest = getMPRequest(), mpo ]( const network::Message& msg ) mutable
@@ -179,6 +186,8 @@ void Simulation::runSimulation( boost::asio::yield_context& yield_ctx )
                 break;
                 case SM::eRunCycle:
                 {
+                    const event::IndexRecord cycleStart = getLog().getIterator();
+
                     // process all events
                     {
                         for( ; m_iter_events != m_pLog->end< event::Event::Read >(); ++m_iter_events )
@@ -296,6 +305,12 @@ void Simulation::runSimulation( boost::asio::yield_context& yield_ctx )
                         }
                     }
 
+                    // any state change this cycle makes the copies held by lease holders stale
+                    if( getLog().getIterator() != cycleStart )
+                    {
+                        invalidateLeases();
+                    }
+
                     cycleComplete();
 
                     // NOTE: may be simCreate request - ensure transition OUT of SIM state
@@ -510,6 +525,7 @@ runtime::TimeStamp Simulation::SimLockRead( const runtime::MPO& requestingMPO, c
     {
         return {};
     }
+    m_leaseHolders.onRead( requestingMPO );
     return getLog().getTimeStamp();
 }
 
@@ -521,6 +537,11 @@ runtime::TimeStamp Simulation::SimLockWrite( const runtime::MPO& requestingMPO,
     {
         return {};
     }
+    m_leaseHolders.onWrite( requestingMPO );
+    {
+        QueueStackDepth queueMsgs( m_queueStack );
+        invalidateLeases();
+    }
     return getLog().getTimeStamp();
 }
 
@@ -539,6 +560,26 @@ void Simulation::SimLockRelease( const runtime::MPO& requestingMPO, const runtim
     }
 }
 
+void Simulation::SimLeaseInvalidate( const runtime::MPO& ownerMPO, const std::vector< runtime::MPO >& leaseHolders,
+                                     boost::asio::yield_context& )
+{
+    SPDLOG_TRACE( "SIM::SimLeaseInvalidate: {} {}", ownerMPO, getThisMPO() );
+    VERIFY_RTE_MSG( std::find( leaseHolders.begin(), leaseHolders.end(), getThisMPO() ) != leaseHolders.end(),
+                    "SimLeaseInvalidate delivered to wrong mpo: " << getThisMPO() );
+    leaseInvalidated( ownerMPO );
+}
+
+void Simulation::invalidateLeases()
+{
+    if( !m_leaseHolders.empty() )
+    {
+        const LeaseHolders::MPOVector leaseHolders = m_leaseHolders.invalidate();
+        SPDLOG_TRACE( "SIM::invalidateLeases: {} lease holders: {}", getThisMPO(), leaseHolders.size() );
+        // the daemon responds once every lease holder has dropped its lease
+        getDaemonSimRequest().SimLeaseInvalidate( getThisMPO(), leaseHolders );
+    }
+}
+
 runtime::MPO Simulation::SimCreate( boost::asio::yield_context& )
 {
     SPDLOG_TRACE( "SIM::SimCreate" );
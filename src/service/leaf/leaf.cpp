@@ -70,6 +70,13 @@ public:
             m_leaf.m_mp = encoder.EnroleLeafWithDaemon( startupUUID, m_leaf.getType() );
 
             SPDLOG_TRACE( "Leaf enrole mp: {}", m_leaf.m_mp );
+
+            // the daemon offers shared memory when it shares this machine
+            const std::string strSegmentName = encoder.EnroleSharedMemory( m_leaf.m_mp );
+            if( !strSegmentName.empty() )
+            {
+                m_leaf.m_client.connectSharedMemory( m_leaf, strSegmentName );
+            }
         }
 
         // determine the current project and stuff and initialise the runtime
@@ -115,12 +122,16 @@ void Leaf::getGeneralStatusReport( const URL& url, Branch& report )
 
     Table tables;
     {
+        const auto cacheStats = getRuntime().getObjectCacheStats();
+
         Table table;
         // clang-format off
         table.m_rows.push_back( { Line{ "     Process: "s }, Line{ m_strProcessName } } );
         table.m_rows.push_back( { Line{ "   Node Type: "s }, Line{ m_nodeType } } );
         table.m_rows.push_back( { Line{ "          MP: "s }, Line{ m_mp } } );
         table.m_rows.push_back( { Line{ "     Program: "s }, Line{ getRuntime().getProgram() } } );
+        table.m_rows.push_back( { Line{ "   JIT Cache: "s }, Line{ std::to_string( cacheStats.hits ) + " hits "s
+                                                                + std::to_string( cacheStats.misses ) + " misses"s } } );
         table.m_rows.push_back( { Line{ "    Log File: "s }, Line{ getLog().logFile, report::makeFileURL( url, getLog().logFile ) } } );
 
         // table.m_rows.push_back( { Line{ "  Remote Mem: "s }, Line{ std::to_string( remoteMemStatus.m_heap ) } } );
@@ -165,6 +165,30 @@ runtime::PointerNet MPOContext::allocateRemote( const runtime::MPO& remote, conc
     return allocated;
 }
 
+runtime::TimeStamp MPOContext::acquireRead( const runtime::MPO& target )
+{
+    runtime::TimeStamp lockCycle = m_lockTracker.isRead( target );
+    if( lockCycle == 0U )
+    {
+        // a lease from an earlier cycle is still valid until the owner invalidates it
+        lockCycle = m_lockTracker.isLeased( target );
+        if( lockCycle == 0U )
+        {
+            lockCycle = getMPOSimRequest( target ).SimLockRead( getThisMPO(), target );
+            VERIFY_RTE_MSG( lockCycle != 0U, "Failed to acquire read lock on: " << target );
+            m_lockTracker.onRead( target, lockCycle );
+            m_lockTracker.onLease( target, lockCycle );
+        }
+    }
+    return lockCycle;
+}
+
+void MPOContext::leaseInvalidated( const runtime::MPO& owner )
+{
+    SPDLOG_TRACE( "MPOContext::leaseInvalidated: {} by: {}", getThisMPO(), owner );
+    m_lockTracker.onInvalidate( owner );
+}
+
 // networkToHeap ONLY called when MPO matches
 runtime::PointerHeap MPOContext::networkToHeap( const runtime::PointerNet&  )
 {
@@ -186,14 +210,8 @@ void MPOContext::readLock( runtime::Pointer& ref )
 
     VERIFY_RTE_MSG( ref.getMPO() != getThisMPO(), "readLock used when matching MPO" );
 
-    // acquire lock if required and get lock cycle
-    runtime::TimeStamp lockCycle = m_lockTracker.isRead( ref.getMPO() );
-    if( lockCycle == 0U )
-    {
-        lockCycle = getMPOSimRequest( ref.getMPO() ).SimLockRead( getThisMPO(), ref.getMPO() );
-        VERIFY_RTE_MSG( lockCycle != 0U, "Failed to acquire write lock on: " << ref );
-        m_lockTracker.onRead( ref.getMPO(), lockCycle );
-    }
+    // acquire lock or lease if required and get lock cycle
+    runtime::TimeStamp lockCycle = acquireRead( ref.getMPO() );
 
     if( ref.isNetworkAddress() || ( ref.getLockCycle() != lockCycle ) )
     {
@@ -402,17 +420,33 @@ void MPOContext::cycleComplete()
         }
     }*/
 
-    for( const auto& [ writeLockMPO, lockCycle ] : m_lockTracker.getWrites() )
+    // releases go to this daemon as at most two batches - writes carry transactions so wait for them
     {
-        SPDLOG_TRACE( "MPOContext: cycleComplete: {} sending: write release to: {}", m_mpo.value(), writeLockMPO );
-        getMPOSimRequest( writeLockMPO )
-            .SimLockRelease( m_mpo.value(), writeLockMPO, network::Transaction{ transactions[ writeLockMPO ] } );
+        std::vector< runtime::MPO >         writeMPOs;
+        std::vector< network::Transaction > writeTransactions;
+        for( const auto& [ writeLockMPO, lockCycle ] : m_lockTracker.getWrites() )
+        {
+            SPDLOG_TRACE( "MPOContext: cycleComplete: {} sending: write release to: {}", m_mpo.value(), writeLockMPO );
+            writeMPOs.push_back( writeLockMPO );
+            writeTransactions.push_back( network::Transaction{ transactions[ writeLockMPO ] } );
+        }
+        if( !writeMPOs.empty() )
+        {
+            getDaemonSimRequest().SimLockReleaseBatch( m_mpo.value(), writeMPOs, writeTransactions, true );
+        }
     }
-
-    for( const auto& [ readLockMPO, lockCycle ] : m_lockTracker.getReads() )
     {
-        SPDLOG_TRACE( "MPOContext: cycleComplete: {} sending: read release to: {}", m_mpo.value(), readLockMPO );
-        getMPOSimRequest( readLockMPO ).SimLockRelease( m_mpo.value(), readLockMPO, network::Transaction{} );
+        std::vector< runtime::MPO > readMPOs;
+        for( const auto& [ readLockMPO, lockCycle ] : m_lockTracker.getReads() )
+        {
+            SPDLOG_TRACE( "MPOContext: cycleComplete: {} sending: read release to: {}", m_mpo.value(), readLockMPO );
+            readMPOs.push_back( readLockMPO );
+        }
+        if( !readMPOs.empty() )
+        {
+            getDaemonSimRequest().SimLockReleaseBatch(
+                m_mpo.value(), readMPOs, std::vector< network::Transaction >( readMPOs.size() ), false );
+        }
     }
 
     m_lockTracker.reset();
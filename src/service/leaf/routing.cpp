@@ -38,36 +38,28 @@ LeafRequestLogicalThread::~LeafRequestLogicalThread()
 network::Message LeafRequestLogicalThread::dispatchInBoundRequest( const network::Message&     msg,
                                                                    boost::asio::yield_context& yield_ctx )
 {
-    network::Message result;
-    if( result = network::memory::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::jit::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::term_leaf::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::daemon_leaf::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::exe_leaf::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::tool_leaf::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::python_leaf::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::report_leaf::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::mpo::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::status::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::report::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::job::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::project::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::enrole::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::host::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
+    // clang-format off
+    static constexpr auto table = network::DispatchTable< LeafRequestLogicalThread >::make
+    <
+        network::memory::Impl,
+        network::jit::Impl,
+        network::term_leaf::Impl,
+        network::daemon_leaf::Impl,
+        network::exe_leaf::Impl,
+        network::tool_leaf::Impl,
+        network::python_leaf::Impl,
+        network::report_leaf::Impl,
+        network::mpo::Impl,
+        network::status::Impl,
+        network::report::Impl,
+        network::job::Impl,
+        network::project::Impl,
+        network::enrole::Impl,
+        network::host::Impl
+    >();
+    // clang-format on
+
+    if( network::Message result = table.dispatch( *this, msg, yield_ctx ); result )
         return result;
     THROW_RTE( "LeafRequestLogicalThread::dispatchInBoundRequest failed on msg: " << msg );
 }
@@ -35,7 +35,7 @@ network::Status LeafRequestLogicalThread::GetStatus( const std::vector< network:
     {
         std::vector< network::LogicalThreadID > logicalthreads;
         {
-            for( const auto& [ id, pCon ] : m_leaf.m_logicalthreads )
+            for( const auto& id : m_leaf.reportLogicalThreads() )
             {
                 if( id != getID() )
                 {
@@ -50,10 +50,18 @@ network::Status LeafRequestLogicalThread::GetStatus( const std::vector< network:
         status.setDescription( os.str() );
 
         status.setLogFile( m_leaf.getLog().logFile.string() );
+        // counters are process wide so only the leaf reports them for leaf processes
+        status.setDispatch( network::getDispatchStatus() );
 
         if( auto program = m_leaf.getRuntime().getProgram(); !program.empty() )
         {
             status.setProgram( program );
+
+            const auto         cacheStats = m_leaf.getRuntime().getObjectCacheStats();
+            network::JITStatus jitStatus;
+            jitStatus.m_objectCacheHits   = cacheStats.hits;
+            jitStatus.m_objectCacheMisses = cacheStats.misses;
+            status.setJIT( jitStatus );
         }
     }
 
@@ -26,10 +26,12 @@
 #include <boost/bind/bind.hpp>
 #include <boost/asio/connect.hpp>
 #include <boost/asio/strand.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 #include <exception>
 #include <future>
 #include <iostream>
+#include <memory>
 
 namespace mega::network
 {
@@ -58,19 +60,82 @@ Client::Client( boost::asio::io_context& ioContext, LogicalThreadManager& logica
     }
 
     m_endPoint = boost::asio::connect( m_socket, endpoints );
-    m_pSender  = make_socket_sender( m_socket );
+    m_pSender  = std::make_shared< SwitchableSender >( make_socket_sender( m_socket ) );
     m_receiver.run( ioContext, m_pSender );
 }
 
+Client::Client( boost::asio::io_context& ioContext, LogicalThreadManager& logicalthreadManager,
+                const std::string& strServiceIP, short portNumber, std::chrono::steady_clock::duration timeout,
+                boost::asio::yield_context& yield_ctx )
+    : m_ioContext( ioContext )
+    , m_resolver( ioContext )
+    , m_strand( boost::asio::make_strand( ioContext ) )
+    , m_socket( m_strand )
+    , m_receiver( logicalthreadManager, m_socket, [ this ] { disconnected(); } )
+{
+    // the timer may fire after the client is gone so it only closes the socket while still connecting
+    auto                      pConnecting = std::make_shared< bool >( true );
+    boost::asio::steady_timer timer( m_strand, timeout );
+    timer.async_wait(
+        [ this, pConnecting ]( const boost::system::error_code& ec )
+        {
+            if( !ec && *pConnecting )
+            {
+                boost::system::error_code ignored;
+                m_resolver.cancel();
+                m_socket.close( ignored );
+            }
+        } );
+
+    boost::system::error_code      ec;
+    Traits::Resolver::results_type endpoints = m_resolver.async_resolve(
+        strServiceIP, std::to_string( static_cast< unsigned short >( portNumber ) ), yield_ctx[ ec ] );
+    if( !ec )
+    {
+        m_endPoint = boost::asio::async_connect( m_socket, endpoints, yield_ctx[ ec ] );
+    }
+    *pConnecting = false;
+    timer.cancel();
+
+    if( ec )
+    {
+        THROW_RTE( "Failed to connect to ip: " << strServiceIP << " port: " << portNumber
+                                               << " error: " << ec.message() );
+    }
+
+    m_pSender = std::make_shared< SwitchableSender >( make_socket_sender( m_socket ) );
+    m_receiver.run( ioContext, m_pSender );
+}
+
+void Client::connectSharedMemory( LogicalThreadManager& logicalthreadManager, const std::string& strSegmentName )
+{
+    VERIFY_RTE_MSG( !m_pSharedMemory, "Duplicate shared memory for client" );
+    m_pSharedMemory = std::make_unique< SharedMemoryChannel >( SharedMemoryChannel::Open{}, strSegmentName );
+    m_pSharedMemoryReceiver
+        = std::make_unique< SharedMemoryReceiver >( logicalthreadManager, *m_pSharedMemory, m_receiver );
+    m_pSharedMemoryReceiver->run( m_ioContext.get_executor(), m_pSender, {} );
+    m_pSender->switchTo( *m_pSharedMemory );
+    SPDLOG_TRACE( "Client connected to shared memory {}", strSegmentName );
+}
+
 void Client::stop()
 {
     boost::system::error_code ec;
     m_socket.shutdown( m_socket.shutdown_both, ec );
+    if( m_pSharedMemoryReceiver )
+    {
+        m_pSharedMemoryReceiver->stop();
+        m_pSharedMemory->close();
+    }
 }
 
 void Client::disconnected()
 {
     SPDLOG_TRACE( "Client disconnected" );
+    if( m_disconnectCallback.has_value() )
+    {
+        ( *m_disconnectCallback )();
+    }
 }
 
 Client::~Client() = default;
@@ -47,37 +47,25 @@ boost::asio::io_context& LogicalThreadManager::getIOContext() const
 void LogicalThreadManager::onDisconnect( network::Sender::Ptr pConnectionSender )
 {
     // send error message to ALL active logical threads with the connection sender
-    WriteLock lock( m_mutex );
-    for( const auto& [ id, pLogicalThread ] : m_logicalthreads )
-    {
-        ReceivedMessage receivedMessage{ pConnectionSender, network::make_disconnect_error_msg( id, "Disconnection" ) };
-        pLogicalThread->receiveMessage( receivedMessage );
-    }
+    m_logicalthreads.forEach(
+        [ &pConnectionSender ]( const LogicalThreadID& id, const LogicalThreadBase::Ptr& pLogicalThread )
+        {
+            ReceivedMessage receivedMessage{
+                pConnectionSender, network::make_disconnect_error_msg( id, "Disconnection" ) };
+            pLogicalThread->receiveMessage( receivedMessage );
+        } );
 }
 
 std::vector< LogicalThreadID > LogicalThreadManager::reportLogicalThreads() const
 {
-    std::vector< LogicalThreadID > threads;
-    {
-        ReadLock lock( m_mutex );
-        for( const auto& [ id, _ ] : m_logicalthreads )
-        {
-            threads.push_back( id );
-        }
-    }
-    return threads;
+    return m_logicalthreads.getIDs();
 }
 
 std::vector< LogicalThreadBase::Ptr > LogicalThreadManager::getLogicalThreads() const
 {
     std::vector< LogicalThreadBase::Ptr > threads;
-    {
-        ReadLock lock( m_mutex );
-        for( const auto& [ _, pLogicalThread ] : m_logicalthreads )
-        {
-            threads.push_back( pLogicalThread );
-        }
-    }
+    m_logicalthreads.forEach( [ &threads ]( const LogicalThreadID&, const LogicalThreadBase::Ptr& pLogicalThread )
+                              { threads.push_back( pLogicalThread ); } );
     return threads;
 }
 
@@ -110,25 +98,21 @@ void LogicalThreadManager::externalLogicalThreadInitiated( ExternalLogicalThread
 {
     WriteLock lock( m_mutex );
     VERIFY_RTE_MSG( !m_pExternalLogicalThread, "Existing external logicalthread" );
-    m_logicalthreads.insert( std::make_pair( pLogicalThread->getID(), pLogicalThread ) );
+    m_logicalthreads.insert( pLogicalThread->getID(), pLogicalThread );
     m_pExternalLogicalThread = pLogicalThread;
 }
 
 void LogicalThreadManager::logicalthreadInitiated( LogicalThread::Ptr pLogicalThread )
 {
     SPDLOG_TRACE( "LogicalThreadManager::logicalthreadInitiated: {} {}", m_strProcessName, pLogicalThread->getID() );
-    WriteLock lock( m_mutex );
-    m_logicalthreads.insert( std::make_pair( pLogicalThread->getID(), pLogicalThread ) );
+    m_logicalthreads.insert( pLogicalThread->getID(), pLogicalThread );
     spawnInitiatedLogicalThread( pLogicalThread );
 }
 
 void LogicalThreadManager::logicalthreadJoined( LogicalThread::Ptr pLogicalThread )
 {
     // SPDLOG_TRACE( "LogicalThreadManager::logicalthreadJoined: {} {}", m_strProcessName, pLogicalThread->getID() );
-    {
-        WriteLock lock( m_mutex );
-        m_logicalthreads.insert( std::make_pair( pLogicalThread->getID(), pLogicalThread ) );
-    }
+    m_logicalthreads.insert( pLogicalThread->getID(), pLogicalThread );
     // clang-format off
     boost::asio::spawn
     (
@@ -148,12 +132,9 @@ void LogicalThreadManager::logicalthreadJoined( LogicalThread::Ptr pLogicalThrea
 
 void LogicalThreadManager::logicalthreadCompleted( LogicalThreadBase::Ptr pLogicalThread )
 {
+    m_logicalthreads.erase( pLogicalThread->getID() );
+
     WriteLock lock( m_mutex );
-    auto      iFind = m_logicalthreads.find( pLogicalThread->getID() );
-    if( iFind != m_logicalthreads.end() )
-    {
-        m_logicalthreads.erase( iFind );
-    }
     if( m_pExternalLogicalThread == pLogicalThread )
     {
         m_pExternalLogicalThread.reset();
@@ -162,16 +143,7 @@ void LogicalThreadManager::logicalthreadCompleted( LogicalThreadBase::Ptr pLogic
 
 LogicalThreadBase::Ptr LogicalThreadManager::findExistingLogicalThread( const LogicalThreadID& logicalthreadID ) const
 {
-    ReadLock lock( m_mutex );
-    auto     iFind = m_logicalthreads.find( logicalthreadID );
-    if( iFind != m_logicalthreads.end() )
-    {
-        return iFind->second;
-    }
-    else
-    {
-        return {};
-    }
+    return m_logicalthreads.find( logicalthreadID );
 }
 
 ExternalLogicalThread::Ptr LogicalThreadManager::getExternalLogicalThread() const
@@ -20,6 +20,7 @@
 #include "service/network/receiver.hpp"
 #include "service/network/logical_thread_manager.hpp"
 #include "service/network/end_point.hpp"
+#include "service/network/receive_buffer.hpp"
 
 #include "mega/values/service/logical_thread_id.hpp"
 
@@ -33,10 +34,11 @@
 #include <boost/asio/read.hpp>
 
 #include <boost/interprocess/interprocess_fwd.hpp>
-#include <boost/interprocess/streams/vectorstream.hpp>
+#include <boost/interprocess/streams/bufferstream.hpp>
 
 #include <memory>
 #include <iostream>
+#include <span>
 #include <utility>
 
 namespace mega::network
@@ -75,68 +77,33 @@ void SocketReceiver::onError( const boost::system::error_code& ec )
 
 void SocketReceiver::receive( Sender::Ptr pSender, boost::asio::yield_context& yield_ctx )
 {
-    static const mega::U64 MessageSizeSize = sizeof( network::MessageSize );
-    using ReceiveBuffer                    = std::vector< char >;
-    ReceiveBuffer                       buffer( 1024 );
-    boost::system::error_code           ec;
-    mega::U64                           szBytesTransferred = 0U;
-    std::array< char, MessageSizeSize > buf;
-
-    if( m_bContinue && m_socket.is_open() )
+    // read as much as is available into a pooled buffer and frame every complete message in place
+    MessageFramer             framer;
+    boost::system::error_code ec;
+
+    while( m_bContinue && m_socket.is_open() )
     {
-        while( m_bContinue && m_socket.is_open() )
+        const mega::U64 szBytesTransferred = m_socket.async_read_some( framer.prepare(), yield_ctx[ ec ] );
+        if( !ec )
         {
-            // read message size
-            network::MessageSize size = 0U;
-            {
-                while( m_bContinue && m_socket.is_open() )
+            framer.commit( szBytesTransferred );
+            framer.frame(
+                [ this, &pSender ]( std::span< const char > message )
                 {
-                    szBytesTransferred
-                        = boost::asio::async_read( m_socket, boost::asio::buffer( buf ), yield_ctx[ ec ] );
-                    if( !ec )
-                    {
-                        if( szBytesTransferred == MessageSizeSize )
-                        {
-                            size = *reinterpret_cast< const network::MessageSize* >( buf.data() );
-                            break;
-                        }
-                        else
-                        {
-                            SPDLOG_ERROR( "Socket: error reading message size" );
-                            m_bContinue = false;
-                        }
-                    }
-                    else // if( ec.failed() )
-                    {
-                        m_bContinue = false;
-                        onError( ec );
-                    }
-                }
-            }
-
-            // read message
-            if( m_bContinue && m_socket.is_open() )
-            {
-                buffer.resize( size );
-                szBytesTransferred
-                    = boost::asio::async_read( m_socket, boost::asio::buffer( buffer ), yield_ctx[ ec ] );
-                if( !ec )
-                {
-                    VERIFY_RTE( size == szBytesTransferred );
                     Message msg;
                     {
-                        boost::interprocess::basic_vectorbuf< ReceiveBuffer > is( buffer );
+                        boost::interprocess::bufferbuf is( const_cast< char* >( message.data() ), message.size() );
                         decode( is, msg );
                     }
                     const ReceivedMessage receivedMsg{ pSender, std::move( msg ) };
                     m_logicalThreadManager.dispatch( receivedMsg );
-                }
-                else // if( ec.failed() )
-                {
-                    m_bContinue = false;
-                    onError( ec );
-                }
-            }
+                    m_uiReceived.fetch_add( 1U, std::memory_order_release );
+                } );
+        }
+        else // if( ec.failed() )
+        {
+            m_bContinue = false;
+            onError( ec );
         }
     }
     m_disconnectHandler();
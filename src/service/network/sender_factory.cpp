@@ -18,6 +18,7 @@
 //  OF THE POSSIBILITY OF SUCH DAMAGES.
 
 #include "service/network/end_point.hpp"
+#include "service/network/shared_memory.hpp"
 #include "log/log.hpp"
 #include "service/network/network.hpp"
 
@@ -31,6 +32,8 @@
 
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/experimental/channel_error.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/write.hpp>
 
 #include <boost/interprocess/interprocess_fwd.hpp>
@@ -39,6 +42,8 @@
 #include <boost/archive/binary_oarchive.hpp>
 
 #include <algorithm>
+#include <cstring>
+#include <mutex>
 #include <sstream>
 #include <utility>
 
@@ -47,15 +52,66 @@ namespace mega::network
 
 Sender::~Sender() = default;
 
+// Messages are serialised straight into recycled buffers and queued.  The first sender to find
+// no write in progress becomes the writer: it yields once so every message queued during the
+// current io_context turn is coalesced into a single gathered async_write.  Senders wait while
+// the queue is above HIGH_WATER_MARK.
 class SocketSender : public Sender
 {
     using SendBuffer = std::vector< char >;
 
-    Traits::Socket& m_socket;
+    static constexpr mega::U64 HIGH_WATER_MARK  = 1 << 22;
+    static constexpr mega::U64 MAX_FREE_BUFFERS = 256;
+
+    Traits::Socket&                                    m_socket;
+    boost::interprocess::basic_vectorbuf< SendBuffer > m_encoder;
+    std::vector< SendBuffer >                          m_queue, m_writing, m_free;
+    std::vector< boost::asio::const_buffer >           m_sequence;
+    mega::U64                                          m_szQueuedBytes = 0U;
+    bool                                               m_bWriting      = false;
+    boost::system::error_code                          m_lastError;
+    boost::asio::steady_timer                          m_drainTimer;
+
+    void enqueue( const Message& msg )
+    {
+        SendBuffer buffer;
+        if( !m_free.empty() )
+        {
+            buffer.swap( m_free.back() );
+            m_free.pop_back();
+        }
+        buffer.resize( sizeof( MessageSize ) );
+
+        m_encoder.swap_vector( buffer );
+        m_encoder.pubseekpos( sizeof( MessageSize ) );
+        encode( m_encoder, msg );
+        m_encoder.swap_vector( buffer );
+
+        const MessageSize size = buffer.size() - sizeof( MessageSize );
+        std::memcpy( buffer.data(), &size, sizeof( MessageSize ) );
+
+        m_szQueuedBytes += buffer.size();
+        m_queue.push_back( std::move( buffer ) );
+    }
+
+    void recycle()
+    {
+        for( auto& buffer : m_writing )
+        {
+            m_szQueuedBytes -= buffer.size();
+            if( m_free.size() < MAX_FREE_BUFFERS )
+            {
+                buffer.clear();
+                m_free.push_back( std::move( buffer ) );
+            }
+        }
+        m_writing.clear();
+    }
 
 public:
     SocketSender( Traits::Socket& socket )
         : m_socket( socket )
+        , m_drainTimer( socket.get_executor() )
     {
     }
 
@@ -69,29 +125,61 @@ public:
 
     virtual boost::system::error_code send( const Message& msg, boost::asio::yield_context& yield_ctx )
     {
-        boost::interprocess::basic_vectorbuf< SendBuffer > m_os;
-        SendBuffer                                         m_buffer;
+        // backpressure until the writer drains the queue
+        while( m_szQueuedBytes >= HIGH_WATER_MARK && !m_lastError )
+        {
+            boost::system::error_code ec;
+            m_drainTimer.expires_at( boost::asio::steady_timer::time_point::max() );
+            m_drainTimer.async_wait( yield_ctx[ ec ] );
+        }
+        if( m_lastError )
         {
-            encode( m_os, msg );
-            const MessageSize size = m_os.vector().size();
-            std::string_view  sizeView( reinterpret_cast< const char* >( &size ), sizeof( MessageSize ) );
-            m_buffer.reserve( size + sizeof( MessageSize ) );
-            std::copy( sizeView.begin(), sizeView.end(), std::back_inserter( m_buffer ) );
-            std::copy( m_os.vector().begin(), m_os.vector().end(), std::back_inserter( m_buffer ) );
+            return m_lastError;
         }
 
+        enqueue( msg );
+
+        if( m_bWriting )
+        {
+            // the active writer will coalesce this message into its next write
+            return {};
+        }
+
+        m_bWriting = true;
+
+        // allow every sender ready in this turn to queue before writing
+        boost::asio::post( m_socket.get_executor(), yield_ctx );
+
         boost::system::error_code ec;
+        while( !m_queue.empty() && !ec )
         {
-            const mega::U64 szBytesWritten
-                = boost::asio::async_write( m_socket, boost::asio::buffer( m_buffer ), yield_ctx[ ec ] );
+            m_writing.swap( m_queue );
+
+            m_sequence.clear();
+            mega::U64 szTotal = 0U;
+            for( const auto& buffer : m_writing )
+            {
+                m_sequence.push_back( boost::asio::buffer( buffer ) );
+                szTotal += buffer.size();
+            }
+
+            const mega::U64 szBytesWritten = boost::asio::async_write( m_socket, m_sequence, yield_ctx[ ec ] );
             if( !ec )
             {
-                VERIFY_RTE( szBytesWritten == m_buffer.size() );
+                VERIFY_RTE( szBytesWritten == szTotal );
             }
-            return ec;
+            else
+            {
+                m_lastError = ec;
+            }
+
+            recycle();
+            m_drainTimer.cancel();
         }
+
+        m_bWriting = false;
+        return ec;
     }
-    
 };
 
 Sender::Ptr make_socket_sender( Traits::Socket& socket )
@@ -203,4 +291,113 @@ Sender::Ptr make_channel_sender( Channel& channel )
     return std::make_shared< ChannelSender >( channel );
 }
 
+// Writes size prefixed messages into the outbound ring.  The peer's receiver thread drains the
+// ring independently of its io_context so blocking here while the ring is full is bounded.
+class SharedMemorySender : public Sender
+{
+    using SendBuffer = std::vector< char >;
+
+    SharedMemoryChannel&                               m_channel;
+    std::mutex                                         m_mutex;
+    boost::interprocess::basic_vectorbuf< SendBuffer > m_encoder;
+    SendBuffer                                         m_buffer;
+
+public:
+    SharedMemorySender( SharedMemoryChannel& channel )
+        : m_channel( channel )
+    {
+    }
+
+    virtual ~SharedMemorySender() = default;
+
+    virtual boost::system::error_code send( const Message& msg )
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+
+        m_buffer.resize( sizeof( MessageSize ) );
+        m_encoder.swap_vector( m_buffer );
+        m_encoder.pubseekpos( sizeof( MessageSize ) );
+        encode( m_encoder, msg );
+        m_encoder.swap_vector( m_buffer );
+
+        const MessageSize size = m_buffer.size() - sizeof( MessageSize );
+        std::memcpy( m_buffer.data(), &size, sizeof( MessageSize ) );
+
+        if( !m_channel.outbound().write( m_buffer.data(), m_buffer.size() ) )
+        {
+            return boost::asio::error::make_error_code( boost::asio::error::broken_pipe );
+        }
+        return {};
+    }
+
+    virtual boost::system::error_code send( const Message& msg, boost::asio::yield_context& )
+    {
+        return send( msg );
+    }
+
+    // written once ahead of the first message - see SharedMemoryReceiver
+    boost::system::error_code sendFence( U64 uiSocketMessages )
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        if( !m_channel.outbound().write( reinterpret_cast< const char* >( &uiSocketMessages ), sizeof( U64 ) ) )
+        {
+            return boost::asio::error::make_error_code( boost::asio::error::broken_pipe );
+        }
+        return {};
+    }
+};
+
+SwitchableSender::SwitchableSender( Sender::Ptr pInitial )
+    : m_pInitial( std::move( pInitial ) )
+{
+}
+
+SwitchableSender::~SwitchableSender() = default;
+
+void SwitchableSender::switchTo( SharedMemoryChannel& channel )
+{
+    SharedMemoryChannel* pExpected = nullptr;
+    VERIFY_RTE_MSG( m_pPending.compare_exchange_strong( pExpected, &channel ), "SwitchableSender already switched" );
+}
+
+template < typename TSend >
+boost::system::error_code SwitchableSender::sendImpl( TSend&& send )
+{
+    if( !m_bSwitched.load() )
+    {
+        // keep to the socket while a socket send is suspended so nothing overtakes it
+        SharedMemoryChannel* pChannel = m_pPending.load();
+        if( !pChannel || m_uiInitialSending != 0U )
+        {
+            ++m_uiInitialSending;
+            const boost::system::error_code ec = send( *m_pInitial );
+            --m_uiInitialSending;
+            if( !ec )
+            {
+                ++m_uiInitialSent;
+            }
+            return ec;
+        }
+
+        auto pSwitched = std::make_shared< SharedMemorySender >( *pChannel );
+        if( const auto ec = pSwitched->sendFence( m_uiInitialSent ) )
+        {
+            return ec;
+        }
+        m_pSwitched = std::move( pSwitched );
+        m_bSwitched.store( true );
+    }
+    return send( *m_pSwitched );
+}
+
+boost::system::error_code SwitchableSender::send( const Message& msg )
+{
+    return sendImpl( [ &msg ]( Sender& sender ) { return sender.send( msg ); } );
+}
+
+boost::system::error_code SwitchableSender::send( const Message& msg, boost::asio::yield_context& yield_ctx )
+{
+    return sendImpl( [ &msg, &yield_ctx ]( Sender& sender ) { return sender.send( msg, yield_ctx ); } );
+}
+
 } // namespace mega::network
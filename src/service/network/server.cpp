@@ -45,11 +45,38 @@ void Server::Connection::start()
 {
     VERIFY_RTE_MSG( !weak_from_this().expired(), "Server::Connection bad weak_ptr" );
 
-    m_pSender = make_socket_sender( m_socket );
+    m_pSender = std::make_shared< SwitchableSender >( make_socket_sender( m_socket ) );
     m_receiver.run( m_strand, m_pSender );
     SPDLOG_TRACE( "Server::Connection::start connection started" );
 }
 
+boost::asio::ip::address Server::Connection::getRemoteAddress() const
+{
+    boost::system::error_code ec;
+    const auto                endPoint = m_socket.remote_endpoint( ec );
+    return ec ? boost::asio::ip::address{} : endPoint.address();
+}
+
+bool Server::Connection::isLocal() const
+{
+    return getRemoteAddress().is_loopback();
+}
+
+void Server::Connection::createSharedMemory( const std::string& strSegmentName )
+{
+    VERIFY_RTE_MSG( !m_pSharedMemory, "Duplicate shared memory for connection" );
+    m_pSharedMemory = std::make_unique< SharedMemoryChannel >( SharedMemoryChannel::Create{}, strSegmentName );
+    m_pSharedMemoryReceiver = std::make_unique< SharedMemoryReceiver >(
+        m_server.m_logicalThreadManager, *m_pSharedMemory, m_receiver );
+    m_pSharedMemoryReceiver->run( m_strand, m_pSender,
+                                  [ pSender = m_pSender, pChannel = m_pSharedMemory.get() ]
+                                  {
+                                      pChannel->unlink();
+                                      pSender->switchTo( *pChannel );
+                                  } );
+    SPDLOG_TRACE( "Server::Connection::createSharedMemory {}", strSegmentName );
+}
+
 void Server::Connection::stop()
 {
     m_socket.shutdown( Traits::Socket::shutdown_both );
@@ -65,6 +92,11 @@ void Server::Connection::disconnected()
         boost::system::error_code ec;
         m_socket.close( ec );
     }
+    if( m_pSharedMemoryReceiver )
+    {
+        m_pSharedMemoryReceiver->stop();
+        m_pSharedMemory->close();
+    }
     if( m_disconnectCallback.has_value() )
     {
         ( *m_disconnectCallback )();
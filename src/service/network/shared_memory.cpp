@@ -0,0 +1,361 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "service/network/shared_memory.hpp"
+#include "service/network/logical_thread_manager.hpp"
+#include "service/network/receiver.hpp"
+
+#include "service/protocol/common/received_message.hpp"
+#include "service/protocol/model/messages.hxx"
+
+#include "common/assert_verify.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <boost/asio/post.hpp>
+#include <boost/interprocess/permissions.hpp>
+#include <boost/interprocess/streams/bufferstream.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <ctime>
+#endif
+
+namespace mega::network
+{
+namespace
+{
+static constexpr U32  SPIN_COUNT   = 1 << 10;
+static constexpr long WAIT_TIMEOUT = 100'000'000; // nanoseconds
+static constexpr auto FENCE_POLL   = std::chrono::microseconds( 50 );
+
+inline void futexWait( std::atomic< U32 >& word, U32 uiExpected )
+{
+#ifdef __linux__
+    // NOT FUTEX_PRIVATE - the word is shared between processes
+    const timespec timeout{ 0, WAIT_TIMEOUT };
+    syscall( SYS_futex, reinterpret_cast< U32* >( &word ), FUTEX_WAIT, uiExpected, &timeout, nullptr, 0 );
+#else
+    if( word.load() == uiExpected )
+    {
+        std::this_thread::sleep_for( std::chrono::microseconds( 50 ) );
+    }
+#endif
+}
+
+inline void futexWake( std::atomic< U32 >& word )
+{
+#ifdef __linux__
+    syscall( SYS_futex, reinterpret_cast< U32* >( &word ), FUTEX_WAKE, std::numeric_limits< int >::max(), nullptr,
+             nullptr, 0 );
+#endif
+}
+
+inline void notify( std::atomic< U32 >& signal, std::atomic< U32 >& waiting )
+{
+    signal.fetch_add( 1U );
+    if( waiting.load() != 0U )
+    {
+        futexWake( signal );
+    }
+}
+
+// spin then sleep on the signal word until bReady.  waiting is published before the
+// final check so a concurrent notify either sees it or has already made bReady true.
+template < typename TReady, typename TCancelled >
+inline bool waitFor( std::atomic< U32 >& signal, std::atomic< U32 >& waiting, TReady&& bReady,
+                     TCancelled&& bCancelled )
+{
+    for( U32 ui = 0U; ui != SPIN_COUNT; ++ui )
+    {
+        if( bReady() )
+        {
+            return true;
+        }
+    }
+    while( true )
+    {
+        if( bReady() )
+        {
+            return true;
+        }
+        if( bCancelled() )
+        {
+            return false;
+        }
+        const U32 uiSeq = signal.load();
+        waiting.store( 1U );
+        if( bReady() )
+        {
+            waiting.store( 0U );
+            return true;
+        }
+        futexWait( signal, uiSeq );
+        waiting.store( 0U );
+    }
+}
+} // namespace
+
+SharedMemoryRing::SharedMemoryRing( Header* pHeader, char* pData, U64 szCapacity )
+    : m_pHeader( pHeader )
+    , m_pData( pData )
+    , m_szCapacity( szCapacity )
+{
+    VERIFY_RTE_MSG( ( m_szCapacity & ( m_szCapacity - 1 ) ) == 0, "Shared memory ring size must be a power of two" );
+}
+
+U64 SharedMemoryRing::available() const
+{
+    return m_pHeader->head.load() - m_pHeader->tail.load( std::memory_order_relaxed );
+}
+
+U64 SharedMemoryRing::space() const
+{
+    return m_szCapacity - ( m_pHeader->head.load( std::memory_order_relaxed ) - m_pHeader->tail.load() );
+}
+
+bool SharedMemoryRing::write( const char* pData, U64 szSize )
+{
+    while( szSize != 0U )
+    {
+        if( !waitFor(
+                m_pHeader->spaceSignal, m_pHeader->producerWaiting, [ this ] { return space() != 0U; },
+                [ this ] { return isClosed(); } ) )
+        {
+            return false;
+        }
+
+        const U64 szHead   = m_pHeader->head.load( std::memory_order_relaxed );
+        const U64 szChunk  = std::min( szSize, space() );
+        const U64 szOffset = szHead & ( m_szCapacity - 1 );
+        const U64 szFirst  = std::min( szChunk, m_szCapacity - szOffset );
+        std::memcpy( m_pData + szOffset, pData, szFirst );
+        std::memcpy( m_pData, pData + szFirst, szChunk - szFirst );
+        m_pHeader->head.store( szHead + szChunk );
+        notify( m_pHeader->dataSignal, m_pHeader->consumerWaiting );
+
+        pData += szChunk;
+        szSize -= szChunk;
+    }
+    return true;
+}
+
+bool SharedMemoryRing::read( char* pData, U64 szSize, const std::atomic< bool >& bStop )
+{
+    while( szSize != 0U )
+    {
+        if( !waitFor(
+                m_pHeader->dataSignal, m_pHeader->consumerWaiting, [ this ] { return available() != 0U; },
+                [ this, &bStop ] { return isClosed() || bStop.load(); } ) )
+        {
+            return false;
+        }
+
+        const U64 szTail   = m_pHeader->tail.load( std::memory_order_relaxed );
+        const U64 szChunk  = std::min( szSize, available() );
+        const U64 szOffset = szTail & ( m_szCapacity - 1 );
+        const U64 szFirst  = std::min( szChunk, m_szCapacity - szOffset );
+        std::memcpy( pData, m_pData + szOffset, szFirst );
+        std::memcpy( pData + szFirst, m_pData, szChunk - szFirst );
+        m_pHeader->tail.store( szTail + szChunk );
+        notify( m_pHeader->spaceSignal, m_pHeader->producerWaiting );
+
+        pData += szChunk;
+        szSize -= szChunk;
+    }
+    return true;
+}
+
+void SharedMemoryRing::close()
+{
+    m_pHeader->closed.store( 1U );
+    futexWake( m_pHeader->dataSignal );
+    futexWake( m_pHeader->spaceSignal );
+}
+
+SharedMemoryChannel::SharedMemoryChannel( Create, const std::string& strName, U64 szRingSize )
+    : m_strName( strName )
+    , m_bCreator( true )
+{
+    using namespace boost::interprocess;
+    // create_only fails rather than reuse a segment someone else created under the name
+    m_sharedMemory = shared_memory_object( create_only, m_strName.c_str(), read_write, permissions( 0600 ) );
+    m_sharedMemory.truncate( 2 * ( sizeof( SharedMemoryRing::Header ) + szRingSize ) );
+    m_region = mapped_region( m_sharedMemory, read_write );
+
+    char* pBase = reinterpret_cast< char* >( m_region.get_address() );
+    for( int i = 0; i != 2; ++i )
+    {
+        new( pBase + i * sizeof( SharedMemoryRing::Header ) ) SharedMemoryRing::Header{};
+    }
+    map( true );
+}
+
+SharedMemoryChannel::SharedMemoryChannel( Open, const std::string& strName )
+    : m_strName( strName )
+    , m_bCreator( false )
+{
+    using namespace boost::interprocess;
+    m_sharedMemory = shared_memory_object( open_only, m_strName.c_str(), read_write );
+    m_region       = mapped_region( m_sharedMemory, read_write );
+    map( false );
+}
+
+void SharedMemoryChannel::map( bool bCreator )
+{
+    using Header = SharedMemoryRing::Header;
+
+    const U64 szRingSize = ( m_region.get_size() - 2 * sizeof( Header ) ) / 2;
+    char*     pBase      = reinterpret_cast< char* >( m_region.get_address() );
+    Header*   pHeaders   = std::launder( reinterpret_cast< Header* >( pBase ) );
+    char*     pData      = pBase + 2 * sizeof( Header );
+
+    auto pFirst  = std::make_unique< SharedMemoryRing >( pHeaders, pData, szRingSize );
+    auto pSecond = std::make_unique< SharedMemoryRing >( pHeaders + 1, pData + szRingSize, szRingSize );
+    if( bCreator )
+    {
+        m_pOutbound = std::move( pFirst );
+        m_pInbound  = std::move( pSecond );
+    }
+    else
+    {
+        m_pOutbound = std::move( pSecond );
+        m_pInbound  = std::move( pFirst );
+    }
+}
+
+void SharedMemoryChannel::close()
+{
+    m_pOutbound->close();
+    m_pInbound->close();
+}
+
+void SharedMemoryChannel::unlink()
+{
+    if( m_bCreator )
+    {
+        boost::interprocess::shared_memory_object::remove( m_strName.c_str() );
+    }
+}
+
+SharedMemoryChannel::~SharedMemoryChannel()
+{
+    close();
+    unlink();
+}
+
+SharedMemoryReceiver::SharedMemoryReceiver( LogicalThreadManager& logicalthreadManager, SharedMemoryChannel& channel,
+                                            const SocketReceiver& socketReceiver )
+    : m_logicalThreadManager( logicalthreadManager )
+    , m_channel( channel )
+    , m_socketReceiver( socketReceiver )
+{
+}
+
+SharedMemoryReceiver::~SharedMemoryReceiver()
+{
+    stop();
+}
+
+void SharedMemoryReceiver::run( boost::asio::any_io_executor executor, Sender::Ptr pSender,
+                                std::function< void() > onAttach )
+{
+    VERIFY_RTE_MSG( !m_thread.joinable(), "SharedMemoryReceiver already running" );
+    m_thread = std::thread( [ this, executor, pSender, onAttach ]() { receive( executor, pSender, onAttach ); } );
+}
+
+void SharedMemoryReceiver::stop()
+{
+    m_bStop = true;
+    m_channel.inbound().close();
+    if( m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id() )
+    {
+        m_thread.join();
+    }
+}
+
+void SharedMemoryReceiver::receive( boost::asio::any_io_executor executor, Sender::Ptr pSender,
+                                    std::function< void() > onAttach )
+{
+    SharedMemoryRing&   ring = m_channel.inbound();
+    std::vector< char > buffer;
+
+    // messages the peer sent over the socket before switching must be dispatched first
+    U64 uiSocketMessages = 0U;
+    if( !ring.read( reinterpret_cast< char* >( &uiSocketMessages ), sizeof( U64 ), m_bStop ) )
+    {
+        return;
+    }
+    while( m_socketReceiver.getReceivedCount() < uiSocketMessages )
+    {
+        if( m_bStop || ring.isClosed() )
+        {
+            return;
+        }
+        std::this_thread::sleep_for( FENCE_POLL );
+    }
+    if( onAttach )
+    {
+        onAttach();
+    }
+
+    while( !m_bStop )
+    {
+        MessageSize size = 0U;
+        if( !ring.read( reinterpret_cast< char* >( &size ), sizeof( MessageSize ), m_bStop ) )
+        {
+            break;
+        }
+        buffer.resize( size );
+        if( !ring.read( buffer.data(), size, m_bStop ) )
+        {
+            break;
+        }
+
+        Message msg;
+        try
+        {
+            boost::interprocess::bufferbuf is( buffer.data(), buffer.size() );
+            decode( is, msg );
+        }
+        catch( std::exception& ex )
+        {
+            SPDLOG_ERROR( "SharedMemoryReceiver: Error decoding message: {}", ex.what() );
+            break;
+        }
+
+        // the receiver is owned by the connection which may be gone by the time this runs
+        boost::asio::post( executor,
+                           [ &logicalThreadManager = m_logicalThreadManager,
+                             receivedMsg           = ReceivedMessage{ pSender, std::move( msg ) } ]()
+                           { logicalThreadManager.dispatch( receivedMsg ); } );
+    }
+}
+
+} // namespace mega::network
@@ -90,6 +90,12 @@ void StatusPrinter::printNodeInfo( const network::Status& status, std::ostream&
         {
             line( os, indent ) << "Program: " << status.getProgram().value() << "\n";
         }
+        if( status.getJIT().has_value() )
+        {
+            const network::JITStatus& jit = status.getJIT().value();
+            line( os, indent ) << "JIT Cache: " << jit.m_objectCacheHits << " hits " << jit.m_objectCacheMisses
+                               << " misses\n";
+        }
         if( status.getLogFile().has_value() )
         {
             if( const auto& log = status.getLogFile().value(); !log.empty() )
@@ -174,6 +180,24 @@ void StatusPrinter::printNodeInfo( const network::Status& status, std::ostream&
         }
     }
 
+    if( m_config.m_bDispatch )
+    {
+        if( status.getDispatch().has_value() )
+        {
+            for( const auto& message : status.getDispatch().value().m_messages )
+            {
+                line( os, indent ) << message.name << ": " << message.count << " calls "
+                                   << ( message.totalMicroseconds / message.count ) << "us mean "
+                                   << message.maxMicroseconds << "us max histogram:";
+                for( auto uiBucket : message.histogram )
+                {
+                    os << ' ' << uiBucket;
+                }
+                os << "\n";
+            }
+        }
+    }
+
     if( m_config.m_bLogicalThreads )
     {
         for( const auto& threadID : status.getLogicalThreads() )
@@ -43,6 +43,7 @@ struct MemoryRecordHeader
 {
     mega::U16       size;
     mega::runtime::Pointer ref;
+    mega::U8        encoding;
     mega::U16       dataSize;
 };
 #pragma pack()
@@ -0,0 +1,90 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "service/protocol/common/dispatch_table.hpp"
+
+#include <atomic>
+
+namespace mega::network
+{
+
+namespace
+{
+struct MessageCounters
+{
+    std::atomic< U64 >                                                 count             = 0;
+    std::atomic< U64 >                                                 totalMicroseconds = 0;
+    std::atomic< U64 >                                                 maxMicroseconds   = 0;
+    std::array< std::atomic< U64 >, DispatchStatus::HistogramBuckets > histogram{};
+};
+
+std::array< MessageCounters, messageCount > g_dispatchCounters;
+
+inline U64 toBucket( U64 uiMicroseconds )
+{
+    U64 uiBucket = 0U;
+    while( ( uiMicroseconds >>= 1 ) != 0U && uiBucket + 1U < DispatchStatus::HistogramBuckets )
+    {
+        ++uiBucket;
+    }
+    return uiBucket;
+}
+} // namespace
+
+void recordDispatch( MessageID id, std::chrono::steady_clock::duration duration )
+{
+    const U64 uiMicroseconds = std::chrono::duration_cast< std::chrono::microseconds >( duration ).count();
+
+    MessageCounters& counters = g_dispatchCounters[ id ];
+    counters.count.fetch_add( 1U, std::memory_order_relaxed );
+    counters.totalMicroseconds.fetch_add( uiMicroseconds, std::memory_order_relaxed );
+    counters.histogram[ toBucket( uiMicroseconds ) ].fetch_add( 1U, std::memory_order_relaxed );
+
+    U64 uiMax = counters.maxMicroseconds.load( std::memory_order_relaxed );
+    while( uiMicroseconds > uiMax
+           && !counters.maxMicroseconds.compare_exchange_weak( uiMax, uiMicroseconds, std::memory_order_relaxed ) )
+    {
+    }
+}
+
+DispatchStatus getDispatchStatus()
+{
+    DispatchStatus status;
+    for( MessageID id = 0; id != messageCount; ++id )
+    {
+        const MessageCounters& counters = g_dispatchCounters[ id ];
+        if( const U64 uiCount = counters.count.load( std::memory_order_relaxed ); uiCount != 0U )
+        {
+            DispatchStatus::MessageStatus messageStatus;
+            messageStatus.name              = getMsgNameFromID( id );
+            messageStatus.count             = uiCount;
+            messageStatus.totalMicroseconds = counters.totalMicroseconds.load( std::memory_order_relaxed );
+            messageStatus.maxMicroseconds   = counters.maxMicroseconds.load( std::memory_order_relaxed );
+            for( const auto& bucket : counters.histogram )
+            {
+                messageStatus.histogram.push_back( bucket.load( std::memory_order_relaxed ) );
+            }
+            status.m_messages.emplace_back( std::move( messageStatus ) );
+        }
+    }
+    return status;
+}
+
+} // namespace mega::network
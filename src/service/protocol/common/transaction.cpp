@@ -29,6 +29,7 @@ TransactionProducer::TransactionProducer( mega::event::FileStorage& log )
     : m_log( log )
     , m_iteratorEnd( m_log.getIterator() )
     , m_iterator( m_log.getIterator() )
+    , m_timestamp( m_log.getTimeStamp() )
 {
 }
 void TransactionProducer::generateStructure( MPOTransactions& transactions, UnparentedSet&, MovedObjects& movedObjects )
@@ -120,11 +121,34 @@ void TransactionProducer::generateMemory( MPOTransactions& transactions )
     using RecordType                          = event::Memory::Read;
     event::FileIterator< RecordType > iter    = m_log.begin< RecordType >( m_iterator );
     event::FileIterator< RecordType > iterEnd = m_log.begin< RecordType >( m_iteratorEnd );
-    for( ; iter != iterEnd; ++iter )
+
+    // resolve delta records against the earlier records for the same reference
+    auto decodeUntil = [ & ]( const event::FileIterator< RecordType >& iterUntil )
     {
-        const RecordType r = *iter;
-        transactions[ r.getRef().getMPO() ].push_back( r );
+        for( ; iter != iterUntil; ++iter )
+        {
+            const RecordType r = *iter;
+            if( std::optional< std::string_view > value = m_memoryDecoder.decode( r ) )
+            {
+                transactions[ r.getRef().getMPO() ].push_back( r.getRef(), value.value() );
+            }
+        }
+    };
+
+    // every reference is written in full after a key frame so earlier values are no longer needed.
+    // The key frame of the current timestamp may already have been passed if records were read part way through it.
+    const runtime::TimeStamp now = m_log.getTimeStamp();
+    for( runtime::TimeStamp keyFrame = event::memory_codec::nextKeyFrame( m_timestamp ); !( now < keyFrame );
+         keyFrame = event::memory_codec::nextKeyFrame( runtime::TimeStamp{ keyFrame.getValue() + 1U } ) )
+    {
+        const event::FileIterator< RecordType > iterKeyFrame = m_log.begin< RecordType >( keyFrame );
+        if( ( keyFrame != m_timestamp ) || ( iter == iterKeyFrame ) )
+        {
+            decodeUntil( iterKeyFrame );
+            m_memoryDecoder.clear();
+        }
     }
+    decodeUntil( iterEnd );
 }
 
 void TransactionProducer::generate( MPOTransactions& transactions, UnparentedSet& unparented,
@@ -134,7 +158,8 @@ void TransactionProducer::generate( MPOTransactions& transactions, UnparentedSet
     generateEvent( transactions );
     generateTransition( transactions );
     generateMemory( transactions );
-    m_iterator = m_iteratorEnd;
+    m_iterator  = m_iteratorEnd;
+    m_timestamp = m_log.getTimeStamp();
 }
 
 } // namespace mega::network
\ No newline at end of file
@@ -77,6 +77,14 @@ network::memory::Request_Encoder MPOLogicalThread::getDaemonMemoryRequest()
              getID() };
 }
 
+network::sim::Request_Encoder MPOLogicalThread::getDaemonSimRequest()
+{
+    VERIFY_RTE( m_pYieldContext );
+    return { [ leafRequest = getPythonRequest( *m_pYieldContext ) ]( const network::Message& msg ) mutable
+             { return leafRequest.PythonDaemon( msg ); },
+             getID() };
+}
+
 network::sim::Request_Encoder MPOLogicalThread::getMPOSimRequest( runtime::MPO mpo )
 {
     VERIFY_RTE( m_pYieldContext );
@@ -42,6 +42,7 @@ public:
     virtual network::enrole::Request_Encoder getRootEnroleRequest() override;
     virtual network::stash::Request_Encoder  getRootStashRequest() override;
     virtual network::memory::Request_Encoder getDaemonMemoryRequest() override;
+    virtual network::sim::Request_Encoder    getDaemonSimRequest() override;
     virtual network::sim::Request_Encoder    getMPOSimRequest( mega::runtime::MPO mpo ) override;
     virtual network::memory::Request_Sender  getLeafMemoryRequest() override;
     virtual network::jit::Request_Sender     getLeafJITRequest() override;
@@ -32,6 +32,7 @@
 #include "service/protocol/model/report.hxx"
 #include "service/protocol/model/project.hxx"
 #include "service/protocol/model/python.hxx"
+#include "service/protocol/model/sim.hxx"
 
 namespace mega::service::python
 {
@@ -42,7 +43,8 @@ class PythonRequestLogicalThread : public network::InThreadLogicalThread,
                                    public network::mpo::Impl,
                                    public network::status::Impl,
                                    public network::report::Impl,
-                                   public network::project::Impl
+                                   public network::project::Impl,
+                                   public network::sim::Impl
 {
 protected:
     Python& m_python;
@@ -104,6 +106,11 @@ public:
     virtual Report GetReport( const URL&    url,
                               const std::vector< Report >& report,
                               boost::asio::yield_context&  yield_ctx ) override;
+
+    // network::sim::Impl
+    virtual void SimLeaseInvalidate( const mega::runtime::MPO&                ownerMPO,
+                                     const std::vector< mega::runtime::MPO >& leaseHolders,
+                                     boost::asio::yield_context&              yield_ctx ) override;
 };
 
 } // namespace mega::service::python
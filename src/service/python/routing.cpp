@@ -40,18 +40,20 @@ PythonRequestLogicalThread::~PythonRequestLogicalThread()
 network::Message PythonRequestLogicalThread::dispatchInBoundRequest( const network::Message&     msg,
                                                                      boost::asio::yield_context& yield_ctx )
 {
-    network::Message result;
-    if( result = network::leaf_python::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::python_leaf::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::mpo::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::project::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::status::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::report::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
+    // clang-format off
+    static constexpr auto table = network::DispatchTable< PythonRequestLogicalThread >::make
+    <
+        network::leaf_python::Impl,
+        network::python_leaf::Impl,
+        network::mpo::Impl,
+        network::project::Impl,
+        network::status::Impl,
+        network::report::Impl,
+        network::sim::Impl
+    >();
+    // clang-format on
+
+    if( network::Message result = table.dispatch( *this, msg, yield_ctx ); result )
         return result;
     THROW_RTE( "PythonRequestLogicalThread::dispatchInBoundRequest failed: " << msg );
 }
@@ -165,4 +167,18 @@ network::Message PythonRequestLogicalThread::MPODown( const network::Message& re
     return dispatchInBoundRequest( request, yield_ctx );
 }
 
+void PythonRequestLogicalThread::SimLeaseInvalidate( const mega::runtime::MPO& ownerMPO,
+                                                     const std::vector< mega::runtime::MPO >&,
+                                                     boost::asio::yield_context& )
+{
+    // the leases are held by the lock tracker of the python mpo logical thread
+    for( auto pThread : m_python.getLogicalThreads() )
+    {
+        if( auto pMPOThread = std::dynamic_pointer_cast< MPOLogicalThread >( pThread ) )
+        {
+            pMPOThread->leaseInvalidated( ownerMPO );
+        }
+    }
+}
+
 } // namespace mega::service::python
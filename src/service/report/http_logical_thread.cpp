@@ -97,6 +97,14 @@ network::memory::Request_Encoder HTTPLogicalThread::getDaemonMemoryRequest()
              getID() };
 }
 
+network::sim::Request_Encoder HTTPLogicalThread::getDaemonSimRequest()
+{
+    VERIFY_RTE( m_pYieldContext );
+    return { [ leafRequest = getReportRequest( *m_pYieldContext ) ]( const network::Message& msg ) mutable
+             { return leafRequest.ReportDaemon( msg ); },
+             getID() };
+}
+
 network::sim::Request_Encoder HTTPLogicalThread::getMPOSimRequest( runtime::MPO mpo )
 {
     VERIFY_RTE( m_pYieldContext );
@@ -32,6 +32,7 @@
 #include "service/protocol/model/mpo.hxx"
 #include "service/protocol/model/status.hxx"
 #include "service/protocol/model/project.hxx"
+#include "service/protocol/model/sim.hxx"
 
 namespace mega::service::report
 {
@@ -42,7 +43,8 @@ class ReportRequestLogicalThread : public network::InThreadLogicalThread,
                                    public network::mpo::Impl,
                                    public network::status::Impl,
                                    public network::project::Impl,
-                                   public network::report::Impl
+                                   public network::report::Impl,
+                                   public network::sim::Impl
 {
 protected:
     ReportServer& m_reportServer;
@@ -101,6 +103,11 @@ public:
     // network::report::Impl
     virtual Report
     GetReport( const URL& url, const std::vector< Report >& report, boost::asio::yield_context& yield_ctx ) override;
+
+    // network::sim::Impl
+    virtual void SimLeaseInvalidate( const mega::runtime::MPO&                ownerMPO,
+                                     const std::vector< mega::runtime::MPO >& leaseHolders,
+                                     boost::asio::yield_context&              yield_ctx ) override;
 };
 
 } // namespace mega::service::report
@@ -39,18 +39,20 @@ ReportRequestLogicalThread::~ReportRequestLogicalThread()
 network::Message ReportRequestLogicalThread::dispatchInBoundRequest( const network::Message&     msg,
                                                              boost::asio::yield_context& yield_ctx )
 {
-    network::Message result;
-    if( result = network::leaf_report::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::report_leaf::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::mpo::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::project::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::status::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::report::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
+    // clang-format off
+    static constexpr auto table = network::DispatchTable< ReportRequestLogicalThread >::make
+    <
+        network::leaf_report::Impl,
+        network::report_leaf::Impl,
+        network::mpo::Impl,
+        network::project::Impl,
+        network::status::Impl,
+        network::report::Impl,
+        network::sim::Impl
+    >();
+    // clang-format on
+
+    if( network::Message result = table.dispatch( *this, msg, yield_ctx ); result )
         return result;
     THROW_RTE( "ReportRequestLogicalThread::dispatchInBoundRequest failed: " << msg );
 }
@@ -158,4 +160,19 @@ network::Message ReportRequestLogicalThread::MPODown( const network::Message& re
     return dispatchInBoundRequest( request, yield_ctx );
 }
 
+void ReportRequestLogicalThread::SimLeaseInvalidate( const mega::runtime::MPO& ownerMPO,
+                                                     const std::vector< mega::runtime::MPO >&,
+                                                     boost::asio::yield_context& )
+{
+    // every http logical thread has its own lock tracker so drop the lease from all of them.
+    // Any that did not hold it simply lose nothing.
+    for( auto pThread : m_reportServer.getLogicalThreads() )
+    {
+        if( auto pHTTPThread = std::dynamic_pointer_cast< HTTPLogicalThread >( pThread ) )
+        {
+            pHTTPThread->leaseInvalidated( ownerMPO );
+        }
+    }
+}
+
 } // namespace mega::service::report
@@ -25,6 +25,7 @@
 
 #include "common/string.hpp"
 
+#include <boost/asio/ip/host_name.hpp>
 #include <boost/asio/steady_timer.hpp>
 
 #include <chrono>
@@ -50,6 +51,32 @@ runtime::MachineID RootRequestLogicalThread::EnroleDaemon( boost::asio::yield_co
     return machineID;
 }
 
+void RootRequestLogicalThread::EnroleDaemonListen( const mega::U64& daemonPort, boost::asio::yield_context& )
+{
+    auto pConnection = m_root.m_server.getConnection( getOriginatingStackResponseSender() );
+    VERIFY_RTE( pConnection );
+    VERIFY_RTE( pConnection->getLabel().has_value() );
+    const runtime::MachineID machineID = std::get< runtime::MachineID >( pConnection->getLabel().value() );
+
+    // a daemon sharing the root machine is reachable by host name from the others
+    const auto         address = pConnection->getRemoteAddress();
+    std::ostringstream os;
+    os << ( address.is_loopback() ? boost::asio::ip::host_name() : address.to_string() ) << ':' << daemonPort;
+    SPDLOG_TRACE( "RootRequestLogicalThread::EnroleDaemonListen: {} {}", machineID, os.str() );
+    m_root.m_daemonEndPoints[ machineID ] = os.str();
+}
+
+std::string RootRequestLogicalThread::EnroleDaemonEndPoint( const runtime::MachineID& daemonMachineID,
+                                                            boost::asio::yield_context& )
+{
+    auto iFind = m_root.m_daemonEndPoints.find( daemonMachineID );
+    if( iFind != m_root.m_daemonEndPoints.end() )
+    {
+        return iFind->second;
+    }
+    return {};
+}
+
 runtime::MP RootRequestLogicalThread::EnroleLeafWithRoot( const std::string&        startupUUID,
                                                           const runtime::MachineID& machineID,
                                                           boost::asio::yield_context& )
@@ -53,7 +53,7 @@ void RootJobLogicalThread::JobReadyForWork( const network::LogicalThreadID& root
             const mega::pipeline::TaskDescriptor task = pCoordinator->getTask( yield_ctx );
             if( task == mega::pipeline::TaskDescriptor() )
             {
-                pCoordinator->completeTask( mega::pipeline::TaskDescriptor(), true, yield_ctx );
+                pCoordinator->completeTask( mega::pipeline::TaskDescriptor(), true, {}, yield_ctx );
                 break;
             }
             else
@@ -64,12 +64,16 @@ void RootJobLogicalThread::JobReadyForWork( const network::LogicalThreadID& root
                     pipeline::PipelineResult result = exeRequest.JobStartTask( task );
                     network::logLinesSuccessFail( result.getMessage(), result.getSuccess(),
                                                   std::chrono::duration_cast< network::LogTime >( sw.elapsed() ) );
-                    pCoordinator->completeTask( task, result.getSuccess(), yield_ctx );
+                    pCoordinator->completeTask(
+                        task, result.getSuccess(),
+                        std::chrono::duration_cast< pipeline::TaskDurations::Duration >( sw.elapsed() ), yield_ctx );
                 }
                 catch( std::exception& ex )
                 {
                     network::logLinesWarn( task.getName(), ex.what() );
-                    pCoordinator->completeTask( task, false, yield_ctx );
+                    pCoordinator->completeTask(
+                        task, false, std::chrono::duration_cast< pipeline::TaskDurations::Duration >( sw.elapsed() ),
+                        yield_ctx );
                 }
             }
         }
@@ -20,7 +20,9 @@
 #ifndef MPO_MANAGER_25_AUG_2022
 #define MPO_MANAGER_25_AUG_2022
 
-#include "mega/ring_allocator.hpp"
+#include "mega/bitmap_allocator.hpp"
+
+#include "mega/values/runtime/mpo.hpp"
 
 #include "mega/values/service/logical_thread_id.hpp"
 #include "log/log.hpp"
@@ -29,7 +31,6 @@
 
 #include <unordered_map>
 #include <unordered_set>
-#include <array>
 #include <limits>
 
 namespace mega::service
@@ -42,13 +43,14 @@ class MPOManager
         static constexpr auto MAX_PROCESS_PER_MACHINE = std::numeric_limits< runtime::ProcessID::ValueType >::max();
         static constexpr auto MAX_OWNER_PER_PROCESS   = std::numeric_limits< runtime::OwnerID::ValueType >::max();
 
-        using ProcessAllocator = RingAllocator< runtime::ProcessID, MAX_PROCESS_PER_MACHINE >;
-        using OwnerAllocator   = RingAllocator< runtime::OwnerID, MAX_OWNER_PER_PROCESS >;
-        using OwnerArray       = std::array< OwnerAllocator, MAX_PROCESS_PER_MACHINE >;
+        using ProcessAllocator = BitmapAllocator< runtime::ProcessID, MAX_PROCESS_PER_MACHINE >;
+        using OwnerAllocator   = BitmapAllocator< runtime::OwnerID, MAX_OWNER_PER_PROCESS >;
+        // owner allocators only exist for processes that have allocated an owner
+        using OwnerMap = std::unordered_map< runtime::ProcessID::ValueType, OwnerAllocator >;
 
         runtime::MachineID m_machineID;
         ProcessAllocator   m_processes;
-        OwnerArray         m_owners;
+        OwnerMap           m_owners;
 
     public:
         MachineAllocators( runtime::MachineID machineID )
@@ -75,14 +77,14 @@ class MPOManager
             m_processes.free( mp.getProcessID() );
 
             std::vector< runtime::MPO > allocated;
+            if( auto iFind = m_owners.find( mp.getProcessID().getValue() ); iFind != m_owners.end() )
             {
                 // free all owners for the process
-                OwnerAllocator& owners = m_owners[ mp.getProcessID().getValue() ];
-                for( runtime::OwnerID id : owners.getAllocated() )
+                for( runtime::OwnerID id : iFind->second.getAllocated() )
                 {
                     allocated.emplace_back( runtime::MPO( mp.getMachineID(), mp.getProcessID(), id ) );
                 }
-                owners.reset();
+                m_owners.erase( iFind );
             }
 
             return allocated;
@@ -101,7 +103,13 @@ class MPOManager
             return mpo;
         }
 
-        void release( runtime::MPO mpo ) { m_owners[ mpo.getProcessID().getValue() ].free( mpo.getOwnerID() ); }
+        void release( runtime::MPO mpo )
+        {
+            if( auto iFind = m_owners.find( mpo.getProcessID().getValue() ); iFind != m_owners.end() )
+            {
+                iFind->second.free( mpo.getOwnerID() );
+            }
+        }
 
         std::vector< runtime::MP > getProcesses() const
         {
@@ -116,9 +124,12 @@ class MPOManager
         std::vector< runtime::MPO > getOwners( runtime::MP mp ) const
         {
             std::vector< runtime::MPO > owners;
-            for( auto id : m_owners[ mp.getProcessID().getValue() ].getAllocated() )
+            if( auto iFind = m_owners.find( mp.getProcessID().getValue() ); iFind != m_owners.end() )
             {
-                owners.emplace_back( runtime::MPO( mp, id ) );
+                for( auto id : iFind->second.getAllocated() )
+                {
+                    owners.emplace_back( runtime::MPO( mp, id ) );
+                }
             }
             return owners;
         }
@@ -25,6 +25,10 @@
 
 #include "spdlog/stopwatch.h"
 
+#include <algorithm>
+#include <functional>
+#include <set>
+
 namespace mega::service
 {
 
@@ -88,44 +92,52 @@ RootPipelineLogicalThread::PipelineRun( const mega::pipeline::Configuration& con
     }
     SPDLOG_TRACE( "Found {} jobs for pipeline {}", m_jobs.size(), configuration.getPipelineID() );
 
-    mega::pipeline::Schedule                   schedule = pPipeline->getSchedule( *this, *this );
-    std::set< mega::pipeline::TaskDescriptor > scheduledTasks, activeTasks;
+    mega::pipeline::Schedule           schedule = pPipeline->getSchedule( *this, *this );
+    const mega::pipeline::CriticalPath estimatedPath( schedule.getDependencies(), m_root.m_taskDurations );
+
+    // ready tasks ordered by longest remaining path from previous build durations
+    using RankedTask = std::pair< mega::pipeline::CriticalPath::Duration, mega::pipeline::TaskDescriptor >;
+    std::set< RankedTask, std::greater< RankedTask > > rankedTasks;
+    auto rankReady = [ & ]()
+    {
+        for( const mega::pipeline::TaskDescriptor& task : schedule.takeReady() )
+        {
+            VERIFY_RTE( task != mega::pipeline::TaskDescriptor() );
+            rankedTasks.insert( { estimatedPath.getRemaining( task ), task } );
+        }
+    };
+
+    // only as many tasks in flight as there are jobs so every free job takes the highest ranked task
+    const std::size_t szSlots = std::min< std::size_t >( m_jobs.size(), CHANNEL_SIZE );
+
+    mega::pipeline::TaskDurations              runDurations;
+    std::set< mega::pipeline::TaskDescriptor > activeTasks;
     bool                                       bScheduleFailed = false;
     {
+        rankReady();
         while( !schedule.isComplete() && !bScheduleFailed )
         {
-            for( const mega::pipeline::TaskDescriptor& task : schedule.getReady() )
+            while( activeTasks.size() < szSlots && !rankedTasks.empty() )
             {
-                VERIFY_RTE( task != mega::pipeline::TaskDescriptor() );
-                if( activeTasks.size() < CHANNEL_SIZE )
-                {
-                    if( !scheduledTasks.count( task ) )
-                    {
-                        scheduledTasks.insert( task );
-                        VERIFY_RTE( activeTasks.insert( task ).second );
-                        m_taskReady.async_send( boost::system::error_code(), task, yield_ctx );
-                    }
-                }
-                else
-                    break;
+                const mega::pipeline::TaskDescriptor task = rankedTasks.begin()->second;
+                rankedTasks.erase( rankedTasks.begin() );
+                VERIFY_RTE( activeTasks.insert( task ).second );
+                m_taskReady.async_send( boost::system::error_code(), task, yield_ctx );
             }
+            VERIFY_RTE_MSG( !activeTasks.empty(), "Pipeline schedule cannot progress" );
 
-            while( !activeTasks.empty() )
+            const TaskCompletion taskCompletion = m_taskComplete.async_receive( yield_ctx );
+            VERIFY_RTE( activeTasks.erase( taskCompletion.task ) == 1U );
+            if( taskCompletion.bSuccess )
+            {
+                runDurations.record( taskCompletion.task, taskCompletion.duration );
+                schedule.complete( taskCompletion.task );
+                rankReady();
+            }
+            else
             {
-                const TaskCompletion taskCompletion = m_taskComplete.async_receive( yield_ctx );
-                VERIFY_RTE( activeTasks.erase( taskCompletion.task ) == 1U );
-                if( taskCompletion.bSuccess )
-                {
-                    schedule.complete( taskCompletion.task );
-                }
-                else
-                {
-                    SPDLOG_WARN( "Pipeline failed at task: {}", taskCompletion.task.getName() );
-                    bScheduleFailed = true;
-                    break;
-                }
-                if( !m_taskComplete.ready() )
-                    break;
+                SPDLOG_WARN( "Pipeline failed at task: {}", taskCompletion.task.getName() );
+                bScheduleFailed = true;
             }
         }
     }
@@ -137,6 +149,7 @@ RootPipelineLogicalThread::PipelineRun( const mega::pipeline::Configuration& con
         VERIFY_RTE( activeTasks.erase( taskCompletion.task ) == 1U );
         if( taskCompletion.bSuccess )
         {
+            runDurations.record( taskCompletion.task, taskCompletion.duration );
             schedule.complete( taskCompletion.task );
         }
         else
@@ -159,20 +172,39 @@ RootPipelineLogicalThread::PipelineRun( const mega::pipeline::Configuration& con
         }
     }
 
+    // achieved critical path from this run's measured durations to compare against the wall clock
+    const auto criticalPath = std::chrono::duration_cast< network::LogTime >(
+        mega::pipeline::CriticalPath( schedule.getDependencies(), runDurations ).getLength() );
+    const auto wallClock = std::chrono::duration_cast< network::LogTime >( sw.elapsed() );
+    SPDLOG_INFO( "Pipeline {} critical path: {} wall clock: {} with {} jobs", configuration.getPipelineID(),
+                 criticalPath, wallClock, m_jobs.size() );
+
+    {
+        for( const mega::pipeline::TaskDescriptor& task : schedule.getDependencies().getTasks() )
+        {
+            if( auto durationOpt = runDurations.get( task ); durationOpt.has_value() )
+            {
+                m_root.m_taskDurations.record( task, durationOpt.value() );
+            }
+        }
+        m_root.saveTaskDurations();
+    }
+
     {
         std::ostringstream os;
         if( bScheduleFailed )
         {
-            SPDLOG_WARN( "FAILURE: Pipeline {} failed: {}", configuration.getPipelineID(),
-                         std::chrono::duration_cast< network::LogTime >( sw.elapsed() ) );
+            SPDLOG_WARN( "FAILURE: Pipeline {} failed: {}", configuration.getPipelineID(), wallClock );
             os << "Pipeline: " << configuration.getPipelineID() << " failed";
             return pipeline::PipelineResult( false, os.str(), m_root.m_buildHashCodes.get() );
         }
         else
         {
-            SPDLOG_INFO( "SUCCESS: Pipeline {} succeeded: {}", configuration.getPipelineID(),
-                         std::chrono::duration_cast< network::LogTime >( sw.elapsed() ) );
-            os << "Pipeline: " << configuration.getPipelineID() << " succeeded";
+            SPDLOG_INFO( "SUCCESS: Pipeline {} succeeded: {}", configuration.getPipelineID(), wallClock );
+            os << "Pipeline: " << configuration.getPipelineID() << " succeeded critical path: "
+               << std::chrono::duration_cast< std::chrono::milliseconds >( criticalPath ).count()
+               << "ms wall clock: " << std::chrono::duration_cast< std::chrono::milliseconds >( wallClock ).count()
+               << "ms";
             return pipeline::PipelineResult( true, os.str(), m_root.m_buildHashCodes.get() );
         }
     }
@@ -24,6 +24,8 @@
 
 #include "log/log.hpp"
 
+#include "pipeline/critical_path.hpp"
+
 #include "service/protocol/model/pipeline.hxx"
 
 namespace mega::service
@@ -43,9 +45,10 @@ class RootPipelineLogicalThread : public RootRequestLogicalThread,
 
     struct TaskCompletion
     {
-        network::LogicalThreadID       jobID;
-        mega::pipeline::TaskDescriptor task;
-        bool                           bSuccess;
+        network::LogicalThreadID          jobID;
+        mega::pipeline::TaskDescriptor    task;
+        bool                              bSuccess;
+        pipeline::TaskDurations::Duration duration;
     };
     using TaskCompletionChannel
         = boost::asio::experimental::concurrent_channel< void( boost::system::error_code, TaskCompletion ) >;
@@ -95,9 +98,10 @@ public:
     }
 
     void completeTask( const mega::pipeline::TaskDescriptor& task, bool bSuccess,
-                       boost::asio::yield_context& yield_ctx )
+                       pipeline::TaskDurations::Duration duration, boost::asio::yield_context& yield_ctx )
     {
-        m_taskComplete.async_send( boost::system::error_code(), TaskCompletion{ getID(), task, bSuccess }, yield_ctx );
+        m_taskComplete.async_send(
+            boost::system::error_code(), TaskCompletion{ getID(), task, bSuccess, duration }, yield_ctx );
     }
 };
 } // namespace mega::service
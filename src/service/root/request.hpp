@@ -119,6 +119,10 @@ public:
 
     // network::enrole::Impl
     virtual runtime::MachineID EnroleDaemon( boost::asio::yield_context& yield_ctx ) override;
+    virtual void               EnroleDaemonListen( const mega::U64&          daemonPort,
+                                                   boost::asio::yield_context& yield_ctx ) override;
+    virtual std::string        EnroleDaemonEndPoint( const runtime::MachineID&   daemonMachineID,
+                                                     boost::asio::yield_context& yield_ctx ) override;
     virtual runtime::MP EnroleLeafWithRoot( const std::string& startupUUID, const runtime::MachineID& daemonMachineID,
                                             boost::asio::yield_context& yield_ctx ) override;
     virtual void        EnroleLeafDisconnect( const runtime::MP& mp, boost::asio::yield_context& yield_ctx ) override;
@@ -183,6 +187,14 @@ public:
                                                const runtime::MPO&         targetMPO,
                                                const network::Transaction& transaction,
                                                boost::asio::yield_context& yield_ctx ) override;
+    virtual void SimLockReleaseBatch( const runtime::MPO&                        requestingMPO,
+                                      const std::vector< runtime::MPO >&         targetMPOs,
+                                      const std::vector< network::Transaction >& transactions,
+                                      const bool&                                bAcknowledge,
+                                      boost::asio::yield_context&                yield_ctx ) override;
+    virtual void SimLeaseInvalidate( const runtime::MPO&                ownerMPO,
+                                     const std::vector< runtime::MPO >& leaseHolders,
+                                     boost::asio::yield_context&        yield_ctx ) override;
 
 protected:
     Root& m_root;
@@ -129,6 +129,19 @@ void Root::loadConfig()
             }
         }
     }
+
+    {
+        const boost::filesystem::path durationsFile = boost::filesystem::current_path() / "task_durations.xml";
+        if( boost::filesystem::exists( durationsFile ) )
+        {
+            std::unique_ptr< boost::filesystem::ifstream > pFileStream
+                = boost::filesystem::createBinaryInputFileStream( durationsFile );
+            {
+                boost::archive::xml_iarchive xml( *pFileStream );
+                xml&                         boost::serialization::make_nvp( "durations", m_taskDurations );
+            }
+        }
+    }
 }
 
 void Root::saveConfig()
@@ -155,6 +168,18 @@ void Root::saveConfig()
     }
 }
 
+void Root::saveTaskDurations()
+{
+    const boost::filesystem::path durationsFile = boost::filesystem::current_path() / "task_durations.xml";
+
+    std::unique_ptr< boost::filesystem::ofstream > pFileStream
+        = boost::filesystem::createBinaryOutputFileStream( durationsFile );
+    {
+        boost::archive::xml_oarchive xml( *pFileStream );
+        xml&                         boost::serialization::make_nvp( "durations", m_taskDurations );
+    }
+}
+
 void Root::setStartupUUIDMP( const std::string& strUUID, runtime::MP mp )
 {
     m_startupUUIDs[ strUUID ] = mp;
@@ -178,6 +203,7 @@ void Root::onDaemonDisconnect( runtime::MachineID machineID )
 {
     SPDLOG_TRACE( "Root::onDaemonDisconnect {}", machineID );
     m_server.unLabelConnection( machineID );
+    m_daemonEndPoints.erase( machineID );
     // onDisconnect();
     m_mpoManager.daemonDisconnect( machineID );
 }
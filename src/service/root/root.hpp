@@ -31,6 +31,8 @@
 #include "mega/values/compilation/megastructure_installation.hpp"
 #include "mega/values/service/root_config.hpp"
 
+#include "pipeline/critical_path.hpp"
+
 #include "common/stash.hpp"
 
 #include <boost/asio/io_context.hpp>
@@ -44,7 +46,8 @@ class Root : public network::LogicalThreadManager
     friend class RootRequestLogicalThread;
     friend class RootSimulation;
 
-    using StartupUUIDMap = std::map< std::string, runtime::MP >;
+    using StartupUUIDMap     = std::map< std::string, runtime::MP >;
+    using DaemonEndPointMap  = std::map< runtime::MachineID, std::string >;
 
 public:
     Root( boost::asio::io_context& ioContext, network::Log log, const boost::filesystem::path& stashFolder,
@@ -66,6 +69,7 @@ public:
 private:
     void loadConfig();
     void saveConfig();
+    void saveTaskDurations();
 
     void onDaemonDisconnect( runtime::MachineID machineID );
 
@@ -75,11 +79,13 @@ private:
     network::Server                            m_server;
     task::BuildHashCodes                       m_buildHashCodes;
     task::Stash                                m_stash;
+    pipeline::TaskDurations                    m_taskDurations;
     mega::SymbolTable                          m_symbolTable;
     mega::service::RootConfig                  m_config;
     std::optional< MegastructureInstallation > m_megastructureInstallationOpt;
     MPOManager                                 m_mpoManager;
     StartupUUIDMap                             m_startupUUIDs;
+    DaemonEndPointMap                          m_daemonEndPoints;
 };
 
 } // namespace mega::service
@@ -41,24 +41,22 @@ network::Message RootRequestLogicalThread::dispatchInBoundRequest( const network
                                                                    boost::asio::yield_context& yield_ctx )
 {
     SPDLOG_TRACE( "RootRequestLogicalThread::dispatchInBoundRequest {}", msg );
-    network::Message result;
-    if( result = network::daemon_root::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::mpo::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::project::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::enrole::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::status::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::report::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::stash::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::job::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::sim::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
+    // clang-format off
+    static constexpr auto table = network::DispatchTable< RootRequestLogicalThread >::make
+    <
+        network::daemon_root::Impl,
+        network::mpo::Impl,
+        network::project::Impl,
+        network::enrole::Impl,
+        network::status::Impl,
+        network::report::Impl,
+        network::stash::Impl,
+        network::job::Impl,
+        network::sim::Impl
+    >();
+    // clang-format on
+
+    if( network::Message result = table.dispatch( *this, msg, yield_ctx ); result )
         return result;
     THROW_RTE( "RootRequestLogicalThread::dispatchInBoundRequest failed: " << msg );
     UNREACHABLE;
@@ -259,4 +257,42 @@ void RootRequestLogicalThread::SimLockRelease( const runtime::MPO&         reque
     UNREACHABLE;
 }
 
+void RootRequestLogicalThread::SimLockReleaseBatch( const runtime::MPO&                        requestingMPO,
+                                                    const std::vector< runtime::MPO >&         targetMPOs,
+                                                    const std::vector< network::Transaction >& transactions,
+                                                    const bool&                                bAcknowledge,
+                                                    boost::asio::yield_context&                yield_ctx )
+{
+    // daemons only ever send a batch for a single machine
+    VERIFY_RTE_MSG( !targetMPOs.empty(), "Empty lock release batch from: " << requestingMPO );
+    const runtime::MachineID machineID = targetMPOs.front().getMachineID();
+    if( network::Server::Connection::Ptr pConnection = m_root.m_server.findConnection( machineID ) )
+    {
+        network::sim::Request_Sender sender( *this, pConnection->getSender(), yield_ctx );
+        sender.SimLockReleaseBatch( requestingMPO, targetMPOs, transactions, bAcknowledge );
+    }
+    else
+    {
+        THROW_RTE( "Failed to route lock release batch to machine: " << machineID );
+    }
+}
+
+void RootRequestLogicalThread::SimLeaseInvalidate( const runtime::MPO&                ownerMPO,
+                                                   const std::vector< runtime::MPO >& leaseHolders,
+                                                   boost::asio::yield_context&        yield_ctx )
+{
+    // daemons only ever send lease holders for a single machine
+    VERIFY_RTE_MSG( !leaseHolders.empty(), "Empty lease invalidation from: " << ownerMPO );
+    const runtime::MachineID machineID = leaseHolders.front().getMachineID();
+    if( network::Server::Connection::Ptr pConnection = m_root.m_server.findConnection( machineID ) )
+    {
+        network::sim::Request_Sender sender( *this, pConnection->getSender(), yield_ctx );
+        sender.SimLeaseInvalidate( ownerMPO, leaseHolders );
+    }
+    else
+    {
+        THROW_RTE( "Failed to route lease invalidation to machine: " << machineID );
+    }
+}
+
 } // namespace mega::service
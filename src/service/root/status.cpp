@@ -46,7 +46,7 @@ network::Status RootRequestLogicalThread::GetStatus( const std::vector< network:
     {
         std::vector< network::LogicalThreadID > logicalthreads;
         {
-            for( const auto& [ id, pCon ] : m_root.m_logicalthreads )
+            for( const auto& id : m_root.reportLogicalThreads() )
             {
                 if( id != getID() )
                 {
@@ -57,6 +57,7 @@ network::Status RootRequestLogicalThread::GetStatus( const std::vector< network:
         status.setLogicalThreadID( logicalthreads );
         status.setDescription( m_root.m_strProcessName );
         status.setLogFile( m_root.getLog().logFile.string() );
+        status.setDispatch( network::getDispatchStatus() );
     }
 
     return status;
@@ -38,14 +38,17 @@ TerminalRequestLogicalThread::~TerminalRequestLogicalThread()
 network::Message TerminalRequestLogicalThread::dispatchInBoundRequest( const network::Message&     msg,
                                                                 boost::asio::yield_context& yield_ctx )
 {
-    network::Message result;
-    if( result = network::leaf_term::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::status::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::report::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::project::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
+    // clang-format off
+    static constexpr auto table = network::DispatchTable< TerminalRequestLogicalThread >::make
+    <
+        network::leaf_term::Impl,
+        network::status::Impl,
+        network::report::Impl,
+        network::project::Impl
+    >();
+    // clang-format on
+
+    if( network::Message result = table.dispatch( *this, msg, yield_ctx ); result )
         return result;
     THROW_RTE( "TerminalRequestLogicalThread::dispatchInBoundRequest failed" );
 }
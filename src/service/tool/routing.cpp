@@ -38,16 +38,19 @@ ToolRequestLogicalThread::~ToolRequestLogicalThread()
 network::Message ToolRequestLogicalThread::dispatchInBoundRequest( const network::Message&     msg,
                                                                    boost::asio::yield_context& yield_ctx )
 {
-    network::Message result;
-    if( result = network::leaf_tool::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::mpo::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::status::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::report::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
-        return result;
-    if( result = network::project::Impl::dispatchInBoundRequest( msg, yield_ctx ); result )
+    // clang-format off
+    static constexpr auto table = network::DispatchTable< ToolRequestLogicalThread >::make
+    <
+        network::leaf_tool::Impl,
+        network::mpo::Impl,
+        network::status::Impl,
+        network::report::Impl,
+        network::project::Impl,
+        network::sim::Impl
+    >();
+    // clang-format on
+
+    if( network::Message result = table.dispatch( *this, msg, yield_ctx ); result )
         return result;
     THROW_RTE( "ToolRequestLogicalThread::dispatchInBoundRequest failed: " << msg );
 }
@@ -127,4 +130,17 @@ network::Message ToolRequestLogicalThread::MPODown( const network::Message& requ
     return dispatchInBoundRequest( request, yield_ctx );
 }
 
+void ToolRequestLogicalThread::SimLeaseInvalidate( const mega::runtime::MPO& ownerMPO,
+                                                   const std::vector< mega::runtime::MPO >&,
+                                                   boost::asio::yield_context& )
+{
+    for( auto pThread : m_tool.getLogicalThreads() )
+    {
+        if( auto pMPOThread = std::dynamic_pointer_cast< ToolMPOLogicalThread >( pThread ) )
+        {
+            pMPOThread->leaseInvalidated( ownerMPO );
+        }
+    }
+}
+
 } // namespace mega::service
@@ -69,6 +69,13 @@ network::memory::Request_Encoder ToolMPOLogicalThread::getDaemonMemoryRequest()
              { return leafRequest.ToolDaemon( msg ); },
              getID() };
 }
+network::sim::Request_Encoder ToolMPOLogicalThread::getDaemonSimRequest()
+{
+    VERIFY_RTE( m_pYieldContext );
+    return { [ leafRequest = getToolRequest( *m_pYieldContext ) ]( const network::Message& msg ) mutable
+             { return leafRequest.ToolDaemon( msg ); },
+             getID() };
+}
 network::sim::Request_Encoder ToolMPOLogicalThread::getMPOSimRequest( runtime::MPO mpo )
 {
     VERIFY_RTE( m_pYieldContext );
@@ -0,0 +1,431 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "mega/arena_archive.hpp"
+#include "mega/boost_serialization_workaround.hpp"
+
+#include <boost/serialization/array.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/interprocess/streams/vectorstream.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+// boost binary archive translating Pointers through an unordered_map in the
+// same way as SnapshotOArchive and AddressTable
+class BaselineOArchive : public boost::archive::binary_oarchive_impl< BaselineOArchive, std::ostream::char_type,
+                                                                       std::ostream::traits_type >
+{
+    using base = boost::archive::binary_oarchive_impl< BaselineOArchive, std::ostream::char_type,
+                                                       std::ostream::traits_type >;
+
+    friend class boost::archive::detail::common_oarchive< BaselineOArchive >;
+    friend class boost::archive::basic_binary_oarchive< BaselineOArchive >;
+    friend class boost::archive::save_access;
+
+public:
+    BaselineOArchive( std::streambuf& bsb )
+        : base( bsb, boost::archive::no_header | boost::archive::no_codecvt | boost::archive::no_tracking )
+    {
+    }
+
+    template < typename T >
+    inline void save( const T& value )
+    {
+        base::save( value );
+    }
+
+    inline void save( const mega::runtime::Pointer& ref )
+    {
+        auto iFind = m_table.find( ref );
+        if( iFind == m_table.end() )
+        {
+            iFind = m_table.insert( { ref, m_references.size() } ).first;
+            m_references.push_back( ref );
+        }
+        base::save( iFind->second );
+    }
+
+    const std::vector< mega::runtime::Pointer >& getReferences() const { return m_references; }
+
+private:
+    std::unordered_map< mega::runtime::Pointer, mega::U64, mega::PointerRaw::Hash, mega::PointerRaw::Equal > m_table;
+    std::vector< mega::runtime::Pointer > m_references;
+};
+
+class BaselineIArchive : public boost::archive::binary_iarchive_impl< BaselineIArchive, std::istream::char_type,
+                                                                       std::istream::traits_type >
+{
+    using base = boost::archive::binary_iarchive_impl< BaselineIArchive, std::istream::char_type,
+                                                       std::istream::traits_type >;
+
+    friend class boost::archive::detail::common_iarchive< BaselineIArchive >;
+    friend class boost::archive::basic_binary_iarchive< BaselineIArchive >;
+    friend class boost::archive::load_access;
+
+public:
+    BaselineIArchive( std::streambuf& bsb, const std::vector< mega::runtime::Pointer >& references )
+        : base( bsb, boost::archive::no_header | boost::archive::no_codecvt | boost::archive::no_tracking )
+        , m_references( references )
+    {
+    }
+
+    template < typename T >
+    inline void load( T& value )
+    {
+        base::load( value );
+    }
+
+    inline void load( mega::runtime::Pointer& ref )
+    {
+        mega::U64 index;
+        base::load( index );
+        ref = m_references[ index ];
+    }
+
+private:
+    const std::vector< mega::runtime::Pointer >& m_references;
+};
+} // namespace
+
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION( BaselineOArchive )
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION( BaselineIArchive )
+
+namespace boost::serialization
+{
+inline void serialize( BaselineOArchive& ar, ::mega::runtime::Pointer& value, const unsigned int )
+{
+    ar.save( value );
+}
+inline void serialize( BaselineIArchive& ar, ::mega::runtime::Pointer& value, const unsigned int )
+{
+    ar.load( value );
+}
+} // namespace boost::serialization
+
+namespace
+{
+struct BenchmarkObject
+{
+    mega::U64                   m_id;
+    std::array< double, 4 >     m_values;
+    mega::U32                   m_flags;
+    mega::runtime::Pointer      m_parent;
+    std::vector< mega::U32 >    m_children;
+    std::string                 m_name;
+
+    template < typename Archive >
+    inline void serialize( Archive& ar, const unsigned int )
+    {
+        ar& m_id;
+        ar& m_values;
+        ar& m_flags;
+        ar& m_parent;
+        ar& m_children;
+        ar& m_name;
+    }
+
+    inline bool operator==( const BenchmarkObject& cmp ) const
+    {
+        return ( m_id == cmp.m_id ) && ( m_values == cmp.m_values ) && ( m_flags == cmp.m_flags )
+               && mega::PointerRaw::Equal()( m_parent, cmp.m_parent ) && ( m_children == cmp.m_children )
+               && ( m_name == cmp.m_name );
+    }
+};
+
+// trivially copyable with a Pointer so must never be copied bitwise
+struct PointerPair
+{
+    mega::runtime::Pointer m_first, m_second;
+
+    template < typename Archive >
+    inline void serialize( Archive& ar, const unsigned int )
+    {
+        ar& m_first;
+        ar& m_second;
+    }
+};
+static_assert( std::is_trivially_copyable_v< PointerPair > );
+static_assert( !mega::arena_archive::IsBitwise< PointerPair > );
+static_assert( !mega::arena_archive::IsBitwiseArray< std::array< mega::runtime::Pointer, 2 > > );
+
+struct Extent
+{
+    mega::U32 m_begin, m_end;
+};
+} // namespace
+
+template <>
+struct mega::arena_archive::Bitwise< Extent > : std::true_type
+{
+};
+
+namespace
+{
+struct ArenaArchiveBenchmark
+{
+    std::vector< c_object_header >        headers;
+    std::vector< mega::runtime::Pointer > refs;
+    std::vector< BenchmarkObject >        objects;
+
+    ArenaArchiveBenchmark( mega::U64 size )
+        : headers( size )
+        , refs( size )
+        , objects( size )
+    {
+        for( mega::U64 i = 0U; i != size; ++i )
+        {
+            refs[ i ].value.heap.m_header = &headers[ i ];
+        }
+        for( mega::U64 i = 0U; i != size; ++i )
+        {
+            BenchmarkObject& object = objects[ i ];
+            object.m_id             = i;
+            object.m_values         = { 1.0 * i, 2.0 * i, 3.0 * i, 4.0 * i };
+            object.m_flags          = static_cast< mega::U32 >( i * 7U );
+            object.m_parent         = refs[ i / 4U ];
+            object.m_children       = { static_cast< mega::U32 >( i ), static_cast< mega::U32 >( i + 1U ) };
+            object.m_name           = "object";
+        }
+    }
+};
+
+using Clock = std::chrono::steady_clock;
+
+inline double toMilliseconds( Clock::duration duration )
+{
+    return std::chrono::duration< double, std::milli >( duration ).count();
+}
+
+class ArenaArchiveBenchmarkTest : public ::testing::TestWithParam< mega::U64 >
+{
+};
+} // namespace
+
+TEST( ArenaArchive, LoadFromMappedFile )
+{
+    ArenaArchiveBenchmark bench( 1000U );
+
+    mega::ArenaSaveArchive saveArchive;
+    for( mega::U64 i = 0U; i != bench.objects.size(); ++i )
+    {
+        saveArchive.beginObject( bench.refs[ i ] );
+        saveArchive& bench.objects[ i ];
+    }
+    const std::span< const char > arena = saveArchive.makeArena( mega::runtime::TimeStamp{ 123U } );
+
+    const boost::filesystem::path filePath = boost::filesystem::temp_directory_path() / "arena_archive_test.bin";
+    {
+        std::ofstream os( filePath.string(), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary );
+        os.write( arena.data(), arena.size() );
+    }
+    {
+        boost::interprocess::file_mapping  fileMapping( filePath.string().c_str(), boost::interprocess::read_only );
+        boost::interprocess::mapped_region region( fileMapping, boost::interprocess::read_only );
+
+        mega::ArenaLoadArchive loadArchive( region.get_address(), region.get_size() );
+        ASSERT_EQ( loadArchive.getTimeStamp(), 123U );
+        ASSERT_EQ( loadArchive.getObjects().size(), bench.objects.size() );
+        for( mega::U64 i = 0U; i != bench.objects.size(); ++i )
+        {
+            ASSERT_TRUE( mega::PointerRaw::Equal()(
+                loadArchive.indexToRef( loadArchive.getObjects()[ i ] ), bench.refs[ i ] ) );
+            BenchmarkObject object;
+            loadArchive& object;
+            ASSERT_TRUE( object == bench.objects[ i ] );
+        }
+    }
+    boost::filesystem::remove( filePath );
+}
+
+TEST( ArenaArchive, RemapsNestedPointers )
+{
+    ArenaArchiveBenchmark bench( 8U );
+
+    const std::array< mega::runtime::Pointer, 3 > array{ bench.refs[ 1 ], bench.refs[ 2 ], bench.refs[ 1 ] };
+    const PointerPair                             pair{ bench.refs[ 3 ], bench.refs[ 2 ] };
+    const std::vector< PointerPair >              pairs{ pair, pair };
+    const Extent                                  extent{ 3U, 7U };
+
+    mega::ArenaSaveArchive saveArchive;
+    saveArchive& array;
+    saveArchive& pair;
+    saveArchive& pairs;
+    saveArchive& extent;
+    const std::span< const char > arena = saveArchive.makeArena( mega::runtime::TimeStamp{} );
+
+    // every Pointer went through the table so relocating the table relocates them all
+    mega::ArenaLoadArchive loadArchive( arena );
+    ASSERT_EQ( loadArchive.getTable().size(), 3U );
+    std::vector< mega::runtime::Pointer > relocated;
+    for( const mega::runtime::Pointer& ref : loadArchive.getTable() )
+    {
+        const auto index = static_cast< mega::U64 >( ref.value.heap.m_header - bench.headers.data() );
+        relocated.push_back( bench.refs[ index + 4U ] );
+    }
+    loadArchive.remap( relocated );
+
+    std::array< mega::runtime::Pointer, 3 > loadedArray;
+    PointerPair                             loadedPair;
+    std::vector< PointerPair >              loadedPairs;
+    Extent                                  loadedExtent;
+    loadArchive& loadedArray;
+    loadArchive& loadedPair;
+    loadArchive& loadedPairs;
+    loadArchive& loadedExtent;
+
+    const mega::PointerRaw::Equal equal;
+    ASSERT_TRUE( equal( loadedArray[ 0 ], bench.refs[ 5 ] ) );
+    ASSERT_TRUE( equal( loadedArray[ 1 ], bench.refs[ 6 ] ) );
+    ASSERT_TRUE( equal( loadedArray[ 2 ], bench.refs[ 5 ] ) );
+    ASSERT_TRUE( equal( loadedPair.m_first, bench.refs[ 7 ] ) );
+    ASSERT_TRUE( equal( loadedPair.m_second, bench.refs[ 6 ] ) );
+    ASSERT_EQ( loadedPairs.size(), 2U );
+    ASSERT_TRUE( equal( loadedPairs[ 1 ].m_first, bench.refs[ 7 ] ) );
+    ASSERT_EQ( loadedExtent.m_begin, 3U );
+    ASSERT_EQ( loadedExtent.m_end, 7U );
+}
+
+TEST( ArenaArchive, RejectsOutOfRangePointerIndex )
+{
+    ArenaArchiveBenchmark bench( 2U );
+
+    mega::ArenaSaveArchive saveArchive;
+    saveArchive& bench.refs[ 0 ];
+    const std::span< const char > arena = saveArchive.makeArena( mega::runtime::TimeStamp{} );
+
+    // corrupt the single pointer index in the data section
+    std::vector< char > corrupt( arena.begin(), arena.end() );
+    const mega::U64     badIndex = 99U;
+    std::memcpy( corrupt.data() + sizeof( mega::ArenaArchiveHeader ), &badIndex, sizeof( mega::U64 ) );
+
+    mega::ArenaLoadArchive loadArchive( corrupt.data(), corrupt.size() );
+    mega::runtime::Pointer ref;
+    ASSERT_THROW( loadArchive& ref, std::runtime_error );
+}
+
+TEST( ArenaArchive, RejectsCorruptHeaderSizes )
+{
+    ArenaArchiveBenchmark bench( 2U );
+
+    mega::ArenaSaveArchive saveArchive;
+    saveArchive& bench.refs[ 0 ];
+    const std::span< const char > arena = saveArchive.makeArena( mega::runtime::TimeStamp{} );
+
+    auto corruptHeader = [ & ]( auto&& corrupt )
+    {
+        std::vector< char >      data( arena.begin(), arena.end() );
+        mega::ArenaArchiveHeader header;
+        std::memcpy( &header, data.data(), sizeof( header ) );
+        corrupt( header );
+        std::memcpy( data.data(), &header, sizeof( header ) );
+        return data;
+    };
+
+    // data section running past the end of a truncated file
+    const auto truncated = corruptHeader( []( mega::ArenaArchiveHeader& header ) { header.szDataSize += 1024U; } );
+    ASSERT_THROW( mega::ArenaLoadArchive( truncated.data(), truncated.size() ), std::runtime_error );
+
+    // object count that overflows when multiplied by the index size
+    const auto overflow = corruptHeader( []( mega::ArenaArchiveHeader& header )
+                                         { header.szObjectCount = ~mega::U64{ 0U } / 4U + 1U; } );
+    ASSERT_THROW( mega::ArenaLoadArchive( overflow.data(), overflow.size() ), std::runtime_error );
+
+    const auto offset
+        = corruptHeader( []( mega::ArenaArchiveHeader& header ) { header.szTableOffset = ~mega::U64{ 0U }; } );
+    ASSERT_THROW( mega::ArenaLoadArchive( offset.data(), offset.size() ), std::runtime_error );
+}
+
+TEST_P( ArenaArchiveBenchmarkTest, SaveLoad )
+{
+    const mega::U64       size = GetParam();
+    ArenaArchiveBenchmark bench( size );
+
+    // boost archive baseline
+    double boostSave = 0.0, boostLoad = 0.0;
+    {
+        boost::interprocess::basic_vectorbuf< std::vector< char > > oVecStream;
+        std::vector< mega::runtime::Pointer >                       references;
+        {
+            const auto       start = Clock::now();
+            BaselineOArchive saveArchive( oVecStream );
+            for( const BenchmarkObject& object : bench.objects )
+            {
+                saveArchive& object;
+            }
+            boostSave  = toMilliseconds( Clock::now() - start );
+            references = saveArchive.getReferences();
+        }
+        {
+            boost::interprocess::basic_vectorbuf< std::vector< char > > iVecStream( oVecStream.vector() );
+            std::vector< BenchmarkObject >                              loaded( size );
+
+            const auto       start = Clock::now();
+            BaselineIArchive loadArchive( iVecStream, references );
+            for( BenchmarkObject& object : loaded )
+            {
+                loadArchive& object;
+            }
+            boostLoad = toMilliseconds( Clock::now() - start );
+            ASSERT_TRUE( loaded.back() == bench.objects.back() );
+        }
+    }
+
+    // arena archive
+    double arenaSave = 0.0, arenaLoad = 0.0;
+    {
+        const auto             start = Clock::now();
+        mega::ArenaSaveArchive saveArchive( size * 128U );
+        for( const BenchmarkObject& object : bench.objects )
+        {
+            saveArchive& object;
+        }
+        const std::span< const char > arena = saveArchive.makeArena( mega::runtime::TimeStamp{} );
+        arenaSave                           = toMilliseconds( Clock::now() - start );
+
+        std::vector< BenchmarkObject > loaded( size );
+        {
+            const auto             loadStart = Clock::now();
+            mega::ArenaLoadArchive loadArchive( arena );
+            for( BenchmarkObject& object : loaded )
+            {
+                loadArchive& object;
+            }
+            arenaLoad = toMilliseconds( Clock::now() - loadStart );
+        }
+        ASSERT_TRUE( loaded == bench.objects );
+    }
+
+    std::cout << "Snapshot archive: " << size << " objects boost save: " << boostSave << " ms load: " << boostLoad
+              << " ms arena save: " << arenaSave << " ms load: " << arenaLoad << " ms" << std::endl;
+}
+
+INSTANTIATE_TEST_SUITE_P( ArenaArchive, ArenaArchiveBenchmarkTest, ::testing::Values( 1000U, 100000U ) );
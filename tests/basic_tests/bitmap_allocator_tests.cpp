@@ -0,0 +1,112 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include <gtest/gtest.h>
+
+#include "mega/bitmap_allocator.hpp"
+#include "mega/values/runtime/process_id.hpp"
+#include "mega/values/runtime/owner_id.hpp"
+
+#include <set>
+#include <algorithm>
+#include <random>
+#include <limits>
+
+namespace
+{
+static constexpr auto MAX_PROCESS_PER_MACHINE = std::numeric_limits< mega::runtime::ProcessID::ValueType >::max();
+static constexpr auto MAX_OWNER_PER_PROCESS   = std::numeric_limits< mega::runtime::OwnerID::ValueType >::max();
+
+using ProcessAllocator = mega::BitmapAllocator< mega::runtime::ProcessID, MAX_PROCESS_PER_MACHINE >;
+using OwnerAllocator   = mega::BitmapAllocator< mega::runtime::OwnerID, MAX_OWNER_PER_PROCESS >;
+} // namespace
+
+TEST( Allocator, BitmapReturnsLowestFree )
+{
+    OwnerAllocator alloc;
+    ASSERT_TRUE( alloc.empty() );
+    ASSERT_EQ( alloc.allocate(), mega::runtime::OwnerID{} );
+    ASSERT_EQ( alloc.allocate(), mega::runtime::OwnerID{ 1 } );
+    ASSERT_EQ( alloc.allocate(), mega::runtime::OwnerID{ 2 } );
+    alloc.free( mega::runtime::OwnerID{ 1 } );
+    ASSERT_EQ( alloc.allocate(), mega::runtime::OwnerID{ 1 } );
+    ASSERT_TRUE( !alloc.full() );
+}
+
+TEST( Allocator, BitmapFillAndDrain )
+{
+    ProcessAllocator alloc;
+    ASSERT_TRUE( alloc.empty() );
+
+    std::random_device randomDevice;
+    std::mt19937       randNumGen( randomDevice() );
+
+    std::vector< mega::runtime::ProcessID > allocated;
+    for( mega::U64 i = 0; i != MAX_PROCESS_PER_MACHINE; ++i )
+    {
+        ASSERT_TRUE( !alloc.full() );
+        allocated.push_back( alloc.allocate() );
+        ASSERT_EQ( allocated.back().getValue(), i );
+    }
+    ASSERT_TRUE( alloc.full() );
+    ASSERT_EQ( alloc.getAllocated(), allocated );
+
+    std::shuffle( allocated.begin(), allocated.end(), randNumGen );
+    for( auto i : allocated )
+    {
+        ASSERT_TRUE( !alloc.empty() );
+        ASSERT_TRUE( alloc.isAllocated( i ) );
+        alloc.free( i );
+        ASSERT_TRUE( !alloc.full() );
+    }
+    ASSERT_TRUE( alloc.empty() );
+    ASSERT_TRUE( alloc.getAllocated().empty() );
+}
+
+TEST( Allocator, BitmapMatchesSet )
+{
+    OwnerAllocator alloc;
+
+    std::random_device randomDevice;
+    std::mt19937       randNumGen( randomDevice() );
+
+    std::set< mega::runtime::OwnerID > allocated;
+    for( int j = 0; j < 5; ++j )
+    {
+        // allocate half
+        for( int i = 0; ( i < MAX_OWNER_PER_PROCESS / 2 ) && !alloc.full(); ++i )
+        {
+            ASSERT_TRUE( allocated.insert( alloc.allocate() ).second );
+        }
+
+        // remove half
+        std::vector< mega::runtime::OwnerID > shuffled( allocated.begin(), allocated.end() );
+        std::shuffle( shuffled.begin(), shuffled.end(), randNumGen );
+        for( int i = 0; i < MAX_OWNER_PER_PROCESS / 2; ++i )
+        {
+            alloc.free( shuffled[ i ] );
+            allocated.erase( shuffled[ i ] );
+        }
+
+        ASSERT_EQ( alloc.size(), allocated.size() );
+        ASSERT_EQ( alloc.getAllocated(),
+                   std::vector< mega::runtime::OwnerID >( allocated.begin(), allocated.end() ) );
+    }
+}
@@ -0,0 +1,126 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "mega/intrusive_list.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace
+{
+struct ActiveTag;
+struct PausedTag;
+
+struct Node : mega::IntrusiveList< Node, ActiveTag >::Hook, mega::IntrusiveList< Node, PausedTag >::Hook
+{
+    int id = 0;
+};
+
+using ActiveList = mega::IntrusiveList< Node, ActiveTag >;
+using PausedList = mega::IntrusiveList< Node, PausedTag >;
+
+std::vector< int > ids( const ActiveList& list )
+{
+    std::vector< int > result;
+    list.for_each( [ &result ]( Node* pNode ) { result.push_back( pNode->id ); } );
+    return result;
+}
+} // namespace
+
+TEST( IntrusiveList, PushAndEraseKeepOrder )
+{
+    std::vector< Node > nodes( 4 );
+    ActiveList          list;
+    for( int i = 0; i != 4; ++i )
+    {
+        nodes[ i ].id = i;
+        list.push_back( &nodes[ i ] );
+    }
+    ASSERT_EQ( list.size(), 4U );
+    ASSERT_EQ( list.front()->id, 0 );
+
+    list.erase( &nodes[ 1 ] );
+    list.erase( &nodes[ 3 ] );
+    ASSERT_EQ( ids( list ), ( std::vector< int >{ 0, 2 } ) );
+    ASSERT_FALSE( list.owns( &nodes[ 1 ] ) );
+    ASSERT_TRUE( list.owns( &nodes[ 2 ] ) );
+
+    list.clear();
+    ASSERT_TRUE( list.empty() );
+    ASSERT_EQ( list.size(), 0U );
+}
+
+TEST( IntrusiveList, UnlinkFindsOwningList )
+{
+    std::vector< Node > nodes( 2 );
+    ActiveList          first, second;
+    first.push_back( &nodes[ 0 ] );
+    second.push_back( &nodes[ 1 ] );
+
+    ActiveList::unlink( &nodes[ 1 ] );
+    ASSERT_EQ( first.size(), 1U );
+    ASSERT_TRUE( second.empty() );
+
+    // unlinking a node that is not in any list is a no-op
+    ActiveList::unlink( &nodes[ 1 ] );
+    ASSERT_TRUE( second.empty() );
+
+    // the node can then move to another list
+    first.push_back( &nodes[ 1 ] );
+    ASSERT_EQ( first.size(), 2U );
+}
+
+TEST( IntrusiveList, ForEachAllowsUnlinkingCurrent )
+{
+    std::vector< Node > nodes( 6 );
+    ActiveList          list;
+    for( int i = 0; i != 6; ++i )
+    {
+        nodes[ i ].id = i;
+        list.push_back( &nodes[ i ] );
+    }
+    list.for_each(
+        [ &list ]( Node* pNode )
+        {
+            if( pNode->id % 2 == 0 )
+            {
+                list.erase( pNode );
+            }
+        } );
+    ASSERT_EQ( ids( list ), ( std::vector< int >{ 1, 3, 5 } ) );
+}
+
+TEST( IntrusiveList, DistinctTagsAreIndependent )
+{
+    Node       node;
+    ActiveList active;
+    PausedList paused;
+
+    active.push_back( &node );
+    paused.push_back( &node );
+    ASSERT_TRUE( active.owns( &node ) );
+    ASSERT_TRUE( paused.owns( &node ) );
+
+    active.erase( &node );
+    ASSERT_FALSE( active.owns( &node ) );
+    ASSERT_TRUE( paused.owns( &node ) );
+    ASSERT_EQ( paused.size(), 1U );
+}
@@ -0,0 +1,104 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "mega/object_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <vector>
+
+namespace
+{
+struct Counted
+{
+    static inline int iLive = 0;
+    int               value;
+
+    explicit Counted( int v )
+        : value( v )
+    {
+        ++iLive;
+    }
+    ~Counted() { --iLive; }
+};
+} // namespace
+
+TEST( ObjectPool, ConstructsAndDestroys )
+{
+    mega::ObjectPool< Counted, 4U > pool;
+
+    Counted* pFirst  = pool.allocate( 1 );
+    Counted* pSecond = pool.allocate( 2 );
+    ASSERT_EQ( pFirst->value, 1 );
+    ASSERT_EQ( pSecond->value, 2 );
+    ASSERT_EQ( Counted::iLive, 2 );
+    ASSERT_EQ( pool.size(), 2U );
+
+    pool.free( pFirst );
+    pool.free( pSecond );
+    ASSERT_EQ( Counted::iLive, 0 );
+    ASSERT_EQ( pool.size(), 0U );
+}
+
+TEST( ObjectPool, ReusesFreedSlots )
+{
+    mega::ObjectPool< Counted, 4U > pool;
+
+    Counted* pFirst = pool.allocate( 1 );
+    pool.free( pFirst );
+    Counted* pSecond = pool.allocate( 2 );
+    ASSERT_EQ( pFirst, pSecond );
+    ASSERT_EQ( pool.capacity(), 4U );
+    pool.free( pSecond );
+}
+
+TEST( ObjectPool, GrowsByBlocks )
+{
+    mega::ObjectPool< Counted, 4U > pool;
+
+    std::vector< Counted* > objects;
+    for( int i = 0; i != 10; ++i )
+    {
+        objects.push_back( pool.allocate( i ) );
+    }
+    ASSERT_EQ( pool.capacity(), 12U );
+    ASSERT_EQ( std::set< Counted* >( objects.begin(), objects.end() ).size(), objects.size() );
+    for( int i = 0; i != 10; ++i )
+    {
+        ASSERT_EQ( objects[ i ]->value, i );
+    }
+
+    // freeing everything and reallocating must not grow further
+    for( Counted* pObject : objects )
+    {
+        pool.free( pObject );
+    }
+    for( int i = 0; i != 10; ++i )
+    {
+        objects[ i ] = pool.allocate( i );
+    }
+    ASSERT_EQ( pool.capacity(), 12U );
+    for( Counted* pObject : objects )
+    {
+        pool.free( pObject );
+    }
+    ASSERT_EQ( Counted::iLive, 0 );
+}
@@ -0,0 +1,116 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "mega/pointer_index.hpp"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <vector>
+
+namespace
+{
+std::vector< c_object_header > g_headers( 4096 );
+
+mega::runtime::Pointer make_ref( mega::U64 index )
+{
+    mega::runtime::Pointer ref{};
+    ref.value.heap.m_header = &g_headers[ index ];
+    return ref;
+}
+} // namespace
+
+TEST( PointerIndex, InsertFindErase )
+{
+    mega::PointerIndex< int > index;
+    ASSERT_TRUE( index.empty() );
+
+    ASSERT_TRUE( index.insert( make_ref( 1 ), 10 ) );
+    ASSERT_TRUE( index.insert( make_ref( 2 ), 20 ) );
+    ASSERT_FALSE( index.insert( make_ref( 1 ), 30 ) );
+    ASSERT_EQ( index.size(), 2U );
+
+    ASSERT_NE( index.find( make_ref( 1 ) ), nullptr );
+    ASSERT_EQ( *index.find( make_ref( 1 ) ), 10 );
+    ASSERT_EQ( index.find( make_ref( 3 ) ), nullptr );
+
+    ASSERT_TRUE( index.erase( make_ref( 1 ) ) );
+    ASSERT_FALSE( index.erase( make_ref( 1 ) ) );
+    ASSERT_EQ( index.find( make_ref( 1 ) ), nullptr );
+    ASSERT_EQ( *index.find( make_ref( 2 ) ), 20 );
+    ASSERT_EQ( index.size(), 1U );
+}
+
+TEST( PointerIndex, MatchesMapUnderRandomOperations )
+{
+    // grows well past the minimum capacity and erases enough to exercise the backward shift
+    mega::PointerIndex< mega::U64 > index;
+    std::map< mega::U64, mega::U64 > expected;
+    std::mt19937_64                  randNumGen( 42U );
+
+    for( mega::U64 step = 0U; step != 100000U; ++step )
+    {
+        const mega::U64 key = randNumGen() % g_headers.size();
+        if( randNumGen() % 3U == 0U )
+        {
+            ASSERT_EQ( index.erase( make_ref( key ) ), expected.erase( key ) == 1U );
+        }
+        else
+        {
+            ASSERT_EQ( index.insert( make_ref( key ), step ), expected.insert( { key, step } ).second );
+        }
+        ASSERT_EQ( index.size(), expected.size() );
+    }
+
+    for( mega::U64 key = 0U; key != g_headers.size(); ++key )
+    {
+        auto iFind = expected.find( key );
+        if( iFind == expected.end() )
+        {
+            ASSERT_EQ( index.find( make_ref( key ) ), nullptr );
+        }
+        else
+        {
+            ASSERT_NE( index.find( make_ref( key ) ), nullptr );
+            ASSERT_EQ( *index.find( make_ref( key ) ), iFind->second );
+        }
+    }
+
+    mega::U64 szVisited = 0U;
+    index.for_each( [ &szVisited ]( const mega::runtime::Pointer&, mega::U64 ) { ++szVisited; } );
+    ASSERT_EQ( szVisited, expected.size() );
+
+    index.clear();
+    ASSERT_TRUE( index.empty() );
+    ASSERT_EQ( index.find( make_ref( expected.begin()->first ) ), nullptr );
+}
+
+TEST( PointerIndex, RawOrderingIsStrictWeak )
+{
+    mega::PointerRaw::Less  less;
+    mega::PointerRaw::Equal equal;
+    const auto              a = make_ref( 1 );
+    const auto              b = make_ref( 2 );
+    ASSERT_TRUE( less( a, b ) != less( b, a ) );
+    ASSERT_FALSE( less( a, a ) );
+    ASSERT_TRUE( equal( a, make_ref( 1 ) ) );
+    ASSERT_FALSE( equal( a, b ) );
+}
@@ -0,0 +1,247 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "mega/scheduler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <vector>
+
+namespace
+{
+struct Counters
+{
+    std::map< const void*, int > runs;
+    int                          iStopped = 0;
+};
+
+// sleeps every time it runs unless told to complete
+struct CountingExecutionState
+{
+    mega::runtime::Pointer m_ref;
+    mega::ReturnReason     m_reason;
+    Counters*              m_pCounters;
+    int                    m_iRunsBeforeComplete;
+
+    CountingExecutionState( const mega::runtime::Pointer& ref, Counters* pCounters, int iRunsBeforeComplete = -1 )
+        : m_ref( ref )
+        , m_pCounters( pCounters )
+        , m_iRunsBeforeComplete( iRunsBeforeComplete )
+    {
+    }
+
+    const mega::runtime::Pointer& getRef() const { return m_ref; }
+    void                          stop() { ++m_pCounters->iStopped; }
+    void                          onEvent( const mega::runtime::Pointer& ) {}
+    const mega::ReturnReason&     getReturnReason() const { return m_reason; }
+
+    void execute()
+    {
+        const int iRuns = ++m_pCounters->runs[ m_ref.value.heap.m_header ];
+        m_reason.reason = ( iRuns == m_iRunsBeforeComplete ) ? mega::eReason_Complete : mega::eReason_Sleep;
+    }
+};
+
+using Scheduler = mega::BasicScheduler< CountingExecutionState >;
+
+struct SchedulerActions
+{
+    std::vector< c_object_header > headers;
+    Counters                       counters;
+
+    explicit SchedulerActions( mega::U64 szActions )
+        : headers( szActions )
+    {
+    }
+
+    mega::runtime::Pointer make_ref( mega::U64 index )
+    {
+        mega::runtime::Pointer ref{};
+        ref.value.heap.m_header = &headers[ index ];
+        return ref;
+    }
+
+    int runs( mega::U64 index ) { return counters.runs[ &headers[ index ] ]; }
+};
+} // namespace
+
+TEST( BasicSchedulerActions, DuplicateCallIsRejected )
+{
+    SchedulerActions actions( 1 );
+    Scheduler        scheduler;
+
+    scheduler.call( CountingExecutionState( actions.make_ref( 0 ), &actions.counters ) );
+    scheduler.call( CountingExecutionState( actions.make_ref( 0 ), &actions.counters ) );
+    ASSERT_EQ( scheduler.size(), 1U );
+
+    scheduler.cycle();
+    ASSERT_EQ( actions.runs( 0 ), 1 );
+    scheduler.stop( actions.make_ref( 0 ) );
+}
+
+TEST( BasicSchedulerActions, PauseAndUnpause )
+{
+    SchedulerActions actions( 2 );
+    Scheduler        scheduler;
+
+    scheduler.call( CountingExecutionState( actions.make_ref( 0 ), &actions.counters ) );
+    scheduler.call( CountingExecutionState( actions.make_ref( 1 ), &actions.counters ) );
+    scheduler.cycle();
+    ASSERT_EQ( actions.runs( 0 ), 1 );
+    ASSERT_EQ( actions.runs( 1 ), 1 );
+
+    scheduler.pause( actions.make_ref( 0 ) );
+    scheduler.cycle();
+    scheduler.cycle();
+    ASSERT_EQ( actions.runs( 0 ), 1 );
+    ASSERT_EQ( actions.runs( 1 ), 3 );
+    ASSERT_EQ( scheduler.size(), 2U );
+
+    // the unpaused action is active so runs before the sleeping actions are woken
+    scheduler.unpause( actions.make_ref( 0 ) );
+    scheduler.cycle();
+    ASSERT_EQ( actions.runs( 0 ), 2 );
+    ASSERT_EQ( actions.runs( 1 ), 3 );
+    scheduler.cycle();
+    ASSERT_EQ( actions.runs( 0 ), 3 );
+    ASSERT_EQ( actions.runs( 1 ), 4 );
+
+    // unpausing an action that is not paused leaves it scheduled once
+    scheduler.unpause( actions.make_ref( 1 ) );
+    scheduler.cycle();
+    ASSERT_EQ( actions.runs( 0 ), 4 );
+    ASSERT_EQ( actions.runs( 1 ), 5 );
+
+    scheduler.stop( actions.make_ref( 0 ) );
+    scheduler.stop( actions.make_ref( 1 ) );
+    ASSERT_FALSE( scheduler.active() );
+}
+
+TEST( BasicSchedulerActions, StopPausedAction )
+{
+    SchedulerActions actions( 1 );
+    Scheduler        scheduler;
+
+    scheduler.call( CountingExecutionState( actions.make_ref( 0 ), &actions.counters ) );
+    scheduler.pause( actions.make_ref( 0 ) );
+    scheduler.stop( actions.make_ref( 0 ) );
+    ASSERT_FALSE( scheduler.active() );
+    ASSERT_EQ( actions.counters.iStopped, 1 );
+
+    // the ref can be scheduled again once stopped
+    scheduler.call( CountingExecutionState( actions.make_ref( 0 ), &actions.counters ) );
+    scheduler.cycle();
+    ASSERT_EQ( actions.runs( 0 ), 1 );
+    scheduler.stop( actions.make_ref( 0 ) );
+}
+
+TEST( BasicSchedulerActions, CompleteRemovesAction )
+{
+    SchedulerActions actions( 2 );
+    Scheduler        scheduler;
+
+    scheduler.call( CountingExecutionState( actions.make_ref( 0 ), &actions.counters, 2 ) );
+    scheduler.call( CountingExecutionState( actions.make_ref( 1 ), &actions.counters ) );
+    scheduler.cycle();
+    ASSERT_EQ( scheduler.size(), 2U );
+    scheduler.cycle();
+    ASSERT_EQ( scheduler.size(), 1U );
+    ASSERT_EQ( actions.counters.iStopped, 1 );
+    scheduler.cycle();
+    ASSERT_EQ( actions.runs( 0 ), 2 );
+    ASSERT_EQ( actions.runs( 1 ), 3 );
+    scheduler.stop( actions.make_ref( 1 ) );
+}
+
+TEST( BasicSchedulerActions, RandomCallStopPause )
+{
+    static constexpr mega::U64 ACTIONS = 512U;
+
+    SchedulerActions    actions( ACTIONS );
+    Scheduler           scheduler;
+    std::vector< bool > scheduled( ACTIONS, false ), paused( ACTIONS, false );
+    std::mt19937_64     randNumGen( 7U );
+    mega::U64           szScheduled = 0U;
+
+    for( int step = 0; step != 20000; ++step )
+    {
+        const mega::U64 i = randNumGen() % ACTIONS;
+        switch( randNumGen() % 4U )
+        {
+            case 0:
+                if( !scheduled[ i ] )
+                {
+                    scheduler.call( CountingExecutionState( actions.make_ref( i ), &actions.counters ) );
+                    scheduled[ i ] = true;
+                    ++szScheduled;
+                }
+                break;
+            case 1:
+                if( scheduled[ i ] )
+                {
+                    scheduler.stop( actions.make_ref( i ) );
+                    scheduled[ i ] = paused[ i ] = false;
+                    --szScheduled;
+                }
+                break;
+            case 2:
+                if( scheduled[ i ] )
+                {
+                    paused[ i ] ? scheduler.unpause( actions.make_ref( i ) ) : scheduler.pause( actions.make_ref( i ) );
+                    paused[ i ] = !paused[ i ];
+                }
+                break;
+            case 3:
+            {
+                // over two cycles every runnable action runs once or twice and nothing else runs
+                const auto before = actions.counters.runs;
+                scheduler.cycle();
+                scheduler.cycle();
+                for( mega::U64 j = 0U; j != ACTIONS; ++j )
+                {
+                    auto      iBefore = before.find( &actions.headers[ j ] );
+                    const int iDelta  = actions.runs( j ) - ( iBefore == before.end() ? 0 : iBefore->second );
+                    if( scheduled[ j ] && !paused[ j ] )
+                    {
+                        ASSERT_GE( iDelta, 1 );
+                        ASSERT_LE( iDelta, 2 );
+                    }
+                    else
+                    {
+                        ASSERT_EQ( iDelta, 0 );
+                    }
+                }
+            }
+            break;
+        }
+        ASSERT_EQ( scheduler.size(), szScheduled );
+    }
+
+    for( mega::U64 i = 0U; i != ACTIONS; ++i )
+    {
+        if( scheduled[ i ] )
+        {
+            scheduler.stop( actions.make_ref( i ) );
+        }
+    }
+    ASSERT_FALSE( scheduler.active() );
+}
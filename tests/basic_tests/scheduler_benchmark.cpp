@@ -0,0 +1,399 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "mega/scheduler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <span>
+#include <vector>
+
+namespace
+{
+// drives each action through active -> wait -> active -> sleep every cycle
+struct SwapExecutionState
+{
+    mega::runtime::Pointer m_ref;
+    mega::ReturnReason     m_reason;
+    mega::U64*             m_pRunCount;
+    bool                   m_bWaited = false;
+
+    SwapExecutionState( const mega::runtime::Pointer& ref, mega::U64* pRunCount )
+        : m_ref( ref )
+        , m_pRunCount( pRunCount )
+    {
+    }
+
+    const mega::runtime::Pointer& getRef() const { return m_ref; }
+    void                          stop() {}
+    void                          onEvent( const mega::runtime::Pointer& ) {}
+    const mega::ReturnReason&     getReturnReason() const { return m_reason; }
+
+    void execute()
+    {
+        ++*m_pRunCount;
+        m_reason.reason = m_bWaited ? mega::eReason_Sleep : mega::eReason_Wait;
+        m_bWaited       = !m_bWaited;
+    }
+};
+
+// sleeps for a short number of simulation cycles every time it runs
+struct TimeoutExecutionState
+{
+    mega::runtime::Pointer m_ref;
+    mega::ReturnReason     m_reason;
+    mega::U64*             m_pRunCount;
+    mega::U32*             m_pCycle;
+    mega::U32              m_period;
+
+    TimeoutExecutionState( const mega::runtime::Pointer& ref, mega::U64* pRunCount, mega::U32* pCycle,
+                           mega::U32 period )
+        : m_ref( ref )
+        , m_pRunCount( pRunCount )
+        , m_pCycle( pCycle )
+        , m_period( period )
+    {
+    }
+
+    const mega::runtime::Pointer& getRef() const { return m_ref; }
+    void                          stop() {}
+    void                          onEvent( const mega::runtime::Pointer& ) {}
+    const mega::ReturnReason&     getReturnReason() const { return m_reason; }
+
+    void execute()
+    {
+        ++*m_pRunCount;
+        m_reason = mega::ReturnReason( mega::runtime::TimeStamp{ *m_pCycle + m_period } );
+    }
+};
+
+// sleeps on any of two pseudo random events every time it runs
+struct EventExecutionState
+{
+    using EventVector = std::vector< mega::runtime::Pointer >;
+
+    mega::runtime::Pointer m_ref;
+    mega::ReturnReason     m_reason;
+    mega::U64*             m_pRunCount;
+    const EventVector*     m_pEvents;
+    mega::U64              m_seed;
+
+    EventExecutionState( const mega::runtime::Pointer& ref, mega::U64* pRunCount, const EventVector* pEvents,
+                         mega::U64 seed )
+        : m_ref( ref )
+        , m_pRunCount( pRunCount )
+        , m_pEvents( pEvents )
+        , m_seed( seed | 1U )
+    {
+    }
+
+    const mega::runtime::Pointer& getRef() const { return m_ref; }
+    void                          stop() {}
+    void                          onEvent( const mega::runtime::Pointer& ) {}
+    const mega::ReturnReason&     getReturnReason() const { return m_reason; }
+
+    mega::U64 next()
+    {
+        m_seed ^= m_seed << 13U;
+        m_seed ^= m_seed >> 7U;
+        m_seed ^= m_seed << 17U;
+        return m_seed;
+    }
+
+    void execute()
+    {
+        ++*m_pRunCount;
+        m_reason.reason = mega::eReason_Sleep_Any;
+        m_reason.events.clear();
+        m_reason.events.push_back( ( *m_pEvents )[ next() % m_pEvents->size() ] );
+        m_reason.events.push_back( ( *m_pEvents )[ next() % m_pEvents->size() ] );
+    }
+};
+
+// the event registration the scheduler used before SortedEventIndex - a multimap from event to action
+// re-seeked after every wake - driven with the same actions as EventExecutionState for a baseline
+class MultimapEventRegistry
+{
+    using EventRefMap          = std::multimap< mega::runtime::Pointer, mega::U64, mega::PointerRaw::Less >;
+    using EventRefMapIterArray = std::vector< EventRefMap::iterator >;
+
+    const EventExecutionState::EventVector& m_events;
+    std::vector< mega::U64 >                m_seeds;
+    std::vector< EventRefMapIterArray >     m_registrations;
+    std::vector< mega::U64 >                m_woken;
+    EventRefMap                             m_eventMap;
+
+    mega::U64 next( mega::U64 action )
+    {
+        mega::U64& seed = m_seeds[ action ];
+        seed ^= seed << 13U;
+        seed ^= seed >> 7U;
+        seed ^= seed << 17U;
+        return seed;
+    }
+
+    void sleepAny( mega::U64 action )
+    {
+        for( int i = 0; i != 2; ++i )
+        {
+            const mega::runtime::Pointer& ev = m_events[ next( action ) % m_events.size() ];
+            m_registrations[ action ].push_back( m_eventMap.insert( { ev, action } ) );
+        }
+    }
+
+public:
+    MultimapEventRegistry( mega::U64 szActions, const EventExecutionState::EventVector& events )
+        : m_events( events )
+        , m_registrations( szActions )
+    {
+        for( mega::U64 i = 0U; i != szActions; ++i )
+        {
+            m_seeds.push_back( ( i * 7919U ) | 1U );
+            sleepAny( i );
+        }
+    }
+
+    void signal( const mega::runtime::Pointer& ref )
+    {
+        for( auto iterEvent = m_eventMap.lower_bound( ref );
+             ( iterEvent != m_eventMap.end() ) && !mega::PointerRaw::Less()( ref, iterEvent->first );
+             iterEvent = m_eventMap.lower_bound( ref ) )
+        {
+            const mega::U64 action = iterEvent->second;
+            for( auto i : m_registrations[ action ] )
+            {
+                m_eventMap.erase( i );
+            }
+            m_registrations[ action ].clear();
+            m_woken.push_back( action );
+        }
+    }
+
+    // run the woken actions as cycle() would and return how many ran
+    mega::U64 cycle()
+    {
+        for( mega::U64 action : m_woken )
+        {
+            sleepAny( action );
+        }
+        const mega::U64 szWoken = m_woken.size();
+        m_woken.clear();
+        return szWoken;
+    }
+};
+
+struct SchedulerBenchmark
+{
+    std::vector< c_object_header > headers;
+    mega::U64                      runCount = 0U;
+
+    SchedulerBenchmark( mega::U64 szActions )
+        : headers( szActions )
+    {
+    }
+
+    mega::runtime::Pointer make_ref( mega::U64 index )
+    {
+        mega::runtime::Pointer ref{};
+        ref.value.heap.m_header = &headers[ index ];
+        return ref;
+    }
+};
+} // namespace
+
+TEST( BasicSchedulerBenchmark, ActiveWaitSleep )
+{
+    static constexpr mega::U64 ACTIONS = 100000U;
+    static constexpr mega::U64 CYCLES  = 20U;
+
+    SchedulerBenchmark                         bench( ACTIONS );
+    mega::BasicScheduler< SwapExecutionState > scheduler;
+
+    for( mega::U64 i = 0U; i != ACTIONS; ++i )
+    {
+        scheduler.call( SwapExecutionState( bench.make_ref( i ), &bench.runCount ) );
+    }
+    ASSERT_EQ( scheduler.size(), ACTIONS );
+
+    // warm up so the pool and index have reached steady state
+    scheduler.cycle();
+    bench.runCount = 0U;
+
+    const auto start = std::chrono::steady_clock::now();
+    for( mega::U64 i = 0U; i != CYCLES; ++i )
+    {
+        scheduler.cycle();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    ASSERT_EQ( scheduler.size(), ACTIONS );
+    ASSERT_EQ( bench.runCount, ACTIONS * CYCLES * 2U );
+
+    const double ns = std::chrono::duration< double, std::nano >( elapsed ).count();
+    std::cout << "BasicScheduler: " << ACTIONS << " actions " << CYCLES
+              << " cycles: " << ( ns / static_cast< double >( ACTIONS * CYCLES ) ) << " ns per action per cycle"
+              << std::endl;
+
+    for( mega::U64 i = 0U; i != ACTIONS; ++i )
+    {
+        scheduler.stop( bench.make_ref( i ) );
+    }
+    ASSERT_FALSE( scheduler.active() );
+}
+
+TEST( BasicSchedulerBenchmark, CycleTimeouts )
+{
+    static constexpr mega::U64 ACTIONS = 100000U;
+    static constexpr mega::U32 CYCLES  = 64U;
+    static constexpr mega::U32 PERIODS = 8U;
+
+    SchedulerBenchmark                            bench( ACTIONS );
+    mega::BasicScheduler< TimeoutExecutionState > scheduler;
+    mega::U32                                     cycle = 0U;
+
+    for( mega::U64 i = 0U; i != ACTIONS; ++i )
+    {
+        const mega::U32 period = 1U + static_cast< mega::U32 >( i % PERIODS );
+        scheduler.call( TimeoutExecutionState( bench.make_ref( i ), &bench.runCount, &cycle, period ) );
+    }
+
+    cycle = 1U;
+    scheduler.cycle( mega::runtime::TimeStamp{ cycle } );
+    bench.runCount = 0U;
+
+    const auto start = std::chrono::steady_clock::now();
+    for( mega::U32 i = 0U; i != CYCLES; ++i )
+    {
+        ++cycle;
+        scheduler.cycle( mega::runtime::TimeStamp{ cycle } );
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // every period divides the number of cycles so each action ran CYCLES / period times
+    mega::U64 expected = 0U;
+    for( mega::U64 i = 0U; i != ACTIONS; ++i )
+    {
+        expected += CYCLES / ( 1U + ( i % PERIODS ) );
+    }
+    ASSERT_EQ( bench.runCount, expected );
+
+    const double ns = std::chrono::duration< double, std::nano >( elapsed ).count();
+    std::cout << "BasicScheduler: " << ACTIONS << " actions " << CYCLES << " cycles with cycle timeouts: "
+              << ( ns / static_cast< double >( bench.runCount ) ) << " ns per timeout" << std::endl;
+}
+
+// compare signalling each event individually against one sorted batch per cycle
+TEST( BasicSchedulerBenchmark, SignalBatch )
+{
+    static constexpr mega::U64 ACTIONS = 100000U;
+    static constexpr mega::U64 EVENTS  = 50000U;
+    static constexpr mega::U64 SIGNALS = 10000U;
+    static constexpr mega::U64 CYCLES  = 20U;
+
+    using Scheduler = mega::BasicScheduler< EventExecutionState >;
+
+    SchedulerBenchmark                              bench( ACTIONS );
+    SchedulerBenchmark                              eventBench( EVENTS );
+    EventExecutionState::EventVector                events;
+    std::vector< EventExecutionState::EventVector > cycleSignals( CYCLES );
+    for( mega::U64 i = 0U; i != EVENTS; ++i )
+    {
+        events.push_back( eventBench.make_ref( i ) );
+    }
+    mega::U64 seed = 0x2545F4914F6CDD1DULL;
+    for( auto& signals : cycleSignals )
+    {
+        for( mega::U64 i = 0U; i != SIGNALS; ++i )
+        {
+            seed ^= seed << 13U;
+            seed ^= seed >> 7U;
+            seed ^= seed << 17U;
+            signals.push_back( events[ seed % EVENTS ] );
+        }
+    }
+
+    auto run = [ & ]( bool bBatch, mega::U64& runCount )
+    {
+        Scheduler scheduler;
+        for( mega::U64 i = 0U; i != ACTIONS; ++i )
+        {
+            scheduler.call( EventExecutionState( bench.make_ref( i ), &runCount, &events, i * 7919U ) );
+        }
+        scheduler.cycle();
+        runCount = 0U;
+
+        // only time the signal dispatch - the woken actions run in cycle()
+        double ns = 0.0;
+        for( const auto& signals : cycleSignals )
+        {
+            const auto start = std::chrono::steady_clock::now();
+            if( bBatch )
+            {
+                scheduler.signal( std::span< const mega::runtime::Pointer >( signals ) );
+            }
+            else
+            {
+                for( const mega::runtime::Pointer& signal : signals )
+                {
+                    scheduler.signal( signal );
+                }
+            }
+            ns += std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count();
+            scheduler.cycle();
+        }
+        return ns;
+    };
+
+    auto runMultimap = [ & ]( mega::U64& runCount )
+    {
+        MultimapEventRegistry registry( ACTIONS, events );
+        runCount  = 0U;
+        double ns = 0.0;
+        for( const auto& signals : cycleSignals )
+        {
+            const auto start = std::chrono::steady_clock::now();
+            for( const mega::runtime::Pointer& signal : signals )
+            {
+                registry.signal( signal );
+            }
+            ns += std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count();
+            runCount += registry.cycle();
+        }
+        return ns;
+    };
+
+    mega::U64    multimapRuns = 0U, perEventRuns = 0U, batchRuns = 0U;
+    const double multimapNS = runMultimap( multimapRuns );
+    const double perEventNS = run( false, perEventRuns );
+    const double batchNS    = run( true, batchRuns );
+
+    // sleep_any wakes on the first match so every path wakes the same actions
+    ASSERT_EQ( multimapRuns, batchRuns );
+    ASSERT_EQ( perEventRuns, batchRuns );
+    ASSERT_GT( batchRuns, 0U );
+
+    const double signals = static_cast< double >( SIGNALS * CYCLES );
+    std::cout << "BasicScheduler: " << ACTIONS << " actions " << SIGNALS << " signals per cycle woke " << batchRuns
+              << " multimap: " << ( multimapNS / signals ) << " ns per signal per event: " << ( perEventNS / signals )
+              << " ns per signal batch: " << ( batchNS / signals ) << " ns per signal" << std::endl;
+}
@@ -0,0 +1,150 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include <gtest/gtest.h>
+
+#include "mega/timer_wheel.hpp"
+
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace
+{
+struct TestTimerTag;
+struct TestTimer : public mega::TimerWheel< TestTimer, TestTimerTag >::Hook
+{
+    int id = 0;
+};
+using TestWheel = mega::TimerWheel< TestTimer, TestTimerTag >;
+} // namespace
+
+TEST( TimerWheel, ExpiresInOrder )
+{
+    std::vector< TestTimer > timers( 3 );
+    TestWheel                wheel( 100U );
+
+    wheel.insert( &timers[ 0 ], 150U );
+    wheel.insert( &timers[ 1 ], 100000U );
+    wheel.insert( &timers[ 2 ], 50U );
+    ASSERT_EQ( wheel.size(), 3U );
+
+    std::vector< TestTimer* > expired;
+    auto                      onExpired = [ &expired ]( TestTimer* pTimer ) { expired.push_back( pTimer ); };
+
+    // already due timers expire on the next advance
+    wheel.advance( 100U, onExpired );
+    ASSERT_EQ( expired, std::vector< TestTimer* >{ &timers[ 2 ] } );
+
+    wheel.advance( 149U, onExpired );
+    ASSERT_EQ( expired.size(), 1U );
+    wheel.advance( 150U, onExpired );
+    ASSERT_EQ( expired.size(), 2U );
+    ASSERT_EQ( expired.back(), &timers[ 0 ] );
+
+    wheel.advance( 1000000U, onExpired );
+    ASSERT_EQ( expired.size(), 3U );
+    ASSERT_EQ( expired.back(), &timers[ 1 ] );
+    ASSERT_TRUE( wheel.empty() );
+}
+
+TEST( TimerWheel, Cancel )
+{
+    std::vector< TestTimer > timers( 2 );
+    TestWheel                wheel;
+
+    wheel.insert( &timers[ 0 ], 10U );
+    wheel.insert( &timers[ 1 ], 1U << 20U );
+    ASSERT_TRUE( wheel.cancel( &timers[ 1 ] ) );
+    ASSERT_FALSE( wheel.cancel( &timers[ 1 ] ) );
+    ASSERT_EQ( wheel.size(), 1U );
+
+    int count = 0;
+    wheel.advance( 1U << 21U, [ &count ]( TestTimer* ) { ++count; } );
+    ASSERT_EQ( count, 1 );
+}
+
+// compare against a sorted reference over random inserts, cancels and advances
+// including timers far enough away to land in the overflow list
+TEST( TimerWheel, Random )
+{
+    std::mt19937_64 randNumGen( 123 );
+
+    std::vector< TestTimer > timers( 2000 );
+    for( int i = 0; i != static_cast< int >( timers.size() ); ++i )
+    {
+        timers[ i ].id = i;
+    }
+
+    TestWheel                  wheel( randNumGen() % 1000000U );
+    std::map< int, mega::U64 > reference;
+    mega::U64                  now = wheel.now();
+
+    for( int step = 0; step != 5000; ++step )
+    {
+        TestTimer& timer = timers[ randNumGen() % timers.size() ];
+        switch( randNumGen() % 4 )
+        {
+            case 0:
+            case 1:
+            {
+                if( reference.count( timer.id ) == 0 )
+                {
+                    const mega::U64 delta
+                        = ( randNumGen() % 3 == 0 ) ? randNumGen() % ( 1ULL << 34 ) : randNumGen() % 5000U;
+                    const mega::U64 expiry = ( randNumGen() % 10 == 0 ) ? now - ( randNumGen() % 5 ) : now + delta;
+                    wheel.insert( &timer, expiry );
+                    reference[ timer.id ] = expiry;
+                }
+            }
+            break;
+            case 2:
+            {
+                ASSERT_EQ( wheel.cancel( &timer ), reference.erase( timer.id ) == 1U );
+            }
+            break;
+            case 3:
+            {
+                now += ( randNumGen() % 5 == 0 ) ? randNumGen() % ( 1ULL << 33 ) : randNumGen() % 300U;
+
+                std::set< int > expired;
+                wheel.advance( now, [ &expired ]( TestTimer* pTimer ) { expired.insert( pTimer->id ); } );
+
+                std::set< int > expected;
+                for( auto i = reference.begin(); i != reference.end(); )
+                {
+                    if( i->second <= now )
+                    {
+                        expected.insert( i->first );
+                        i = reference.erase( i );
+                    }
+                    else
+                    {
+                        ++i;
+                    }
+                }
+                ASSERT_EQ( expired, expected );
+                ASSERT_EQ( wheel.size(), reference.size() );
+            }
+            break;
+        }
+    }
+}
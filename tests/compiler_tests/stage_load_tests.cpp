@@ -0,0 +1,124 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "compiler_fixture.hpp"
+
+#include "environment/environment_stash.hpp"
+#include "environment/stage_file_cache.hpp"
+
+#include "pipeline/stash.hpp"
+
+#include "database/SymbolRollout.hxx"
+
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+// serves the build hash codes of a completed pipeline as the executor stash does for its tasks
+class ResultStash : public mega::pipeline::Stash
+{
+    mega::pipeline::PipelineResult::BuildHashCodeMap m_buildHashCodes;
+
+public:
+    ResultStash( const mega::pipeline::PipelineResult::BuildHashCodeMap& buildHashCodes )
+        : m_buildHashCodes( buildHashCodes )
+    {
+    }
+
+    virtual task::FileHash getBuildHashCode( const boost::filesystem::path& filePath ) override
+    {
+        auto iFind = m_buildHashCodes.find( filePath );
+        VERIFY_RTE_MSG( iFind != m_buildHashCodes.end(), "No build hash code for: " << filePath.string() );
+        return iFind->second;
+    }
+    virtual void setBuildHashCode( const boost::filesystem::path& filePath, task::FileHash hashCode ) override
+    {
+        m_buildHashCodes[ filePath ] = hashCode;
+    }
+    virtual void stash( const boost::filesystem::path&, task::DeterminantHash ) override {}
+    virtual bool restore( const boost::filesystem::path&, task::DeterminantHash ) override { return false; }
+    virtual mega::SymbolTable getSymbolTable() override { return {}; }
+    virtual mega::SymbolTable newSymbols( const mega::SymbolRequest& ) override { THROW_RTE( "Unused" ); }
+};
+
+using Clock = std::chrono::steady_clock;
+
+mega::U64 toMicroseconds( Clock::duration duration )
+{
+    return std::chrono::duration_cast< std::chrono::microseconds >( duration ).count();
+}
+} // namespace
+
+// loads the stages Task_SymbolRollout reads from a real build directly from disk and through the
+// stage file cache and reports how much of each load is reading files against deserialising them
+TEST( StageLoad, CacheAgainstDirectLoad )
+{
+    try
+    {
+        auto pCompilation = createBuildAndRun( "symbols_basic.mega", "stage_load", "Task_SymbolRollout" );
+
+        const mega::pipeline::PipelineResult result = pCompilation->runPipeline( "symbols_basic.mega" );
+        ASSERT_TRUE( result.getSuccess() );
+
+        const mega::io::megaFilePath sourceFilePath
+            = pCompilation->m_environment.megaFilePath_fromPath( pCompilation->m_sourceFiles.front() );
+
+        auto load = [ & ]( const mega::io::BuildEnvironment& environment )
+        {
+            const auto startTime = Clock::now();
+            {
+                SymbolRollout::Database database( environment, sourceFilePath );
+            }
+            return Clock::now() - startTime;
+        };
+
+        const Clock::duration directElapsed = load( pCompilation->m_environment );
+
+        ResultStash stash( result.getBuildHashCodes() );
+        mega::io::StageFileCache::get().clear();
+
+        mega::io::StashEnvironment coldEnvironment( stash, pCompilation->m_directories );
+        const Clock::duration      coldElapsed = load( coldEnvironment );
+        const auto&                cold        = coldEnvironment.getStageReadStatistics();
+
+        mega::io::StashEnvironment warmEnvironment( stash, pCompilation->m_directories );
+        const Clock::duration      warmElapsed = load( warmEnvironment );
+        const auto&                warm        = warmEnvironment.getStageReadStatistics();
+
+        // files without a build hash code such as the manifest are always read from disk
+        ASSERT_EQ( cold.uiHits, 0U );
+        ASSERT_NE( warm.uiHits, 0U );
+        ASSERT_EQ( warm.uiHits + warm.uiMisses, cold.uiMisses );
+
+        std::cout << "Stage load direct from disk: " << toMicroseconds( directElapsed ) << "us\n"
+                  << "Stage load cache cold: " << toMicroseconds( coldElapsed )
+                  << "us reading: " << toMicroseconds( cold.readTime )
+                  << "us deserialising: " << toMicroseconds( coldElapsed - cold.readTime ) << "us\n"
+                  << "Stage load cache warm: " << toMicroseconds( warmElapsed )
+                  << "us reading: " << toMicroseconds( warm.readTime )
+                  << "us deserialising: " << toMicroseconds( warmElapsed - warm.readTime ) << "us over "
+                  << warm.uiHits << " stage files" << std::endl;
+    }
+    catch( std::exception& ex )
+    {
+        FAIL() << ex.what();
+    }
+}
@@ -0,0 +1,172 @@
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "runtime/batch.hpp"
+
+#include <gtest/gtest.h>
+
+#include "common/clang_warnings_begin.hpp"
+
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/Core.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+
+#include "llvm/IRReader/IRReader.h"
+
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/SourceMgr.h"
+
+#include "common/clang_warnings_end.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Startup cost of materialising many functions either as one module and JITDylib per function
+// as Runtime::getFunction did or as one module and JITDylib per batch using the same partition
+// as Runtime::materialise. Runtime itself needs an installation and program database so the
+// ORC work is driven directly here.
+namespace
+{
+llvm::ExitOnError ExitOnErr;
+
+std::string generateFunction( int i )
+{
+    std::ostringstream os;
+    os << "define i32 @func_" << i << "(i32 %x) {\n"
+       << "entry:\n"
+       << "  %a = mul nsw i32 %x, " << i + 1 << "\n"
+       << "  %r = add nsw i32 %a, " << i << "\n"
+       << "  ret i32 %r\n"
+       << "}\n";
+    return os.str();
+}
+
+std::string functionName( mega::U64 i )
+{
+    return "func_" + std::to_string( i );
+}
+
+llvm::orc::ThreadSafeModule parseModule( const std::string& strSource, const std::string& strName )
+{
+    auto               pContext = std::make_unique< llvm::LLVMContext >();
+    llvm::SMDiagnostic err;
+    auto pModule = llvm::parseIR( llvm::MemoryBufferRef( strSource, strName ), err, *pContext );
+    if( !pModule )
+    {
+        std::string              strError;
+        llvm::raw_string_ostream os( strError );
+        err.print( "", os );
+        throw std::runtime_error( os.str() );
+    }
+    return llvm::orc::ThreadSafeModule( std::move( pModule ), std::move( pContext ) );
+}
+
+using FunctionPtr = int ( * )( int );
+
+class OrcBatchBenchmark : public ::testing::TestWithParam< int >
+{
+public:
+    void SetUp()
+    {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+    }
+};
+} // namespace
+
+TEST_P( OrcBatchBenchmark, Startup )
+{
+    const int iFunctions = GetParam();
+
+    std::vector< std::string > functions;
+    for( int i = 0; i != iFunctions; ++i )
+    {
+        functions.push_back( generateFunction( i ) );
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    // one module and dylib per function
+    std::chrono::microseconds perFunction;
+    {
+        auto pJit = ExitOnErr( llvm::orc::LLJITBuilder().create() );
+
+        const auto                  start = Clock::now();
+        std::vector< FunctionPtr >  pointers;
+        for( int i = 0; i != iFunctions; ++i )
+        {
+            auto& dylib = ExitOnErr( pJit->createJITDylib( functionName( i ) ) );
+            ExitOnErr( pJit->addIRModule( dylib, parseModule( functions[ i ], functionName( i ) ) ) );
+            pointers.push_back( ExitOnErr( pJit->lookup( dylib, functionName( i ) ) ).toPtr< FunctionPtr >() );
+        }
+        perFunction = std::chrono::duration_cast< std::chrono::microseconds >( Clock::now() - start );
+
+        for( int i = 0; i != iFunctions; ++i )
+        {
+            ASSERT_EQ( pointers[ i ]( 2 ), 2 * ( i + 1 ) + i );
+        }
+    }
+
+    // one module and dylib per batch partitioned as Runtime::materialise does
+    std::chrono::microseconds batched;
+    mega::U64                       uiBatches = 0U;
+    {
+        auto pJit = ExitOnErr( llvm::orc::LLJITBuilder().create() );
+
+        const auto                 start = Clock::now();
+        std::vector< FunctionPtr > pointers;
+        for( const auto& [ uiBegin, uiEnd ] :
+             mega::runtime::partitionBatches( iFunctions, std::thread::hardware_concurrency() ) )
+        {
+            const std::string strName = "batch_" + std::to_string( uiBatches++ );
+            std::string       strBatch;
+            for( mega::U64 i = uiBegin; i != uiEnd; ++i )
+            {
+                strBatch += functions[ i ];
+            }
+            auto& dylib = ExitOnErr( pJit->createJITDylib( strName ) );
+            ExitOnErr( pJit->addIRModule( dylib, parseModule( strBatch, strName ) ) );
+            for( mega::U64 i = uiBegin; i != uiEnd; ++i )
+            {
+                pointers.push_back( ExitOnErr( pJit->lookup( dylib, functionName( i ) ) ).toPtr< FunctionPtr >() );
+            }
+        }
+        batched = std::chrono::duration_cast< std::chrono::microseconds >( Clock::now() - start );
+
+        ASSERT_EQ( pointers.size(), static_cast< mega::U64 >( iFunctions ) );
+        for( int i = 0; i != iFunctions; ++i )
+        {
+            ASSERT_EQ( pointers[ i ]( 2 ), 2 * ( i + 1 ) + i );
+        }
+    }
+
+    std::cout << "Functions: " << iFunctions << " per function: " << perFunction.count()
+              << "us batched: " << batched.count() << "us in " << uiBatches << " batches" << std::endl;
+}
+
+INSTANTIATE_TEST_SUITE_P( OrcBatch, OrcBatchBenchmark, ::testing::Values( 10, 100, 1000 ) );
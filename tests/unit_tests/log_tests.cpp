@@ -28,10 +28,17 @@
 #include "event/records.hxx"
 #include "event/file_log.hpp"
 #include "event/memory_log.hpp"
+#include "event/memory_codec.hpp"
+
+#include "service/protocol/common/transaction.hpp"
 
 #include <boost/filesystem/operations.hpp>
 
 #include <string_view>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <iostream>
 
 using Path = boost::filesystem::path;
 
@@ -136,6 +143,119 @@ TEST( MemoryLogTests, Basic )
     }
 }
 
+TEST( MemoryLogTests, Concurrent )
+{
+    using namespace mega::event;
+
+    MemoryStorage log;
+
+    // enough data to spill the first log buffer
+    static constexpr int    iThreads = 4;
+    static constexpr int    iCycles  = 8;
+    static constexpr int    iRecords = 3000;
+    const std::string       strPadding( 768, 'x' );
+
+    for( int iCycle = 0; iCycle < iCycles; ++iCycle )
+    {
+        std::vector< std::thread > threads;
+        for( int iThread = 0; iThread < iThreads; ++iThread )
+        {
+            threads.emplace_back(
+                [ & ]( int iThreadIndex )
+                {
+                    for( int i = 0; i < iRecords; ++i )
+                    {
+                        const std::string strMsg
+                            = std::to_string( iThreadIndex ) + " " + std::to_string( iCycle * iRecords + i ) + strPadding;
+                        log.recordConcurrent( Log::Write( Log::eInfo, strMsg ) );
+                    }
+                },
+                iThread );
+        }
+        for( auto& thread : threads )
+        {
+            thread.join();
+        }
+        log.cycle();
+    }
+
+    // records from each thread are in order and none are lost
+    std::vector< int > expected( iThreads, 0 );
+    int                iTotal = 0;
+    for( auto i = log.begin< Log::Read >(), iEnd = log.end< Log::Read >(); i != iEnd; ++i, ++iTotal )
+    {
+        Log::Read        r = *i;
+        std::string_view msg = r.getMessage();
+        const int        iThread = msg[ 0 ] - '0';
+        ASSERT_EQ( std::stoi( std::string( msg.substr( 2, msg.find( 'x' ) - 2 ) ) ), expected[ iThread ] );
+        ++expected[ iThread ];
+    }
+    ASSERT_EQ( iTotal, iThreads * iCycles * iRecords );
+    ASSERT_NE( BufferIndex( log.get( TrackID::eLog ) ).get(), 0U );
+}
+
+TEST( MemoryLogTests, DeltaEncoding )
+{
+    using namespace mega::event;
+
+    // objects of 512 bytes changing two fields per cycle
+    static constexpr int iObjects = 1000;
+    static constexpr int iCycles  = 64;
+    static constexpr int iSize    = 512;
+
+    std::vector< c_object_header >            headers( iObjects );
+    std::vector< mega::runtime::PointerHeap > refs( iObjects );
+    std::vector< std::string >                values( iObjects, std::string( iSize, '\0' ) );
+    for( int i = 0; i < iObjects; ++i )
+    {
+        refs[ i ].m_header = &headers[ i ];
+        for( int j = 0; j < iSize; ++j )
+        {
+            values[ i ][ j ] = static_cast< char >( i * 31 + j );
+        }
+    }
+
+    MemoryStorage fullLog, deltaLog;
+    for( int iCycle = 0; iCycle < iCycles; ++iCycle )
+    {
+        for( int i = 0; i < iObjects; ++i )
+        {
+            std::string& value = values[ i ];
+            ++value[ ( iCycle * 8 ) % iSize ];
+            value[ ( i + iCycle * 24 ) % iSize ] ^= 0x5A;
+
+            fullLog.record( Memory::Write( refs[ i ], Memory::eFull, value ) );
+            deltaLog.recordMemory( refs[ i ], value );
+        }
+        fullLog.cycle();
+        deltaLog.cycle();
+    }
+
+    // replay and check the final value of every object
+    const auto    start = std::chrono::steady_clock::now();
+    MemoryDecoder decoder;
+    for( auto i = deltaLog.begin< Memory::Read >(), iEnd = deltaLog.end< Memory::Read >(); i != iEnd; ++i )
+    {
+        decoder.push( *i );
+    }
+    for( int i = 0; i < iObjects; ++i )
+    {
+        ASSERT_EQ( decoder.get( refs[ i ] ), values[ i ] );
+    }
+    const auto elapsed
+        = std::chrono::duration_cast< std::chrono::duration< double > >( std::chrono::steady_clock::now() - start );
+
+    const mega::U64 fullBytes  = fullLog.get( TrackID::eMemory ).get();
+    const mega::U64 deltaBytes = deltaLog.get( TrackID::eMemory ).get();
+    ASSERT_LT( deltaBytes * 4U, fullBytes );
+
+    std::cout << "Memory track full bytes per cycle:  " << fullBytes / iCycles << std::endl;
+    std::cout << "Memory track delta bytes per cycle: " << deltaBytes / iCycles << std::endl;
+    std::cout << "Memory track replay throughput:     "
+              << static_cast< double >( deltaLog.getMemoryEncoder().getRawBytes() ) / elapsed.count() / ( 1024.0 * 1024.0 ) << " MB/s"
+              << std::endl;
+}
+
 namespace bfs = boost::filesystem;
 
 class BasicLogTest : public ::testing::Test
@@ -274,6 +394,111 @@ TEST_F( BasicLogTest, MemoryMsg )
     FileStorage                   log( logPath, false );
 }
 
+TEST_F( BasicLogTest, MemoryTransactionRoundTrip )
+{
+    using namespace mega::event;
+
+    static constexpr int iObjects = 16;
+    static constexpr int iCycles  = 8;
+    static constexpr int iSize    = 64;
+
+    const boost::filesystem::path logPath = m_folder / "MemoryTransactionRoundTrip";
+    FileStorage                   log( logPath, false );
+    mega::network::TransactionProducer producer( log );
+
+    std::vector< c_object_header >            headers( iObjects );
+    std::vector< mega::runtime::PointerHeap > refs( iObjects );
+    std::vector< std::string >                values( iObjects, std::string( iSize, 'x' ) );
+    for( int i = 0; i < iObjects; ++i )
+    {
+        refs[ i ].m_header = &headers[ i ];
+    }
+
+    for( int iCycle = 0; iCycle < iCycles; ++iCycle )
+    {
+        for( int i = 0; i < iObjects; ++i )
+        {
+            values[ i ][ ( i + iCycle ) % iSize ] ^= 0x11;
+            log.recordMemory( refs[ i ], values[ i ] );
+        }
+        log.cycle();
+
+        mega::network::TransactionProducer::MPOTransactions transactions;
+        mega::network::TransactionProducer::UnparentedSet   unparented;
+        mega::network::TransactionProducer::MovedObjects    moved;
+        producer.generate( transactions, unparented, moved );
+
+        // every record after the first cycle is written as a delta yet each transaction carries the full value
+        ASSERT_EQ( transactions.size(), 1U );
+        const auto& memory = transactions.begin()->second.m_memory;
+        ASSERT_EQ( memory.size(), static_cast< std::size_t >( iObjects ) );
+        for( int i = 0; i < iObjects; ++i )
+        {
+            ASSERT_EQ( memory[ i ].m_data.m_Encoding, Memory::eFull );
+            ASSERT_EQ( memory[ i ].m_Data, values[ i ] );
+        }
+    }
+    ASSERT_LT( log.getMemoryEncoder().getEncodedBytes(), log.getMemoryEncoder().getRawBytes() );
+}
+
+TEST_F( BasicLogTest, MemoryTransactionResync )
+{
+    using namespace mega::event;
+
+    static constexpr int iObjects = 4;
+    static constexpr int iSize    = 64;
+
+    const boost::filesystem::path logPath = m_folder / "MemoryTransactionResync";
+    FileStorage                   log( logPath, false );
+
+    std::vector< c_object_header >            headers( iObjects );
+    std::vector< mega::runtime::PointerHeap > refs( iObjects );
+    std::vector< std::string >                values( iObjects, std::string( iSize, 'x' ) );
+    for( int i = 0; i < iObjects; ++i )
+    {
+        refs[ i ].m_header = &headers[ i ];
+    }
+    auto writeCycle = [ & ]()
+    {
+        for( int i = 0; i < iObjects; ++i )
+        {
+            values[ i ][ log.getTimeStamp() % iSize ] ^= 0x11;
+            log.recordMemory( refs[ i ], values[ i ] );
+        }
+        log.cycle();
+    };
+
+    // a producer that starts part way through a key frame cannot resolve the deltas until the next one
+    writeCycle();
+    mega::network::TransactionProducer producer( log );
+    while( !memory_codec::isKeyFrame( log.getTimeStamp() ) )
+    {
+        writeCycle();
+        mega::network::TransactionProducer::MPOTransactions transactions;
+        mega::network::TransactionProducer::UnparentedSet   unparented;
+        mega::network::TransactionProducer::MovedObjects    moved;
+        producer.generate( transactions, unparented, moved );
+        ASSERT_TRUE( transactions.empty() );
+    }
+
+    for( int iCycle = 0; iCycle != 2; ++iCycle )
+    {
+        writeCycle();
+        mega::network::TransactionProducer::MPOTransactions transactions;
+        mega::network::TransactionProducer::UnparentedSet   unparented;
+        mega::network::TransactionProducer::MovedObjects    moved;
+        producer.generate( transactions, unparented, moved );
+
+        ASSERT_EQ( transactions.size(), 1U );
+        const auto& memory = transactions.begin()->second.m_memory;
+        ASSERT_EQ( memory.size(), static_cast< std::size_t >( iObjects ) );
+        for( int i = 0; i < iObjects; ++i )
+        {
+            ASSERT_EQ( memory[ i ].m_Data, values[ i ] );
+        }
+    }
+}
+
 #pragma pack( 1 )
 struct MemoryReadHeader
 {
@@ -298,7 +523,7 @@ TEST_F( BasicLogTest, Range )
     {
         for( const auto& ex : expected )
         {
-            log.record( Memory::Write( ex, strView ) );
+            log.record( Memory::Write( ex, Memory::eFull, strView ) );
         }
     }
     log.cycle();
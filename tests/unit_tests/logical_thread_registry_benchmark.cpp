@@ -0,0 +1,142 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "service/network/logical_thread_registry.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using namespace mega;
+using namespace mega::network;
+
+// the registry before sharding - one map behind one shared_mutex
+class SingleLockRegistry
+{
+public:
+    void insert( const LogicalThreadID& id, LogicalThreadBase::Ptr pLogicalThread )
+    {
+        std::unique_lock< std::shared_mutex > lock( m_mutex );
+        m_map.insert( { id, std::move( pLogicalThread ) } );
+    }
+    bool erase( const LogicalThreadID& id )
+    {
+        std::unique_lock< std::shared_mutex > lock( m_mutex );
+        return m_map.erase( id ) != 0U;
+    }
+    LogicalThreadBase::Ptr find( const LogicalThreadID& id ) const
+    {
+        std::shared_lock< std::shared_mutex > lock( m_mutex );
+        auto                                  iFind = m_map.find( id );
+        return iFind != m_map.end() ? iFind->second : LogicalThreadBase::Ptr{};
+    }
+
+private:
+    mutable std::shared_mutex                           m_mutex;
+    std::map< LogicalThreadID, LogicalThreadBase::Ptr > m_map;
+};
+
+// receiver threads look up live ids while one thread churns short lived logical threads
+template < typename Registry >
+double nanosecondsPerLookup( U64 szThreads, const std::vector< LogicalThreadID >& ids, U64 szLookups )
+{
+    Registry registry;
+    for( const auto& id : ids )
+    {
+        registry.insert( id, {} );
+    }
+
+    std::atomic< bool > bStop = false;
+    std::thread         churn(
+        [ & ]
+        {
+            while( !bStop )
+            {
+                const LogicalThreadID id;
+                registry.insert( id, {} );
+                registry.erase( id );
+            }
+        } );
+
+    const auto               start = std::chrono::steady_clock::now();
+    std::vector< std::thread > receivers;
+    for( U64 t = 0; t != szThreads; ++t )
+    {
+        receivers.emplace_back(
+            [ &, t ]
+            {
+                for( U64 i = 0; i != szLookups; ++i )
+                {
+                    registry.find( ids[ ( i * 7 + t * 131 ) % ids.size() ] );
+                }
+            } );
+    }
+    for( auto& receiver : receivers )
+    {
+        receiver.join();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    bStop = true;
+    churn.join();
+
+    return std::chrono::duration< double, std::nano >( elapsed ).count() / static_cast< double >( szLookups );
+}
+} // namespace
+
+TEST( LogicalThreadRegistry, InsertFindErase )
+{
+    LogicalThreadRegistry          registry;
+    std::vector< LogicalThreadID > ids( 1000 );
+    for( const auto& id : ids )
+    {
+        registry.insert( id, {} );
+    }
+    ASSERT_EQ( registry.getIDs().size(), ids.size() );
+
+    for( U64 i = 0; i != ids.size(); i += 2 )
+    {
+        ASSERT_TRUE( registry.erase( ids[ i ] ) );
+    }
+    ASSERT_FALSE( registry.erase( ids.front() ) );
+    ASSERT_EQ( registry.getIDs().size(), ids.size() / 2 );
+}
+
+TEST( LogicalThreadRegistry, Contention )
+{
+    static constexpr U64 szLookups = 200000;
+
+    const std::vector< LogicalThreadID > ids( 4096 );
+
+    for( U64 szThreads : { 1, 2, 4, 8, 16, 32 } )
+    {
+        const double singleLock = nanosecondsPerLookup< SingleLockRegistry >( szThreads, ids, szLookups );
+        const double sharded    = nanosecondsPerLookup< LogicalThreadRegistry >( szThreads, ids, szLookups );
+        std::cout << "Receiver threads: " << szThreads << " single lock: " << singleLock
+                  << "ns sharded: " << sharded << "ns per thread lookup" << std::endl;
+    }
+}
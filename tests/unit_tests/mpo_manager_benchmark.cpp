@@ -0,0 +1,160 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "service/root/mpo_manager.hpp"
+
+#include "mega/ring_allocator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace
+{
+using namespace mega;
+
+static constexpr U64 LEAFS           = 10000U;
+static constexpr U64 OWNERS_PER_LEAF = 4U;
+static constexpr U64 STORMS          = 4U;
+
+// the per machine allocators before the bitmap allocator - every owner ring is built on enrol
+class RingMachineAllocators
+{
+    static constexpr auto MAX_PROCESS_PER_MACHINE = std::numeric_limits< runtime::ProcessID::ValueType >::max();
+    static constexpr auto MAX_OWNER_PER_PROCESS   = std::numeric_limits< runtime::OwnerID::ValueType >::max();
+
+    using ProcessAllocator = RingAllocator< runtime::ProcessID, MAX_PROCESS_PER_MACHINE >;
+    using OwnerAllocator   = RingAllocator< runtime::OwnerID, MAX_OWNER_PER_PROCESS >;
+    using OwnerArray       = std::array< OwnerAllocator, MAX_PROCESS_PER_MACHINE >;
+
+    runtime::MachineID            m_machineID;
+    ProcessAllocator              m_processes;
+    std::unique_ptr< OwnerArray > m_pOwners = std::make_unique< OwnerArray >();
+
+public:
+    RingMachineAllocators( runtime::MachineID machineID )
+        : m_machineID( machineID )
+    {
+    }
+    runtime::MP  newLeaf() { return runtime::MP( m_machineID, m_processes.allocate() ); }
+    runtime::MPO newOwner( runtime::MP leafMP )
+    {
+        return runtime::MPO( leafMP, ( *m_pOwners )[ leafMP.getProcessID().getValue() ].allocate() );
+    }
+    std::vector< runtime::MPO > leafDisconnected( runtime::MP mp )
+    {
+        m_processes.free( mp.getProcessID() );
+        std::vector< runtime::MPO > allocated;
+        OwnerAllocator&             owners = ( *m_pOwners )[ mp.getProcessID().getValue() ];
+        for( runtime::OwnerID id : owners.getAllocated() )
+        {
+            allocated.emplace_back( runtime::MPO( mp, id ) );
+        }
+        owners.reset();
+        return allocated;
+    }
+};
+
+// enrol one daemon then connect LEAFS leafs each creating OWNERS_PER_LEAF owners then disconnect them all
+template < typename Functor >
+double millisecondsPerStorm( Functor&& storm )
+{
+    const auto start = std::chrono::steady_clock::now();
+    for( U64 i = 0; i != STORMS; ++i )
+    {
+        storm();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration< double, std::milli >( elapsed ).count() / static_cast< double >( STORMS );
+}
+} // namespace
+
+TEST( MPOManager, EnrolDisconnect )
+{
+    service::MPOManager            manager;
+    const runtime::MachineID       machineID = manager.newDaemon();
+    const runtime::MP              mp        = manager.newLeaf( machineID );
+    const network::LogicalThreadID logicalThreadID;
+
+    const runtime::MPO first  = manager.newOwner( mp, logicalThreadID );
+    const runtime::MPO second = manager.newOwner( mp, logicalThreadID );
+    ASSERT_EQ( manager.getMPO( mp ), ( std::vector< runtime::MPO >{ first, second } ) );
+
+    manager.release( first );
+    ASSERT_EQ( manager.getMPO( mp ), ( std::vector< runtime::MPO >{ second } ) );
+    ASSERT_EQ( manager.newOwner( mp, logicalThreadID ), first );
+
+    ASSERT_EQ( manager.leafDisconnected( mp ).size(), 2U );
+    ASSERT_TRUE( manager.getMPO( mp ).empty() );
+    ASSERT_TRUE( manager.getMachineProcesses( machineID ).empty() );
+    manager.daemonDisconnect( machineID );
+}
+
+TEST( MPOManager, EnrolDisconnectStorm )
+{
+    const network::LogicalThreadID logicalThreadID;
+
+    const double ring = millisecondsPerStorm(
+        [ & ]
+        {
+            RingMachineAllocators      machine( runtime::MachineID{ 0 } );
+            std::vector< runtime::MP > leafs;
+            for( U64 i = 0; i != LEAFS; ++i )
+            {
+                leafs.push_back( machine.newLeaf() );
+                for( U64 j = 0; j != OWNERS_PER_LEAF; ++j )
+                {
+                    machine.newOwner( leafs.back() );
+                }
+            }
+            for( const auto& mp : leafs )
+            {
+                machine.leafDisconnected( mp );
+            }
+        } );
+
+    const double bitmap = millisecondsPerStorm(
+        [ & ]
+        {
+            service::MPOManager        manager;
+            const runtime::MachineID   machineID = manager.newDaemon();
+            std::vector< runtime::MP > leafs;
+            for( U64 i = 0; i != LEAFS; ++i )
+            {
+                leafs.push_back( manager.newLeaf( machineID ) );
+                for( U64 j = 0; j != OWNERS_PER_LEAF; ++j )
+                {
+                    manager.newOwner( leafs.back(), logicalThreadID );
+                }
+            }
+            for( const auto& mp : leafs )
+            {
+                ASSERT_EQ( manager.leafDisconnected( mp ).size(), OWNERS_PER_LEAF );
+            }
+            manager.daemonDisconnect( machineID );
+        } );
+
+    std::cout << "Enrol and disconnect of " << LEAFS << " leafs ring: " << ring << "ms bitmap: " << bitmap << "ms"
+              << std::endl;
+}
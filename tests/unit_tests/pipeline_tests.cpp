@@ -19,12 +19,22 @@
 
 
 #include "pipeline/pipeline.hpp"
+#include "pipeline/critical_path.hpp"
+#include "pipeline/pipeline_result.hpp"
 #include "pipeline/task.hpp"
 
 #include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/xml_iarchive.hpp>
+#include <boost/archive/xml_oarchive.hpp>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <utility>
 #include <sstream>
 #include <list>
@@ -126,3 +136,300 @@ TEST( Pipeline, Schedule2 )
     ASSERT_TRUE( s.getReady() == TaskDescriptor::Vector{} );
     ASSERT_TRUE( s.isComplete() );
 }
+
+TEST( Pipeline, TakeReady )
+{
+    using namespace mega::pipeline;
+
+    TaskDescriptor a = make_task( "a" );
+    TaskDescriptor b = make_task( "b" );
+    TaskDescriptor c = make_task( "c" );
+
+    Dependencies d;
+    d.add( a, { b, c } );
+
+    Schedule s( d );
+    ASSERT_EQ( s.takeReady(), ( TaskDescriptor::Vector{ b, c } ) );
+    ASSERT_EQ( s.takeReady(), TaskDescriptor::Vector{} );
+    ASSERT_EQ( s.getReady(), ( TaskDescriptor::Vector{ b, c } ) );
+    s.complete( b );
+    ASSERT_EQ( s.takeReady(), TaskDescriptor::Vector{} );
+    s.complete( c );
+    ASSERT_EQ( s.takeReady(), TaskDescriptor::Vector{ a } );
+    s.complete( a );
+    ASSERT_TRUE( s.isComplete() );
+}
+
+TEST( Pipeline, ExecuteScheduleParallel )
+{
+    using namespace mega::pipeline;
+
+    // a project level task over per source tasks each depending on a previous stage
+    static constexpr int   SOURCES = 64;
+    Dependencies           d;
+    TaskDescriptor         project = make_task( "project" );
+    TaskDescriptor::Vector rollouts;
+    for( int i = 0; i != SOURCES; ++i )
+    {
+        TaskDescriptor parse   = make_task( "parse_" + std::to_string( i ) );
+        TaskDescriptor rollout = make_task( "rollout_" + std::to_string( i ) );
+        d.add( parse, {} );
+        d.add( rollout, { parse } );
+        rollouts.push_back( rollout );
+    }
+    d.add( project, rollouts );
+
+    std::mutex                 mutex;
+    std::set< TaskDescriptor > completed;
+    int                        running = 0, maxRunning = 0;
+
+    auto executeTask = [ & ]( const TaskDescriptor& task )
+    {
+        {
+            std::lock_guard< std::mutex > lock( mutex );
+            maxRunning = std::max( maxRunning, ++running );
+            // every dependency must have completed before the task starts
+            const Dependencies::Graph& graph = d.getDependencies();
+            for( auto i = graph.lower_bound( task ), iEnd = graph.upper_bound( task ); i != iEnd; ++i )
+            {
+                EXPECT_TRUE( completed.count( i->second ) );
+            }
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        {
+            std::lock_guard< std::mutex > lock( mutex );
+            completed.insert( task );
+            --running;
+        }
+        return true;
+    };
+
+    Schedule   s( d );
+    const bool bResult = executeSchedule( s, 8U, executeTask );
+    ASSERT_TRUE( bResult );
+    ASSERT_TRUE( s.isComplete() );
+    ASSERT_EQ( completed.size(), d.getTasks().size() );
+    ASSERT_GT( maxRunning, 1 );
+}
+
+TEST( Pipeline, ExecuteScheduleFailure )
+{
+    using namespace mega::pipeline;
+
+    TaskDescriptor a = make_task( "a" );
+    TaskDescriptor b = make_task( "b" );
+
+    Dependencies d;
+    d.add( a, { b } );
+
+    Schedule           s( d );
+    std::atomic< int > executed = 0;
+    ASSERT_FALSE( executeSchedule( s, 4U,
+                                   [ & ]( const TaskDescriptor& )
+                                   {
+                                       ++executed;
+                                       return false;
+                                   } ) );
+    ASSERT_EQ( executed.load(), 1 );
+    ASSERT_FALSE( s.isComplete() );
+}
+
+TEST( Pipeline, CriticalPathRanking )
+{
+    using namespace mega::pipeline;
+    using namespace std::chrono_literals;
+
+    // a -> b -> d and a -> c -> d where c is the long branch
+    Dependencies d;
+    d.add( make_task( "a" ), {} );
+    d.add( make_task( "b" ), { make_task( "a" ) } );
+    d.add( make_task( "c" ), { make_task( "a" ) } );
+    d.add( make_task( "d" ), { make_task( "b" ), make_task( "c" ) } );
+
+    TaskDurations durations;
+    durations.record( make_task( "a" ), 1ms );
+    durations.record( make_task( "b" ), 2ms );
+    durations.record( make_task( "c" ), 10ms );
+    durations.record( make_task( "d" ), 3ms );
+
+    const CriticalPath path( d, durations );
+    ASSERT_EQ( path.getRemaining( make_task( "d" ) ), 3ms );
+    ASSERT_EQ( path.getRemaining( make_task( "b" ) ), 5ms );
+    ASSERT_EQ( path.getRemaining( make_task( "c" ) ), 13ms );
+    ASSERT_EQ( path.getRemaining( make_task( "a" ) ), 14ms );
+    ASSERT_EQ( path.getLength(), 14ms );
+    ASSERT_GT( path.getRemaining( make_task( "c" ) ), path.getRemaining( make_task( "b" ) ) );
+}
+
+TEST( Pipeline, CriticalPathEstimates )
+{
+    using namespace mega::pipeline;
+    using namespace std::chrono_literals;
+
+    TaskDurations durations;
+    ASSERT_EQ( durations.estimate( make_task( "x" ) ), TaskDurations::Duration{ 1 } );
+
+    durations.record( TaskDescriptor{ "compile", "a.mega", {} }, 10ms );
+    durations.record( TaskDescriptor{ "compile", "b.mega", {} }, 20ms );
+    durations.record( TaskDescriptor{ "link", "", {} }, 60ms );
+
+    // same task with a different buffer keeps its history
+    ASSERT_EQ( durations.estimate( TaskDescriptor{ "compile", "a.mega", "changed" } ), 10ms );
+    // unseen source falls back to the mean of the same task name
+    ASSERT_EQ( durations.estimate( TaskDescriptor{ "compile", "c.mega", {} } ), 15ms );
+    // unseen task falls back to the mean of all tasks
+    ASSERT_EQ( durations.estimate( make_task( "other" ) ), 30ms );
+}
+
+TEST( Pipeline, TaskDurationsSerialise )
+{
+    using namespace mega::pipeline;
+    using namespace std::chrono_literals;
+
+    TaskDurations durations;
+    durations.record( TaskDescriptor{ "compile", "a.mega", {} }, 10ms );
+    durations.record( make_task( "link" ), 42ms );
+
+    std::stringstream ss;
+    {
+        boost::archive::xml_oarchive oa( ss );
+        oa&                          boost::serialization::make_nvp( "durations", durations );
+    }
+    TaskDurations loaded;
+    {
+        boost::archive::xml_iarchive ia( ss );
+        ia&                          boost::serialization::make_nvp( "durations", loaded );
+    }
+    ASSERT_EQ( loaded.get( TaskDescriptor{ "compile", "a.mega", {} } ), TaskDurations::Duration{ 10ms } );
+    ASSERT_EQ( loaded.get( make_task( "link" ) ), TaskDurations::Duration{ 42ms } );
+    ASSERT_FALSE( loaded.get( make_task( "missing" ) ).has_value() );
+}
+
+TEST( Pipeline, PipelineResultRecordsToolChain )
+{
+    using namespace mega::pipeline;
+
+    // early cutoff only applies when the previous result was built with the same tool chain
+    std::stringstream ss;
+    {
+        const PipelineResult         result( true, "built", {}, "0123456789abcdef" );
+        boost::archive::xml_oarchive oa( ss );
+        oa&                          boost::serialization::make_nvp( "PipelineResult", result );
+    }
+    PipelineResult loaded;
+    {
+        boost::archive::xml_iarchive ia( ss );
+        ia&                          boost::serialization::make_nvp( "PipelineResult", loaded );
+    }
+    ASSERT_TRUE( loaded.getSuccess() );
+    ASSERT_EQ( loaded.getToolChainHash(), "0123456789abcdef" );
+}
+
+TEST( Pipeline, EarlyCutoffSkipsUnchanged )
+{
+    using namespace mega::pipeline;
+
+    // parse -> tree -> concrete -> decisions with every stage after parse a candidate
+    TaskDescriptor parse     = make_task( "parse" );
+    TaskDescriptor tree      = make_task( "tree" );
+    TaskDescriptor concrete  = make_task( "concrete" );
+    TaskDescriptor decisions = make_task( "decisions" );
+
+    Dependencies d;
+    d.add( parse, {} );
+    d.add( tree, { parse } );
+    d.add( concrete, { tree } );
+    d.add( decisions, { concrete } );
+
+    Schedule s( d );
+    s.setEarlyCutoff( { parse, tree, concrete, decisions } );
+
+    // tasks without dependencies always run
+    ASSERT_EQ( s.takeReady(), TaskDescriptor::Vector{ parse } );
+    s.complete( parse, false );
+    ASSERT_TRUE( s.isComplete() );
+    ASSERT_EQ( s.takeReady(), TaskDescriptor::Vector{} );
+    ASSERT_EQ( s.getSkipped(), ( Dependencies::TaskSet{ tree, concrete, decisions } ) );
+}
+
+TEST( Pipeline, EarlyCutoffTaintsDownstream )
+{
+    using namespace mega::pipeline;
+
+    // a changed parse taints everything downstream while an unchanged includes lets pch be skipped
+    TaskDescriptor parse    = make_task( "parse" );
+    TaskDescriptor tree     = make_task( "tree" );
+    TaskDescriptor concrete = make_task( "concrete" );
+    TaskDescriptor includes = make_task( "includes" );
+    TaskDescriptor pch      = make_task( "pch" );
+
+    Dependencies d;
+    d.add( parse, {} );
+    d.add( tree, { parse } );
+    d.add( concrete, { tree } );
+    d.add( includes, {} );
+    d.add( pch, { includes } );
+
+    Schedule s( d );
+    s.setEarlyCutoff( { tree, concrete, pch } );
+
+    ASSERT_EQ( s.takeReady(), ( TaskDescriptor::Vector{ includes, parse } ) );
+    s.complete( includes, false );
+    s.complete( parse, true );
+
+    // tree must run since parse changed and concrete must run even when tree does not change
+    ASSERT_EQ( s.takeReady(), TaskDescriptor::Vector{ tree } );
+    s.complete( tree, false );
+    ASSERT_EQ( s.takeReady(), TaskDescriptor::Vector{ concrete } );
+    s.complete( concrete, false );
+
+    ASSERT_TRUE( s.isComplete() );
+    ASSERT_EQ( s.getSkipped(), Dependencies::TaskSet{ pch } );
+}
+
+TEST( Pipeline, ExecuteScheduleEarlyCutoff )
+{
+    using namespace mega::pipeline;
+
+    static constexpr int   SOURCES = 16;
+    Dependencies           d;
+    TaskDescriptor         project = make_task( "project" );
+    TaskDescriptor::Vector rollouts;
+    Dependencies::TaskSet  candidates{ project };
+    for( int i = 0; i != SOURCES; ++i )
+    {
+        TaskDescriptor parse   = make_task( "parse_" + std::to_string( i ) );
+        TaskDescriptor rollout = make_task( "rollout_" + std::to_string( i ) );
+        d.add( parse, {} );
+        d.add( rollout, { parse } );
+        rollouts.push_back( rollout );
+        candidates.insert( rollout );
+    }
+    d.add( project, rollouts );
+
+    // only the first source changes its parse output
+    std::mutex                 mutex;
+    std::set< TaskDescriptor > executed;
+    auto                       executeTask = [ & ]( const TaskDescriptor& task )
+    {
+        std::lock_guard< std::mutex > lock( mutex );
+        executed.insert( task );
+        return true;
+    };
+    auto outputsChanged = [ & ]( const TaskDescriptor& task ) { return task == make_task( "parse_0" ); };
+
+    Schedule s( d );
+    s.setEarlyCutoff( candidates );
+    ASSERT_TRUE( executeSchedule( s, 4U, executeTask, outputsChanged ) );
+    ASSERT_TRUE( s.isComplete() );
+
+    // every parse, the changed rollout and the project run while the other rollouts are skipped
+    ASSERT_EQ( s.getSkipped().size(), static_cast< std::size_t >( SOURCES - 1 ) );
+    ASSERT_EQ( executed.size(), static_cast< std::size_t >( SOURCES + 2 ) );
+    ASSERT_TRUE( executed.count( make_task( "rollout_0" ) ) );
+    ASSERT_TRUE( executed.count( project ) );
+    for( const TaskDescriptor& task : s.getSkipped() )
+    {
+        ASSERT_FALSE( executed.count( task ) );
+    }
+}
@@ -19,9 +19,21 @@
 
 
 
+#include "service/protocol/model/messages.hxx"
+#include "service/protocol/model/status.hxx"
+
 #include <gtest/gtest.h>
 
+#include <boost/interprocess/streams/bufferstream.hpp>
+#include <boost/interprocess/streams/vectorstream.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <iostream>
 
 TEST( Protocol, Basic )
 {
@@ -39,3 +51,86 @@ TEST( Protocol, Basic )
 
 
 }
+
+TEST( Protocol, WireCodecs )
+{
+    using namespace mega::network;
+    using Buffer = std::vector< char >;
+
+    const LogicalThreadID logicalThreadID;
+    const std::string     strPayload( 100, 'x' );
+
+    for( auto codec : { WireCodec::eBoost, WireCodec::eFlat } )
+    {
+        Buffer buffer;
+        {
+            boost::interprocess::basic_vectorbuf< Buffer > os;
+            encodeWire( os, make_response_error_msg( logicalThreadID, strPayload ), codec );
+            os.swap_vector( buffer );
+        }
+        ASSERT_EQ( buffer.front(), static_cast< char >( codec ) );
+
+        Message msg;
+        {
+            boost::interprocess::bufferbuf is( buffer.data(), buffer.size() );
+            decode( is, msg );
+        }
+        ASSERT_TRUE( msg.getID() == MSG_Error_Response::ID );
+        ASSERT_EQ( msg.getLogicalThreadID(), logicalThreadID );
+        ASSERT_EQ( MSG_Error_Response::get( msg ).what, strPayload );
+
+        static constexpr int iterations = 100000;
+
+        const auto start = std::chrono::steady_clock::now();
+        for( int i = 0; i != iterations; ++i )
+        {
+            boost::interprocess::bufferbuf is( buffer.data(), buffer.size() );
+            decode( is, msg );
+        }
+        const auto elapsed
+            = std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - start );
+        std::cout << ( codec == WireCodec::eFlat ? "flat" : "boost" ) << " codec: " << buffer.size()
+                  << " bytes " << elapsed.count() / iterations << "ns per decode" << std::endl;
+    }
+}
+
+TEST( Protocol, DispatchTable )
+{
+    using namespace mega::network;
+
+    struct PingLogicalThread : public status::Impl
+    {
+        std::string Ping( const std::string& strMsg, boost::asio::yield_context& ) override { return "pong " + strMsg; }
+    };
+
+    static constexpr auto table = DispatchTable< PingLogicalThread >::make< status::Impl >();
+    ASSERT_TRUE( table.contains( status::MSG_Ping_Request::ID ) );
+    ASSERT_FALSE( table.contains( status::MSG_Ping_Response::ID ) );
+
+    PingLogicalThread       logicalThread;
+    boost::asio::io_context ioContext;
+    boost::asio::spawn( ioContext,
+                        [ & ]( boost::asio::yield_context yield_ctx )
+                        {
+                            const Message response = table.dispatch(
+                                logicalThread,
+                                status::MSG_Ping_Request::make( LogicalThreadID{}, status::MSG_Ping_Request{ "ping" } ),
+                                yield_ctx );
+                            ASSERT_EQ( status::MSG_Ping_Response::get( response ).ping, "pong ping" );
+
+                            // unhandled messages fall through with an empty message
+                            ASSERT_FALSE( table.dispatch(
+                                logicalThread,
+                                status::MSG_Ping_Response::make( LogicalThreadID{}, status::MSG_Ping_Response{ "" } ),
+                                yield_ctx ) );
+                        } );
+    ioContext.run();
+
+    const DispatchStatus dispatchStatus = getDispatchStatus();
+    auto iFind = std::find_if( dispatchStatus.m_messages.begin(), dispatchStatus.m_messages.end(),
+                               []( const DispatchStatus::MessageStatus& message )
+                               { return message.name == "status::MSG_Ping_Request"; } );
+    ASSERT_TRUE( iFind != dispatchStatus.m_messages.end() );
+    ASSERT_EQ( iFind->count, 1U );
+    ASSERT_EQ( iFind->histogram.size(), DispatchStatus::HistogramBuckets );
+}
@@ -0,0 +1,273 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "service/mpo_context.hpp"
+#include "service/lock_tracker.hpp"
+
+#include "service/protocol/common/transaction.hpp"
+
+#include <gtest/gtest.h>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace
+{
+using namespace mega;
+namespace bfs = boost::filesystem;
+
+class LeaseReader;
+
+struct MessageCounts
+{
+    U64 reads         = 0U;
+    U64 releases      = 0U;
+    U64 invalidations = 0U;
+
+    U64 total() const { return reads + releases + invalidations; }
+};
+
+// stands in for the daemons and the owning simulations. Owners keep their lease holders in the
+// same LeaseHolders as Simulation and the readers are real MPOContexts
+class LeaseNetwork
+{
+    struct Owner
+    {
+        service::LeaseHolders leaseHolders;
+        U32                   uiTimeStamp = 1U;
+    };
+
+public:
+    void addOwner( const runtime::MPO& owner ) { m_owners[ owner ]; }
+    void addReader( const runtime::MPO& mpo, LeaseReader* pReader ) { m_readers[ mpo ] = pReader; }
+
+    runtime::TimeStamp getTimeStamp( const runtime::MPO& owner ) const
+    {
+        return runtime::TimeStamp{ m_owners.at( owner ).uiTimeStamp };
+    }
+
+    // every request is a request and a response
+    network::Message send( const network::Message& msg )
+    {
+        switch( msg.getID() )
+        {
+            case network::sim::MSG_SimLockRead_Request::ID:
+            {
+                const auto& request = network::sim::MSG_SimLockRead_Request::get( msg );
+                Owner&      owner   = m_owners.at( request.targetMPO );
+                owner.leaseHolders.onRead( request.requestingMPO );
+                m_counts.reads += 2U;
+                return network::sim::MSG_SimLockRead_Response::make(
+                    msg.getLogicalThreadID(),
+                    network::sim::MSG_SimLockRead_Response{ runtime::TimeStamp{ owner.uiTimeStamp } } );
+            }
+            case network::sim::MSG_SimLockReleaseBatch_Request::ID:
+            {
+                m_counts.releases += 2U;
+                return network::sim::MSG_SimLockReleaseBatch_Response::make(
+                    msg.getLogicalThreadID(), network::sim::MSG_SimLockReleaseBatch_Response{} );
+            }
+            default:
+            {
+                THROW_RTE( "Unexpected request: " << msg );
+            }
+        }
+    }
+
+    // the owner changes as in Simulation::invalidateLeases and the daemon delivers to each holder
+    void change( const runtime::MPO& ownerMPO );
+
+    const MessageCounts& getCounts() const { return m_counts; }
+
+private:
+    std::map< runtime::MPO, Owner >        m_owners;
+    std::map< runtime::MPO, LeaseReader* > m_readers;
+    MessageCounts                          m_counts;
+};
+
+class LeaseReader : public runtime::MPOContext
+{
+public:
+    LeaseReader( LeaseNetwork& leaseNetwork, const runtime::MPO& mpo, const bfs::path& logFolder )
+        : MPOContext( m_logicalThreadID )
+        , m_network( leaseNetwork )
+    {
+        m_mpo                  = mpo;
+        m_pLog                 = std::make_unique< event::FileStorage >( logFolder, false );
+        m_pTransactionProducer = std::make_unique< network::TransactionProducer >( *m_pLog );
+        m_network.addReader( mpo, this );
+    }
+
+    // the lock requests go to the network and nothing else is used
+    virtual network::sim::Request_Encoder getDaemonSimRequest() override { return getSimRequest(); }
+    virtual network::sim::Request_Encoder getMPOSimRequest( runtime::MPO ) override { return getSimRequest(); }
+
+    virtual network::mpo::Request_Sender     getMPRequest() override { THROW_RTE( "Unused" ); }
+    virtual network::enrole::Request_Encoder getRootEnroleRequest() override { THROW_RTE( "Unused" ); }
+    virtual network::stash::Request_Encoder  getRootStashRequest() override { THROW_RTE( "Unused" ); }
+    virtual network::memory::Request_Encoder getDaemonMemoryRequest() override { THROW_RTE( "Unused" ); }
+    virtual network::memory::Request_Sender  getLeafMemoryRequest() override { THROW_RTE( "Unused" ); }
+    virtual network::jit::Request_Sender     getLeafJITRequest() override { THROW_RTE( "Unused" ); }
+
+private:
+    network::sim::Request_Encoder getSimRequest()
+    {
+        return { [ &leaseNetwork = m_network ]( const network::Message& msg ) { return leaseNetwork.send( msg ); },
+                 m_logicalThreadID };
+    }
+
+    network::LogicalThreadID m_logicalThreadID;
+    LeaseNetwork&            m_network;
+};
+
+void LeaseNetwork::change( const runtime::MPO& ownerMPO )
+{
+    Owner& owner = m_owners.at( ownerMPO );
+    ++owner.uiTimeStamp;
+    if( !owner.leaseHolders.empty() )
+    {
+        const service::LeaseHolders::MPOVector leaseHolders = owner.leaseHolders.invalidate();
+        // owner to its daemon then the daemon to each lease holder
+        m_counts.invalidations += 2U * ( 1U + leaseHolders.size() );
+        for( const runtime::MPO& leaseHolder : leaseHolders )
+        {
+            m_readers.at( leaseHolder )->leaseInvalidated( ownerMPO );
+        }
+    }
+}
+
+class ReadLeaseTest : public ::testing::Test
+{
+protected:
+    bfs::path m_folder;
+
+    virtual void SetUp() override { m_folder = bfs::temp_directory_path() / "read_lease_test"; }
+    virtual void TearDown() override { bfs::remove_all( m_folder ); }
+
+    // every reader reads every owner each cycle and each owner changes once every writePeriod cycles.
+    // A reader must always see the owner's current time stamp whether it came from a lease or a read.
+    MessageCounts run( U64 szOwners, U64 szReaders, U32 szCycles, U32 writePeriod )
+    {
+        bfs::remove_all( m_folder );
+
+        LeaseNetwork                leaseNetwork;
+        std::vector< runtime::MPO > owners;
+        for( U64 o = 0U; o != szOwners; ++o )
+        {
+            owners.push_back( runtime::MPO{ runtime::MachineID{ 1U }, runtime::ProcessID{ 1U },
+                                            runtime::OwnerID{ static_cast< U8 >( o ) } } );
+            leaseNetwork.addOwner( owners.back() );
+        }
+        std::vector< std::unique_ptr< LeaseReader > > readers;
+        for( U64 r = 0U; r != szReaders; ++r )
+        {
+            const runtime::MPO mpo{
+                runtime::MachineID{ 2U }, runtime::ProcessID{ static_cast< U16 >( r ) }, runtime::OwnerID{ 0U } };
+            readers.push_back(
+                std::make_unique< LeaseReader >( leaseNetwork, mpo, m_folder / ( "reader_" + std::to_string( r ) ) ) );
+        }
+
+        for( U32 cycle = 1U; cycle <= szCycles; ++cycle )
+        {
+            for( auto& pReader : readers )
+            {
+                for( const runtime::MPO& owner : owners )
+                {
+                    EXPECT_EQ( pReader->acquireRead( owner ), leaseNetwork.getTimeStamp( owner ) );
+                }
+                pReader->cycleComplete();
+            }
+            for( U64 o = 0U; o != szOwners; ++o )
+            {
+                if( ( cycle + o ) % writePeriod == 0U )
+                {
+                    leaseNetwork.change( owners[ o ] );
+                }
+            }
+        }
+        return leaseNetwork.getCounts();
+    }
+};
+} // namespace
+
+TEST( ReadLease, LeaseOutlivesCycle )
+{
+    const runtime::MPO owner{ 1U };
+
+    service::LockTracker tracker;
+    tracker.onRead( owner, runtime::TimeStamp{ 3U } );
+    tracker.onLease( owner, runtime::TimeStamp{ 3U } );
+    tracker.reset();
+    ASSERT_EQ( tracker.isRead( owner ), 0U );
+    ASSERT_EQ( tracker.isLeased( owner ), 3U );
+
+    tracker.onInvalidate( owner );
+    ASSERT_EQ( tracker.isLeased( owner ), 0U );
+
+    tracker.onLease( owner, runtime::TimeStamp{ 4U } );
+    tracker.onWrite( owner, runtime::TimeStamp{ 5U } );
+    ASSERT_EQ( tracker.isLeased( owner ), 0U );
+    ASSERT_EQ( tracker.isWrite( owner ), 5U );
+}
+
+TEST( ReadLease, WriterDropsOwnLease )
+{
+    const runtime::MPO reader{ 1U }, writer{ 2U };
+
+    service::LeaseHolders leaseHolders;
+    leaseHolders.onRead( reader );
+    leaseHolders.onRead( writer );
+    leaseHolders.onWrite( writer );
+
+    const service::LeaseHolders::MPOVector invalidated = leaseHolders.invalidate();
+    ASSERT_EQ( invalidated, service::LeaseHolders::MPOVector{ reader } );
+    ASSERT_TRUE( leaseHolders.empty() );
+}
+
+TEST_F( ReadLeaseTest, MessagesPerCycle )
+{
+    static constexpr U64 szOwners  = 4U;
+    static constexpr U64 szReaders = 16U;
+    static constexpr U32 szCycles  = 256U;
+
+    // without leases every reader reads every owner and sends one release batch each cycle
+    static constexpr U64 uiLockMessages = 2U * szReaders * ( szOwners + 1U );
+
+    for( U32 writePeriod : { 1U, 4U, 16U, 256U } )
+    {
+        const MessageCounts leases = run( szOwners, szReaders, szCycles, writePeriod );
+
+        std::cout << "Owner writes every: " << writePeriod << " cycles messages per cycle locks: " << uiLockMessages
+                  << " leases: " << static_cast< double >( leases.total() ) / szCycles
+                  << " ( reads: " << static_cast< double >( leases.reads ) / szCycles
+                  << " releases: " << static_cast< double >( leases.releases ) / szCycles
+                  << " invalidations: " << static_cast< double >( leases.invalidations ) / szCycles << " )"
+                  << std::endl;
+
+        if( writePeriod > 2U )
+        {
+            ASSERT_LT( leases.total(), uiLockMessages * szCycles );
+        }
+    }
+}
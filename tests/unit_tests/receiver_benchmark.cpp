@@ -0,0 +1,207 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "service/protocol/model/messages.hxx"
+
+#include "service/network/network.hpp"
+#include "service/network/receive_buffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+
+#include <boost/interprocess/streams/bufferstream.hpp>
+#include <boost/interprocess/streams/vectorstream.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using namespace mega;
+using namespace mega::network;
+
+using Buffer = std::vector< char >;
+
+// size prefixed stream of encoded messages as SocketSender writes them
+Buffer makeStream( U64 szMessages, const std::string& strPayload )
+{
+    Buffer stream;
+    for( U64 i = 0; i != szMessages; ++i )
+    {
+        boost::interprocess::basic_vectorbuf< Buffer > os;
+        encode( os, make_response_error_msg( LogicalThreadID{}, strPayload ) );
+        const MessageSize size = os.vector().size();
+        const char*       p    = reinterpret_cast< const char* >( &size );
+        stream.insert( stream.end(), p, p + sizeof( MessageSize ) );
+        stream.insert( stream.end(), os.vector().begin(), os.vector().end() );
+    }
+    return stream;
+}
+
+// the receive loop before MessageFramer - size read, body read, copy into a vectorbuf
+U64 receiveLegacy( Traits::Socket& socket, U64 szMessages )
+{
+    Buffer                                    buffer( 1024 );
+    std::array< char, sizeof( MessageSize ) > sizeBuffer;
+    U64                                       szReceived = 0U;
+    while( szReceived != szMessages )
+    {
+        boost::asio::read( socket, boost::asio::buffer( sizeBuffer ) );
+        const MessageSize size = *reinterpret_cast< const MessageSize* >( sizeBuffer.data() );
+        buffer.resize( size );
+        boost::asio::read( socket, boost::asio::buffer( buffer ) );
+
+        Message msg;
+        {
+            boost::interprocess::basic_vectorbuf< Buffer > is( buffer );
+            decode( is, msg );
+        }
+        ++szReceived;
+    }
+    return szReceived;
+}
+
+U64 receiveFramed( Traits::Socket& socket, U64 szMessages )
+{
+    MessageFramer framer;
+    U64           szReceived = 0U;
+    while( szReceived != szMessages )
+    {
+        framer.commit( socket.read_some( framer.prepare() ) );
+        framer.frame(
+            [ &szReceived ]( std::span< const char > message )
+            {
+                Message msg;
+                {
+                    boost::interprocess::bufferbuf is( const_cast< char* >( message.data() ), message.size() );
+                    decode( is, msg );
+                }
+                ++szReceived;
+            } );
+    }
+    return szReceived;
+}
+
+struct BenchmarkParams
+{
+    U64 szMessages;
+    U64 szPayload;
+};
+
+class ReceiverBenchmark : public ::testing::TestWithParam< BenchmarkParams >
+{
+};
+
+template < typename TReceiveFunctor >
+std::chrono::nanoseconds loopback( const Buffer& stream, U64 szMessages, TReceiveFunctor&& receive )
+{
+    boost::asio::io_context ioContext;
+    Traits::Acceptor        acceptor( ioContext, Traits::EndPoint( boost::asio::ip::address_v4::loopback(), 0 ) );
+    Traits::Socket          sendSocket( ioContext );
+    sendSocket.connect( acceptor.local_endpoint() );
+    Traits::Socket receiveSocket = acceptor.accept();
+
+    std::thread sender( [ &sendSocket, &stream ]() { boost::asio::write( sendSocket, boost::asio::buffer( stream ) ); } );
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ( receive( receiveSocket, szMessages ), szMessages );
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    sender.join();
+    return std::chrono::duration_cast< std::chrono::nanoseconds >( elapsed );
+}
+
+void report( const char* pszName, const Buffer& stream, U64 szMessages, std::chrono::nanoseconds elapsed )
+{
+    const double seconds = std::chrono::duration< double >( elapsed ).count();
+    std::cout << pszName << " messages/s: " << static_cast< U64 >( szMessages / seconds )
+              << " GB/s: " << ( stream.size() / seconds ) / 1'000'000'000.0 << std::endl;
+}
+} // namespace
+
+TEST( MessageFramerTests, SplitAndLargeMessages )
+{
+    const std::string strLarge( ReceiveBufferPool::DEFAULT_CAPACITY * 3, 'x' );
+    const Buffer      stream = makeStream( 3, "small" );
+    Buffer            combined = stream;
+    {
+        const Buffer large = makeStream( 1, strLarge );
+        combined.insert( combined.end(), large.begin(), large.end() );
+        combined.insert( combined.end(), stream.begin(), stream.end() );
+    }
+
+    // feed one byte at a time then the remainder to exercise partial frames and buffer growth
+    MessageFramer              framer;
+    std::vector< std::string > received;
+    U64                        szOffset = 0U;
+    while( szOffset != combined.size() )
+    {
+        auto      buffer  = framer.prepare();
+        const U64 szBytes = std::min< U64 >( szOffset < 64 ? 1U : buffer.size(), combined.size() - szOffset );
+        ASSERT_GE( buffer.size(), szBytes );
+        std::memcpy( buffer.data(), combined.data() + szOffset, szBytes );
+        framer.commit( szBytes );
+        szOffset += szBytes;
+        framer.frame(
+            [ &received ]( std::span< const char > message )
+            {
+                Message msg;
+                {
+                    boost::interprocess::bufferbuf is( const_cast< char* >( message.data() ), message.size() );
+                    decode( is, msg );
+                }
+                received.push_back( MSG_Error_Response::get( msg ).what );
+            } );
+    }
+
+    ASSERT_EQ( received.size(), 7U );
+    ASSERT_EQ( received[ 0 ], "small" );
+    ASSERT_EQ( received[ 3 ], strLarge );
+    ASSERT_EQ( received[ 6 ], "small" );
+}
+
+TEST_P( ReceiverBenchmark, Loopback )
+{
+    const BenchmarkParams params = GetParam();
+    const Buffer          stream = makeStream( params.szMessages, std::string( params.szPayload, 'x' ) );
+
+    std::cout << "Messages: " << params.szMessages << " payload: " << params.szPayload << std::endl;
+    report( "  SocketReceiver (legacy): ", stream, params.szMessages,
+            loopback( stream, params.szMessages, &receiveLegacy ) );
+    report( "  MessageFramer:           ", stream, params.szMessages,
+            loopback( stream, params.szMessages, &receiveFramed ) );
+}
+
+// mega_tests runs after every build so each case streams at most a few tens of megabytes
+// clang-format off
+INSTANTIATE_TEST_SUITE_P( Receiver, ReceiverBenchmark,
+        ::testing::Values
+        (
+            BenchmarkParams{ 10'000, 16 },
+            BenchmarkParams{ 1'000, 1024 },
+            BenchmarkParams{ 16, 1 << 20 }
+        ) );
+// clang-format on
@@ -0,0 +1,126 @@
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "service/daemon/release_batches.hpp"
+
+#include <gtest/gtest.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace mega;
+using namespace mega::service;
+
+namespace
+{
+const runtime::MPO requester{ runtime::MachineID{ 1U }, runtime::ProcessID{ 1U }, runtime::OwnerID{ 0U } };
+const runtime::MPO otherRequester{ runtime::MachineID{ 1U }, runtime::ProcessID{ 2U }, runtime::OwnerID{ 0U } };
+const runtime::MPO target{ runtime::MachineID{ 2U }, runtime::ProcessID{ 1U }, runtime::OwnerID{ 0U } };
+
+network::Message makeRead( const runtime::MPO& requestingMPO )
+{
+    return network::sim::MSG_SimLockRead_Request::make(
+        network::LogicalThreadID{}, network::sim::MSG_SimLockRead_Request{ requestingMPO, target } );
+}
+
+// a lock request routed through MPOUp as the daemon does for executors
+void spawnLockRequest( boost::asio::io_context& ioContext, ReleaseBatches& releaseBatches, network::Message request,
+                       std::vector< std::string >& order, std::string strName )
+{
+    boost::asio::spawn( ioContext,
+                        [ &, request = std::move( request ), strName ]( boost::asio::yield_context yield_ctx )
+                        {
+                            std::optional< runtime::MPO > requestingMPO
+                                = ReleaseBatches::getLockRequester( request );
+                            ASSERT_TRUE( requestingMPO.has_value() );
+                            releaseBatches.wait( requestingMPO.value(), yield_ctx );
+                            order.push_back( strName );
+                        } );
+}
+
+// an unacknowledged release batch that completes after a delay
+void spawnReleaseBatch( boost::asio::io_context& ioContext, ReleaseBatches& releaseBatches,
+                        std::vector< std::string >& order, std::string strName, std::chrono::milliseconds delay )
+{
+    releaseBatches.started( requester );
+    boost::asio::spawn( ioContext,
+                        [ &, strName, delay ]( boost::asio::yield_context yield_ctx )
+                        {
+                            boost::asio::steady_timer timer( ioContext, delay );
+                            timer.async_wait( yield_ctx );
+                            order.push_back( strName );
+                            releaseBatches.completed( requester );
+                        } );
+}
+} // namespace
+
+TEST( ReleaseBatches, QueuedReleaseIsNotOvertakenByNextRead )
+{
+    boost::asio::io_context    ioContext;
+    ReleaseBatches             releaseBatches( ioContext );
+    std::vector< std::string > order;
+
+    spawnReleaseBatch( ioContext, releaseBatches, order, "release", std::chrono::milliseconds( 20 ) );
+    spawnLockRequest( ioContext, releaseBatches, makeRead( requester ), order, "read" );
+    spawnLockRequest( ioContext, releaseBatches, makeRead( otherRequester ), order, "other read" );
+    ioContext.run();
+
+    // only the requester with a batch in flight is held back
+    const std::vector< std::string > expected{ "other read", "release", "read" };
+    ASSERT_EQ( order, expected );
+}
+
+TEST( ReleaseBatches, ReadWaitsForBatchStartedWhileWaiting )
+{
+    boost::asio::io_context    ioContext;
+    ReleaseBatches             releaseBatches( ioContext );
+    std::vector< std::string > order;
+
+    spawnReleaseBatch( ioContext, releaseBatches, order, "first release", std::chrono::milliseconds( 10 ) );
+    spawnLockRequest( ioContext, releaseBatches, makeRead( requester ), order, "read" );
+    boost::asio::spawn( ioContext,
+                        [ & ]( boost::asio::yield_context yield_ctx )
+                        {
+                            boost::asio::steady_timer timer( ioContext, std::chrono::milliseconds( 5 ) );
+                            timer.async_wait( yield_ctx );
+                            spawnReleaseBatch(
+                                ioContext, releaseBatches, order, "second release", std::chrono::milliseconds( 20 ) );
+                        } );
+    ioContext.run();
+
+    const std::vector< std::string > expected{ "first release", "second release", "read" };
+    ASSERT_EQ( order, expected );
+}
+
+TEST( ReleaseBatches, OnlyLockRequestsAreHeld )
+{
+    const network::Message release = network::sim::MSG_SimLockRelease_Request::make(
+        network::LogicalThreadID{},
+        network::sim::MSG_SimLockRelease_Request{ requester, target, network::Transaction{} } );
+    ASSERT_EQ( ReleaseBatches::getLockRequester( release ), requester );
+
+    const network::Message batch = network::sim::MSG_SimLockReleaseBatch_Request::make(
+        network::LogicalThreadID{}, network::sim::MSG_SimLockReleaseBatch_Request{ requester, {}, {}, false } );
+    ASSERT_FALSE( ReleaseBatches::getLockRequester( batch ).has_value() );
+}
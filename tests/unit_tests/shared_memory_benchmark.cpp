@@ -0,0 +1,258 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+
+#include "service/network/client.hpp"
+#include "service/network/server.hpp"
+#include "service/network/shared_memory.hpp"
+
+#include "service/protocol/model/messages.hxx"
+
+#include "common/string.hpp"
+
+#include <gtest/gtest.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using namespace mega;
+using namespace mega::network;
+
+static constexpr int  ROUND_TRIPS       = 10000;
+static constexpr int  BURST             = 1000;
+static constexpr auto BENCHMARK_TIMEOUT = std::chrono::seconds( 60 );
+
+template < typename TFunctor >
+void spawnCoroutine( boost::asio::io_context& ioContext, TFunctor&& functor )
+{
+    boost::asio::spawn( ioContext, std::forward< TFunctor >( functor )
+    // segmented stacks do NOT work on windows
+#ifndef BOOST_USE_SEGMENTED_STACKS
+                                       ,
+                        boost::coroutines::attributes( NON_SEGMENTED_STACK_SIZE )
+#endif
+    );
+}
+
+// server side - echoes every message back through the connection sender in the order received
+class EchoManager : public LogicalThreadManager
+{
+public:
+    EchoManager( boost::asio::io_context& ioContext )
+        : LogicalThreadManager( "echo", ioContext )
+    {
+    }
+
+    virtual LogicalThreadBase::Ptr joinLogicalThread( const Message& ) { return {}; }
+
+    virtual void dispatch( const ReceivedMessage& msg )
+    {
+        spawnCoroutine( m_ioContext,
+                        [ pSender = msg.pResponseSender, response = msg.msg ]( boost::asio::yield_context yield_ctx )
+                        { pSender->send( response, yield_ctx ); } );
+    }
+};
+
+// client side - records the echoed payloads and wakes the driving coroutine
+class RecordingManager : public LogicalThreadManager
+{
+public:
+    RecordingManager( boost::asio::io_context& ioContext )
+        : LogicalThreadManager( "recording", ioContext )
+        , m_timer( ioContext )
+    {
+    }
+
+    virtual LogicalThreadBase::Ptr joinLogicalThread( const Message& ) { return {}; }
+
+    virtual void dispatch( const ReceivedMessage& msg )
+    {
+        m_received.push_back( MSG_Error_Response::get( msg.msg ).what );
+        m_timer.cancel();
+    }
+
+    void waitFor( std::size_t szCount, boost::asio::yield_context& yield_ctx )
+    {
+        while( m_received.size() < szCount )
+        {
+            boost::system::error_code ec;
+            m_timer.expires_at( boost::asio::steady_timer::time_point::max() );
+            m_timer.async_wait( yield_ctx[ ec ] );
+        }
+    }
+
+    std::vector< std::string > m_received;
+
+private:
+    boost::asio::steady_timer m_timer;
+};
+
+// Server takes a short port so search a fixed range rather than use an ephemeral port
+std::unique_ptr< Server > makeServer( boost::asio::io_context& ioContext, LogicalThreadManager& logicalThreadManager )
+{
+    for( short port = 24000; port != 24100; ++port )
+    {
+        try
+        {
+            return std::make_unique< Server >( ioContext, logicalThreadManager, port );
+        }
+        catch( std::exception& )
+        {
+        }
+    }
+    return {};
+}
+
+void report( const char* pszTransport, std::chrono::steady_clock::duration elapsed )
+{
+    const auto ns = std::chrono::duration_cast< std::chrono::nanoseconds >( elapsed ).count();
+    std::cout << pszTransport << " round trip: " << ns / ROUND_TRIPS << "ns" << std::endl;
+}
+
+} // namespace
+
+// Request / response round trips between a Client and a Server in one process first over the
+// socket and then after switching the connection to shared memory.  A burst of pipelined sends
+// straddles the switch and must be echoed back in order.  Everything runs on one io_context
+// thread as in the daemon and leaf so failures are recorded and asserted after it stops.
+TEST( SharedMemoryBenchmark, RoundTrip )
+{
+    boost::asio::io_context ioContext;
+    EchoManager             echoManager( ioContext );
+    RecordingManager        recordingManager( ioContext );
+
+    auto pServer = makeServer( ioContext, echoManager );
+    ASSERT_TRUE( pServer );
+    pServer->waitForConnection();
+    Client client( ioContext, recordingManager, "127.0.0.1", static_cast< short >( pServer->getEndPoint().port() ) );
+
+    bool                         bSwitched = false;
+    std::vector< std::string >   burst;
+    std::optional< std::string > errorOpt;
+
+    spawnCoroutine(
+        ioContext,
+        [ & ]( boost::asio::yield_context yield_ctx )
+        {
+            try
+            {
+                auto roundTrips = [ & ]( const char* pszTransport )
+                {
+                    const Message request = make_response_error_msg( LogicalThreadID{}, "request" );
+                    const auto    start   = std::chrono::steady_clock::now();
+                    for( int i = 0; i != ROUND_TRIPS; ++i )
+                    {
+                        client.getSender()->send( request, yield_ctx );
+                        recordingManager.waitFor( recordingManager.m_received.size() + 1U, yield_ctx );
+                    }
+                    report( pszTransport, std::chrono::steady_clock::now() - start );
+                };
+
+                auto sendBurst = [ & ]( int iBegin, int iEnd )
+                {
+                    for( int i = iBegin; i != iEnd; ++i )
+                    {
+                        burst.push_back( std::to_string( i ) );
+                        const Message msg = make_response_error_msg( LogicalThreadID{}, burst.back() );
+                        spawnCoroutine( ioContext,
+                                        [ &client, msg ]( boost::asio::yield_context yield )
+                                        { client.getSender()->send( msg, yield ); } );
+                    }
+                    // let the burst queue on the socket before continuing
+                    boost::asio::post( ioContext, yield_ctx );
+                };
+
+                roundTrips( "TCP loopback" );
+                recordingManager.m_received.clear();
+
+                // switch while socket sends are still queued in both directions
+                sendBurst( 0, BURST / 2 );
+                {
+                    VERIFY_RTE_MSG( pServer->getConnections().size() == 1U, "Expected one connection" );
+                    const std::string strSegmentName = "mega_benchmark_" + common::uuid();
+                    ( *pServer->getConnections().begin() )->createSharedMemory( strSegmentName );
+                    client.connectSharedMemory( recordingManager, strSegmentName );
+                }
+                sendBurst( BURST / 2, BURST );
+                recordingManager.waitFor( BURST, yield_ctx );
+                bSwitched = std::static_pointer_cast< SwitchableSender >( client.getSender() )->isSwitched();
+
+                std::vector< std::string > received;
+                received.swap( recordingManager.m_received );
+                VERIFY_RTE_MSG( received == burst, "Burst straddling the switch was reordered" );
+
+                roundTrips( "Shared memory" );
+            }
+            catch( std::exception& ex )
+            {
+                errorOpt = ex.what();
+            }
+            client.stop();
+            pServer->stop();
+            ioContext.stop();
+        } );
+
+    ioContext.run_for( BENCHMARK_TIMEOUT );
+
+    ASSERT_FALSE( errorOpt.has_value() ) << errorOpt.value_or( "" );
+    ASSERT_TRUE( bSwitched );
+}
+
+// messages larger than the ring stream through it in chunks
+TEST( SharedMemoryBenchmark, LargeMessage )
+{
+    const std::string   strName = "mega_shared_memory_large_" + common::uuid();
+    SharedMemoryChannel serverChannel( SharedMemoryChannel::Create{}, strName, 1 << 12 );
+    SharedMemoryChannel clientChannel( SharedMemoryChannel::Open{}, strName );
+    std::atomic< bool > bStop = false;
+
+    std::vector< char > sent( 1 << 20 );
+    for( std::size_t i = 0; i != sent.size(); ++i )
+    {
+        sent[ i ] = static_cast< char >( i * 7 );
+    }
+
+    bool        bWritten = false;
+    std::thread writer( [ & ] { bWritten = clientChannel.outbound().write( sent.data(), sent.size() ); } );
+
+    std::vector< char > received( sent.size() );
+    const bool          bRead = serverChannel.inbound().read( received.data(), received.size(), bStop );
+    if( !bRead )
+    {
+        // release the writer so the join cannot hang
+        serverChannel.close();
+    }
+    writer.join();
+
+    ASSERT_TRUE( bRead );
+    ASSERT_TRUE( bWritten );
+    ASSERT_EQ( sent, received );
+}
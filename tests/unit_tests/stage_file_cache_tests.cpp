@@ -0,0 +1,121 @@
+
+//  Copyright (c) Deighton Systems Limited. 2022. All Rights Reserved.
+//  Author: Edward Deighton
+//  License: Please see license.txt in the project root folder.
+
+//  Use and copying of this software and preparation of derivative works
+//  based upon this software are permitted. Any copy of this software or
+//  of any derivative work must include the above copyright notice, this
+//  paragraph and the one after it.  Any distribution of this software or
+//  derivative works must comply with all applicable laws.
+
+//  This software is made available AS IS, and COPYRIGHT OWNERS DISCLAIMS
+//  ALL WARRANTIES, EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE, AND NOTWITHSTANDING ANY OTHER PROVISION CONTAINED HEREIN, ANY
+//  LIABILITY FOR DAMAGES RESULTING FROM THE SOFTWARE OR ITS USE IS
+//  EXPRESSLY DISCLAIMED, WHETHER ARISING IN CONTRACT, TORT (INCLUDING
+//  NEGLIGENCE) OR STRICT LIABILITY, EVEN IF COPYRIGHT OWNERS ARE ADVISED
+//  OF THE POSSIBILITY OF SUCH DAMAGES.
+
+#include "environment/stage_file_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+namespace
+{
+using mega::io::StageFileCache;
+
+StageFileCache::Buffer makeBuffer( std::size_t szSize, char c )
+{
+    return std::make_shared< std::string >( szSize, c );
+}
+} // namespace
+
+TEST( StageFileCache, HitsOnlyMatchingVersion )
+{
+    StageFileCache cache( 1024U );
+
+    ASSERT_FALSE( cache.find( "a.db", "1" ) );
+    cache.insert( "a.db", "1", makeBuffer( 16U, 'a' ) );
+
+    auto pBuffer = cache.find( "a.db", "1" );
+    ASSERT_TRUE( pBuffer );
+    ASSERT_EQ( *pBuffer, std::string( 16U, 'a' ) );
+    ASSERT_FALSE( cache.find( "a.db", "2" ) );
+    ASSERT_FALSE( cache.find( "b.db", "1" ) );
+
+    const auto stats = cache.getStatistics();
+    ASSERT_EQ( stats.uiHits, 1U );
+    ASSERT_EQ( stats.uiMisses, 3U );
+    ASSERT_EQ( stats.uiBytes, 16U );
+}
+
+TEST( StageFileCache, InsertKeepsExistingEntry )
+{
+    StageFileCache cache( 1024U );
+
+    auto pFirst  = cache.insert( "a.db", "1", makeBuffer( 16U, 'a' ) );
+    auto pSecond = cache.insert( "a.db", "1", makeBuffer( 16U, 'a' ) );
+    ASSERT_EQ( pFirst, pSecond );
+    ASSERT_EQ( cache.getStatistics().uiEntries, 1U );
+    ASSERT_EQ( cache.getStatistics().uiBytes, 16U );
+}
+
+TEST( StageFileCache, EvictsLeastRecentlyUsed )
+{
+    StageFileCache cache( 100U );
+
+    cache.insert( "a.db", "1", makeBuffer( 40U, 'a' ) );
+    cache.insert( "b.db", "1", makeBuffer( 40U, 'b' ) );
+    // touch a so that b becomes the least recently used
+    ASSERT_TRUE( cache.find( "a.db", "1" ) );
+    cache.insert( "c.db", "1", makeBuffer( 40U, 'c' ) );
+
+    ASSERT_TRUE( cache.find( "a.db", "1" ) );
+    ASSERT_FALSE( cache.find( "b.db", "1" ) );
+    ASSERT_TRUE( cache.find( "c.db", "1" ) );
+
+    const auto stats = cache.getStatistics();
+    ASSERT_EQ( stats.uiEvictions, 1U );
+    ASSERT_EQ( stats.uiBytes, 80U );
+    ASSERT_LE( stats.uiBytes, cache.getCapacity() );
+}
+
+TEST( StageFileCache, SkipsFilesLargerThanCapacity )
+{
+    StageFileCache cache( 100U );
+
+    cache.insert( "a.db", "1", makeBuffer( 40U, 'a' ) );
+    auto pLarge = cache.insert( "large.db", "1", makeBuffer( 200U, 'l' ) );
+    ASSERT_EQ( pLarge->size(), 200U );
+    ASSERT_FALSE( cache.find( "large.db", "1" ) );
+    ASSERT_TRUE( cache.find( "a.db", "1" ) );
+}
+
+TEST( StageFileCache, StreamsShareContents )
+{
+    auto pBuffer = std::make_shared< std::string >( "0123456789" );
+
+    auto pFirst  = StageFileCache::makeStream( pBuffer );
+    auto pSecond = StageFileCache::makeStream( pBuffer );
+
+    char szFirst[ 4 ]{};
+    pFirst->read( szFirst, 3 );
+    ASSERT_EQ( std::string( szFirst ), "012" );
+
+    pSecond->seekg( 5 );
+    char szSecond[ 4 ]{};
+    pSecond->read( szSecond, 3 );
+    ASSERT_EQ( std::string( szSecond ), "567" );
+
+    pFirst->seekg( -2, std::ios_base::end );
+    ASSERT_EQ( pFirst->tellg(), 8 );
+    ASSERT_EQ( pFirst->get(), '8' );
+    ASSERT_EQ( pFirst->get(), '9' );
+    pFirst->get();
+    ASSERT_TRUE( pFirst->eof() );
+}